@@ -0,0 +1,98 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+
+#include "matrix.h"
+#include "matrix_gemm.h"
+#include "matrix_thread_pool.h"
+
+/*** Macro ***/
+static constexpr double MIN_MEASURE_TIME_SEC = 0.2;
+
+/*** Function ***/
+static std::vector<float> CreateRandom(int32_t size, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(size);
+    for (auto& v : data) v = dist(engine);
+    return data;
+}
+
+/* The simple triple loop which Matrix::operator* used before the blocked kernel */
+static Matrix MultiplyReference(const Matrix& left, const Matrix& right)
+{
+    Matrix ret(left.Rows(), right.Cols());
+    for (int32_t y = 0; y < left.Rows(); y++) {
+        for (int32_t x = 0; x < right.Cols(); x++) {
+            float sum = 0.0f;
+            for (int32_t i = 0; i < left.Cols(); i++) {
+                sum += left(y, i) * right(i, x);
+            }
+            ret(y, x) = sum;
+        }
+    }
+    return ret;
+}
+
+/* Run func repeatedly for at least MIN_MEASURE_TIME_SEC and return GFLOP/s */
+static double MeasureGflops(int32_t size, const std::function<void()>& func)
+{
+    const double flop = 2.0 * size * size * size;
+    int32_t iteration = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        func();
+        iteration++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    } while (elapsed < MIN_MEASURE_TIME_SEC);
+    return flop * iteration / elapsed * 1e-9;
+}
+
+int main(int argc, char* argv[])
+{
+    /* usage: BenchmarkMatrix [max size] */
+    const int32_t max_size = (argc > 1) ? std::atoi(argv[1]) : 2048;
+
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    const int32_t thread_num = pool.GetThreadNum();
+    printf("kernel: %s, threads: %d\n", MatrixGemm::GetKernelName(), thread_num);
+    printf("%6s %16s %16s %16s %16s\n", "size", "reference[GF/s]", "operator*[GF/s]", "gemm[GF/s]", "gemm_mt[GF/s]");
+    for (int32_t size = 4; size <= max_size; size *= 2) {
+        const Matrix mat1(size, size, CreateRandom(size * size, 1));
+        const Matrix mat2(size, size, CreateRandom(size * size, 2));
+        Matrix mat;
+        std::vector<float> c(static_cast<size_t>(size) * size);
+
+        pool.SetThreadNum(1);
+        const double gflops_reference = MeasureGflops(size, [&]() { mat = MultiplyReference(mat1, mat2); });
+        const double gflops_operator = MeasureGflops(size, [&]() { mat = mat1 * mat2; });
+        const double gflops_gemm = MeasureGflops(size, [&]() { MatrixGemm::Multiply(mat1.Data(), mat2.Data(), c.data(), size, size, size); });
+        pool.SetThreadNum(thread_num);
+        const double gflops_gemm_mt = MeasureGflops(size, [&]() { MatrixGemm::Multiply(mat1.Data(), mat2.Data(), c.data(), size, size, size); });
+        printf("%6d %16.2f %16.2f %16.2f %16.2f\n", size, gflops_reference, gflops_operator, gflops_gemm, gflops_gemm_mt);
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+
+#include "quaternion.h"
+#include "rotation_kernel.h"
+#include "rotation_interpolation.h"
+
+/*** Macro ***/
+static constexpr double MIN_MEASURE_TIME_SEC = 0.2;
+
+/*** Function ***/
+static std::vector<Quaternion> CreateRandom(int32_t num, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<Quaternion> q_list(num);
+    for (auto& q : q_list) q = Quaternion(dist(engine), dist(engine), dist(engine), dist(engine)).Normalize();
+    return q_list;
+}
+
+static std::vector<float> ToPlanes(const std::vector<Quaternion>& q_list)
+{
+    const size_t num = q_list.size();
+    std::vector<float> planes(num * 4);
+    for (size_t i = 0; i < num; i++) {
+        planes[0 * num + i] = q_list[i].x;
+        planes[1 * num + i] = q_list[i].y;
+        planes[2 * num + i] = q_list[i].z;
+        planes[3 * num + i] = q_list[i].w;
+    }
+    return planes;
+}
+
+/* Slerp calculated in double by the textbook formula, as the reference of accuracy */
+static void SlerpReference(const Quaternion& q0, const Quaternion& q1, double t, double (&q)[4])
+{
+    const double a[4] = { q0.x, q0.y, q0.z, q0.w };
+    double b[4] = { q1.x, q1.y, q1.z, q1.w };
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    if (dot < 0) {
+        for (auto& v : b) v = -v;
+        dot = -dot;
+    }
+    const double omega = std::acos(std::min(dot, 1.0));
+    for (int32_t c = 0; c < 4; c++) {
+        q[c] = (omega < 1e-12) ? a[c] : (std::sin((1 - t) * omega) * a[c] + std::sin(t * omega) * b[c]) / std::sin(omega);
+    }
+}
+
+/* Rotation angle between two orientations */
+static double GetAngle(const double (&a)[4], float x, float y, float z, float w)
+{
+    const double b[4] = { x, y, z, w };
+    const double sign = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0 ? -1.0 : 1.0;
+    double diff = 0, sum = 0;
+    for (int32_t i = 0; i < 4; i++) {
+        diff += (a[i] - sign * b[i]) * (a[i] - sign * b[i]);
+        sum += (a[i] + sign * b[i]) * (a[i] + sign * b[i]);
+    }
+    return 4 * std::atan2(std::sqrt(diff), std::sqrt(sum));
+}
+
+/* Run func (which makes num interpolated rotations) repeatedly for at least MIN_MEASURE_TIME_SEC and return million rotations per second */
+static double MeasureMrotPerSec(int64_t num, const std::function<void()>& func)
+{
+    int32_t iteration = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        func();
+        iteration++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    } while (elapsed < MIN_MEASURE_TIME_SEC);
+    return static_cast<double>(num) * iteration / elapsed * 1e-6;
+}
+
+int main(int argc, char* argv[])
+{
+    /* usage: BenchmarkRotationInterpolation [number of pairs] [number of parameters] */
+    const int32_t num = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    const int32_t num_t = (argc > 2) ? std::atoi(argv[2]) : 16;
+    const float max_error_rad = 1e-3f;
+
+    /* Pairs of keyframes which are close, as resampling of a sensor stream */
+    const std::vector<Quaternion> q0_list = CreateRandom(num, 1);
+    const std::vector<Quaternion> delta_list = CreateRandom(num, 2);
+    std::vector<Quaternion> q1_list(num), s0_list(num), s1_list(num);
+    for (int32_t i = 0; i < num; i++) {
+        const Vec4 axis_angle = delta_list[i].ToAxisAngle();
+        const float rad = 0.2f * static_cast<float>(i % 16) / 16;
+        q1_list[i] = q0_list[i] * Quaternion::FromAxisAngle(axis_angle[0], axis_angle[1], axis_angle[2], rad);
+        s0_list[i] = q0_list[i] * Quaternion::FromAxisAngle(axis_angle[1], axis_angle[2], axis_angle[0], rad * 0.1f);
+        s1_list[i] = q1_list[i] * Quaternion::FromAxisAngle(axis_angle[2], axis_angle[0], axis_angle[1], rad * 0.1f);
+    }
+    const std::vector<float> quat0 = ToPlanes(q0_list);
+    const std::vector<float> quat1 = ToPlanes(q1_list);
+    const std::vector<float> s0 = ToPlanes(s0_list);
+    const std::vector<float> s1 = ToPlanes(s1_list);
+    std::vector<float> t(num_t);
+    for (int32_t j = 0; j < num_t; j++) t[j] = static_cast<float>(j) / (num_t - 1);
+    std::vector<float> quat(static_cast<size_t>(num) * 4 * num_t);
+    const int64_t num_out = static_cast<int64_t>(num) * num_t;
+    volatile float sink = 0.0f;
+
+    printf("kernel: %s, pairs: %d, parameters: %d\n", RotationKernel::Get().name, num, num_t);
+    printf("%10s %16s %16s\n", "", "scalar[Mrot/s]", "batch[Mrot/s]");
+    const double slerp_scalar = MeasureMrotPerSec(num_out, [&]() {
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t j = 0; j < num_t; j++) sink = sink + RotationInterpolation::Slerp(q0_list[i], q1_list[i], t[j]).w;
+        }
+    });
+    const double slerp_batch = MeasureMrotPerSec(num_out, [&]() {
+        RotationInterpolation::Slerps(quat0.data(), quat1.data(), num, t.data(), num_t, quat.data());
+    });
+    printf("%10s %16.2f %16.2f\n", "slerp", slerp_scalar, slerp_batch);
+    const double nlerp_scalar = MeasureMrotPerSec(num_out, [&]() {
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t j = 0; j < num_t; j++) sink = sink + RotationInterpolation::Nlerp(q0_list[i], q1_list[i], t[j], max_error_rad).w;
+        }
+    });
+    const double nlerp_batch = MeasureMrotPerSec(num_out, [&]() {
+        RotationInterpolation::Nlerps(quat0.data(), quat1.data(), num, t.data(), num_t, max_error_rad, quat.data());
+    });
+    printf("%10s %16.2f %16.2f\n", "nlerp", nlerp_scalar, nlerp_batch);
+    const double squad_scalar = MeasureMrotPerSec(num_out, [&]() {
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t j = 0; j < num_t; j++) sink = sink + RotationInterpolation::Squad(q0_list[i], q1_list[i], s0_list[i], s1_list[i], t[j]).w;
+        }
+    });
+    const double squad_batch = MeasureMrotPerSec(num_out, [&]() {
+        RotationInterpolation::Squads(quat0.data(), quat1.data(), s0.data(), s1.data(), num, t.data(), num_t, quat.data());
+    });
+    printf("%10s %16.2f %16.2f\n", "squad", squad_scalar, squad_batch);
+
+    /* Accuracy against slerp in double */
+    double error_slerp_scalar = 0, error_slerp_batch = 0, error_nlerp_batch = 0;
+    RotationInterpolation::Slerps(quat0.data(), quat1.data(), num, t.data(), num_t, quat.data());
+    std::vector<float> quat_nlerp(quat.size());
+    RotationInterpolation::Nlerps(quat0.data(), quat1.data(), num, t.data(), num_t, max_error_rad, quat_nlerp.data());
+    for (int32_t j = 0; j < num_t; j++) {
+        const float* p = quat.data() + static_cast<size_t>(j) * 4 * num;
+        const float* p_nlerp = quat_nlerp.data() + static_cast<size_t>(j) * 4 * num;
+        for (int32_t i = 0; i < num; i++) {
+            double reference[4];
+            SlerpReference(q0_list[i], q1_list[i], t[j], reference);
+            const Quaternion q = RotationInterpolation::Slerp(q0_list[i], q1_list[i], t[j]);
+            error_slerp_scalar = std::max(error_slerp_scalar, GetAngle(reference, q.x, q.y, q.z, q.w));
+            error_slerp_batch = std::max(error_slerp_batch, GetAngle(reference, p[0 * num + i], p[1 * num + i], p[2 * num + i], p[3 * num + i]));
+            error_nlerp_batch = std::max(error_nlerp_batch, GetAngle(reference, p_nlerp[0 * num + i], p_nlerp[1 * num + i], p_nlerp[2 * num + i], p_nlerp[3 * num + i]));
+        }
+    }
+    printf("\nmax error from slerp in double [rad]\n");
+    printf("slerp scalar: %.3e, slerp batch: %.3e, nlerp batch (bound %.1e): %.3e\n", error_slerp_scalar, error_slerp_batch, max_error_rad, error_nlerp_batch);
+
+    return 0;
+}
@@ -0,0 +1,363 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <functional>
+
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "rotation_kernel.h"
+#include "quaternion.h"
+#include "fast_trig.h"
+
+/*** Macro ***/
+static constexpr double MIN_MEASURE_TIME_SEC = 0.2;
+
+/*** Function ***/
+static std::vector<float> CreateRandom(int32_t size, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-3.14f, 3.14f);
+    std::vector<float> data(size);
+    for (auto& v : data) v = dist(engine);
+    return data;
+}
+
+/* The product of three rotations which ConvertEulerMobile2RotationMatrix used before the closed form */
+static void ConvertEulerMobile2RotationMatrixReference(RotationMatrix::EULER_ORDER order, float x, float y, float z, Mat3& mat3_rot)
+{
+    Mat3 rot_x, rot_y, rot_z;
+    RotationMatrix::RotateX(x, rot_x);
+    RotationMatrix::RotateY(y, rot_y);
+    RotationMatrix::RotateZ(z, rot_z);
+    switch (order) {
+    case RotationMatrix::EULER_ORDER::XYZ:
+        mat3_rot = rot_x * rot_y * rot_z;
+        break;
+    case RotationMatrix::EULER_ORDER::XZY:
+        mat3_rot = rot_x * rot_z * rot_y;
+        break;
+    case RotationMatrix::EULER_ORDER::YXZ:
+        mat3_rot = rot_y * rot_x * rot_z;
+        break;
+    case RotationMatrix::EULER_ORDER::YZX:
+        mat3_rot = rot_y * rot_z * rot_x;
+        break;
+    case RotationMatrix::EULER_ORDER::ZXY:
+        mat3_rot = rot_z * rot_x * rot_y;
+        break;
+    case RotationMatrix::EULER_ORDER::ZYX:
+        mat3_rot = rot_z * rot_y * rot_x;
+        break;
+    }
+}
+
+/* The rotation vector conversions used before the SO(3) exp / log (normalize twice, std::pow and acos) */
+static void ConvertRotationVector2RotationMatrixReference(float x_rad, float y_rad, float z_rad, Mat3& mat3_rot)
+{
+    const float rad = std::sqrt(x_rad * x_rad + y_rad * y_rad + z_rad * z_rad);
+    if (rad <= 0.0f) {
+        mat3_rot = Mat3::Identity();
+        return;
+    }
+    RotationMatrix::ConvertAxisAngle2RotationMatrix(x_rad / rad, y_rad / rad, z_rad / rad, rad, mat3_rot);
+}
+
+static Vec3 ConvertRotationMatrix2RotationVectorReference(const Mat3& mat3_rot)
+{
+    Vec3 vec3;
+    const float d = static_cast<float>(std::sqrt(
+        std::pow(mat3_rot(2, 1) - mat3_rot(1, 2), 2)
+        + std::pow(mat3_rot(0, 2) - mat3_rot(2, 0), 2)
+        + std::pow(mat3_rot(1, 0) - mat3_rot(0, 1), 2)
+    ));
+    if (d > 0) {
+        const float rad = std::acos((mat3_rot(0, 0) + mat3_rot(1, 1) + mat3_rot(2, 2) - 1) / 2);
+        vec3[0] = (mat3_rot(2, 1) - mat3_rot(1, 2)) / d * rad;
+        vec3[1] = (mat3_rot(0, 2) - mat3_rot(2, 0)) / d * rad;
+        vec3[2] = (mat3_rot(1, 0) - mat3_rot(0, 1)) / d * rad;
+    }
+    return vec3;
+}
+
+/* max |R^T R - I| of num matrices in 9 planes */
+static float OrthogonalityError(const std::vector<float>& mat3_rot, int32_t num)
+{
+    float error = 0.0f;
+    for (int32_t n = 0; n < num; n++) {
+        for (int32_t row = 0; row < 3; row++) {
+            for (int32_t col = 0; col < 3; col++) {
+                float dot = 0.0f;
+                for (int32_t k = 0; k < 3; k++) dot += mat3_rot[static_cast<size_t>(k * 3 + row) * num + n] * mat3_rot[static_cast<size_t>(k * 3 + col) * num + n];
+                error = std::max(error, std::abs(dot - ((row == col) ? 1.0f : 0.0f)));
+            }
+        }
+    }
+    return error;
+}
+
+/* Run func (which converts num rotations) repeatedly for at least MIN_MEASURE_TIME_SEC and return nanoseconds per rotation */
+static double MeasureNsPerRotation(int32_t num, const std::function<void()>& func)
+{
+    int32_t iteration = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        func();
+        iteration++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    } while (elapsed < MIN_MEASURE_TIME_SEC);
+    return elapsed * 1e9 / (static_cast<double>(num) * iteration);
+}
+
+int main(int argc, char* argv[])
+{
+    /* usage: BenchmarkRotationMatrix [number of rotations] */
+    const int32_t num = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    const std::vector<float> x = CreateRandom(num, 1);
+    const std::vector<float> y = CreateRandom(num, 2);
+    const std::vector<float> z = CreateRandom(num, 3);
+    std::vector<float> mat3_rot(static_cast<size_t>(num) * 9);
+    volatile float sink = 0.0f;
+
+    printf("kernel: %s, rotations: %d\n", RotationKernel::Get().name, num);
+    printf("%6s %16s %16s %16s %16s\n", "order", "reference[ns]", "mobile[ns]", "fixed[ns]", "batch[ns]");
+    static const char* ORDER_NAME[6] = { "XYZ", "XZY", "YXZ", "YZX", "ZXY", "ZYX" };
+    for (int32_t i = 0; i < 6; i++) {
+        const auto order = static_cast<RotationMatrix::EULER_ORDER>(i);
+        Mat3 mat;
+        const double ns_reference = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                ConvertEulerMobile2RotationMatrixReference(order, x[n], y[n], z[n], mat);
+                sink = sink + mat[0];
+            }
+        });
+        const double ns_mobile = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                RotationMatrix::ConvertEulerMobile2RotationMatrix(order, x[n], y[n], z[n], mat);
+                sink = sink + mat[0];
+            }
+        });
+        const double ns_fixed = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                RotationMatrix::ConvertEulerFixed2RotationMatrix(order, x[n], y[n], z[n], mat);
+                sink = sink + mat[0];
+            }
+        });
+        const double ns_batch = MeasureNsPerRotation(num, [&]() {
+            RotationMatrix::ConvertEulerMobiles2RotationMatrices(order, x.data(), y.data(), z.data(), num, mat3_rot.data());
+            sink = sink + mat3_rot[0];
+        });
+        printf("%6s %16.2f %16.2f %16.2f %16.2f\n", ORDER_NAME[i], ns_reference, ns_mobile, ns_fixed, ns_batch);
+    }
+
+    /* Euler angles of all the orders from a matrix */
+    RotationMatrix::ConvertEulerMobiles2RotationMatrices(RotationMatrix::EULER_ORDER::XYZ, x.data(), y.data(), z.data(), num, mat3_rot.data());
+    std::vector<Mat3> mat3_list(num);
+    for (int32_t n = 0; n < num; n++) {
+        for (int32_t k = 0; k < 9; k++) mat3_list[n][k] = mat3_rot[static_cast<size_t>(k) * num + n];
+    }
+    std::vector<float> mobile(static_cast<size_t>(num) * 18);
+    std::vector<float> fixed(static_cast<size_t>(num) * 18);
+    const double ns_each = MeasureNsPerRotation(num, [&]() {
+        for (int32_t n = 0; n < num; n++) {
+            for (int32_t i = 0; i < 6; i++) {
+                const auto order = static_cast<RotationMatrix::EULER_ORDER>(i);
+                sink = sink + RotationMatrix::ConvertRotationMatrix2EulerMobile(order, mat3_list[n])[0];
+                sink = sink + RotationMatrix::ConvertRotationMatrix2EulerFixed(order, mat3_list[n])[0];
+            }
+        }
+    });
+    const double ns_all = MeasureNsPerRotation(num, [&]() {
+        Vec3 mobile_angle[6], fixed_angle[6];
+        for (int32_t n = 0; n < num; n++) {
+            RotationMatrix::DecomposeAllEuler(mat3_list[n], mobile_angle, fixed_angle);
+            sink = sink + mobile_angle[0][0] + fixed_angle[0][0];
+        }
+    });
+    const double ns_all_batch = MeasureNsPerRotation(num, [&]() {
+        RotationMatrix::DecomposeAllEulers(mat3_rot.data(), num, mobile.data(), fixed.data());
+        sink = sink + mobile[0] + fixed[0];
+    });
+    printf("\n%24s %16s %16s\n", "12 orders each[ns]", "all at once[ns]", "batch[ns]");
+    printf("%24.2f %16.2f %16.2f\n", ns_each, ns_all, ns_all_batch);
+
+    /* Chain incremental rotations and rotate a vector by the result */
+    std::vector<Quaternion> q_list(num);
+    std::vector<Mat3> mat3_increment_list(num);
+    for (int32_t n = 0; n < num; n++) {
+        q_list[n] = Quaternion::FromAxisAngle(x[n], y[n], z[n], 0.01f);
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(x[n], y[n], z[n], 0.01f, mat3_increment_list[n]);
+    }
+    const Vec3 vec3({ 1.0f, 2.0f, 3.0f });
+    const double ns_chain_mat = MeasureNsPerRotation(num, [&]() {
+        Mat3 mat = Mat3::Identity();
+        for (int32_t n = 0; n < num; n++) {
+            mat = mat * mat3_increment_list[n];
+            const Vec3 rotated = mat * vec3;
+            sink = sink + rotated[0];
+        }
+    });
+    const double ns_chain_quaternion = MeasureNsPerRotation(num, [&]() {
+        Quaternion q;
+        for (int32_t n = 0; n < num; n++) {
+            q *= q_list[n];
+            const Vec3 rotated = q.Rotate(vec3);
+            sink = sink + rotated[0];
+        }
+    });
+    printf("\n%24s %16s\n", "chain matrix[ns]", "chain quat[ns]");
+    printf("%24.2f %16.2f\n", ns_chain_mat, ns_chain_quaternion);
+
+    /* SO(3) exp / log (rotation vector <-> rotation matrix) */
+    std::vector<float> vx(num), vy(num), vz(num);
+    const double ns_exp_reference = MeasureNsPerRotation(num, [&]() {
+        Mat3 mat;
+        for (int32_t n = 0; n < num; n++) {
+            ConvertRotationVector2RotationMatrixReference(x[n], y[n], z[n], mat);
+            sink = sink + mat[0];
+        }
+    });
+    const double ns_exp = MeasureNsPerRotation(num, [&]() {
+        Mat3 mat;
+        for (int32_t n = 0; n < num; n++) {
+            RotationMatrix::ConvertRotationVector2RotationMatrix(x[n], y[n], z[n], mat);
+            sink = sink + mat[0];
+        }
+    });
+    const double ns_exp_batch = MeasureNsPerRotation(num, [&]() {
+        RotationMatrix::ConvertRotationVectors2RotationMatrices(x.data(), y.data(), z.data(), num, mat3_rot.data());
+        sink = sink + mat3_rot[0];
+    });
+    const double ns_log_reference = MeasureNsPerRotation(num, [&]() {
+        for (int32_t n = 0; n < num; n++) {
+            sink = sink + ConvertRotationMatrix2RotationVectorReference(mat3_list[n])[0];
+        }
+    });
+    const double ns_log = MeasureNsPerRotation(num, [&]() {
+        for (int32_t n = 0; n < num; n++) {
+            sink = sink + RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_list[n])[0];
+        }
+    });
+    const double ns_log_batch = MeasureNsPerRotation(num, [&]() {
+        RotationMatrix::ConvertRotationMatrices2RotationVectors(mat3_rot.data(), num, vx.data(), vy.data(), vz.data());
+        sink = sink + vx[0];
+    });
+    printf("\n%6s %16s %16s %16s\n", "", "reference[ns]", "each[ns]", "batch[ns]");
+    printf("%6s %16.2f %16.2f %16.2f\n", "exp", ns_exp_reference, ns_exp, ns_exp_batch);
+    printf("%6s %16.2f %16.2f %16.2f\n", "log", ns_log_reference, ns_log, ns_log_batch);
+
+
+    /* Re-orthonormalize drifted rotations */
+    std::vector<float> mat3_drifted(mat3_rot.size());
+    {
+        std::mt19937 engine(4);
+        std::uniform_real_distribution<float> drift(-1e-3f, 1e-3f);
+        RotationMatrix::ConvertEulerMobiles2RotationMatrices(RotationMatrix::EULER_ORDER::XYZ, x.data(), y.data(), z.data(), num, mat3_drifted.data());
+        for (auto& v : mat3_drifted) v += drift(engine);
+    }
+    std::vector<Mat3> mat3_drifted_list(num);
+    for (int32_t n = 0; n < num; n++) {
+        for (int32_t k = 0; k < 9; k++) mat3_drifted_list[n][k] = mat3_drifted[static_cast<size_t>(k) * num + n];
+    }
+    static const RotationMatrix::NORMALIZE_METHOD NORMALIZE_METHOD_LIST[3] = {
+        RotationMatrix::NORMALIZE_METHOD::QUATERNION, RotationMatrix::NORMALIZE_METHOD::GRAM_SCHMIDT, RotationMatrix::NORMALIZE_METHOD::POLAR };
+    static const char* NORMALIZE_METHOD_NAME[3] = { "quaternion", "gram-schmidt", "polar" };
+    printf("\n%12s %16s %16s %16s %16s\n", "normalize", "each[ns]", "batch[ns]", "orthogonality", "distance");
+    printf("%12s %16s %16s %16.2e\n", "(input)", "", "", OrthogonalityError(mat3_drifted, num));
+    for (int32_t i = 0; i < 3; i++) {
+        const auto method = NORMALIZE_METHOD_LIST[i];
+        const double ns_each = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                sink = sink + RotationMatrix::NormalizeRotationMatrix(mat3_drifted_list[n], method)[0];
+            }
+        });
+        const double ns_batch = MeasureNsPerRotation(num, [&]() {
+            std::copy(mat3_drifted.begin(), mat3_drifted.end(), mat3_rot.begin());
+            RotationMatrix::NormalizeRotationMatrices(mat3_rot.data(), num, method);
+            sink = sink + mat3_rot[0];
+        });
+        /* mean Frobenius distance from the input (the polar decomposition is the smallest) */
+        double distance = 0.0;
+        for (size_t k = 0; k < mat3_rot.size(); k++) distance += (mat3_rot[k] - mat3_drifted[k]) * (mat3_rot[k] - mat3_drifted[k]);
+        distance = std::sqrt(distance / num);
+        printf("%12s %16.2f %16.2f %16.2e %16.2e\n", NORMALIZE_METHOD_NAME[i], ns_each, ns_batch, OrthogonalityError(mat3_rot, num), distance);
+    }
+
+    /* Exact (libm) and fast (polynomial) trigonometric functions */
+    std::vector<float> s(num), c(num);
+    const double ns_sincos_libm = MeasureNsPerRotation(num, [&]() {
+        for (int32_t n = 0; n < num; n++) {
+            s[n] = std::sin(x[n]);
+            c[n] = std::cos(x[n]);
+        }
+        sink = sink + s[0] + c[0];
+    });
+    const double ns_sincos_fast = MeasureNsPerRotation(num, [&]() {
+        for (int32_t n = 0; n < num; n++) {
+            FastTrig::SinCos(x[n], s[n], c[n]);
+        }
+        sink = sink + s[0] + c[0];
+    });
+    const double ns_sincos_kernel = MeasureNsPerRotation(num, [&]() {
+        RotationKernel::Get().sincos(x.data(), num, s.data(), c.data());
+        sink = sink + s[0] + c[0];
+    });
+    printf("\n%12s %16s %16s %16s\n", "", "libm[ns]", "fast[ns]", "kernel[ns]");
+    printf("%12s %16.2f %16.2f %16.2f\n", "sincos", ns_sincos_libm, ns_sincos_fast, ns_sincos_kernel);
+
+    static const RotationMatrix::TRIG_MODE TRIG_MODE_LIST[2] = { RotationMatrix::TRIG_MODE::EXACT, RotationMatrix::TRIG_MODE::FAST };
+    static const char* TRIG_MODE_NAME[2] = { "exact", "fast" };
+    printf("\n%12s %16s %16s %16s %16s\n", "trig mode", "euler->mat[ns]", "mat->euler[ns]", "exp[ns]", "log[ns]");
+    for (int32_t i = 0; i < 2; i++) {
+        RotationMatrix::SetTrigMode(TRIG_MODE_LIST[i]);
+        const double ns_euler2mat = MeasureNsPerRotation(num, [&]() {
+            Mat3 mat;
+            for (int32_t n = 0; n < num; n++) {
+                RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::XYZ, x[n], y[n], z[n], mat);
+                sink = sink + mat[0];
+            }
+        });
+        const double ns_mat2euler = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                sink = sink + RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER::XYZ, mat3_list[n])[0];
+            }
+        });
+        const double ns_exp = MeasureNsPerRotation(num, [&]() {
+            Mat3 mat;
+            for (int32_t n = 0; n < num; n++) {
+                RotationMatrix::ConvertRotationVector2RotationMatrix(x[n], y[n], z[n], mat);
+                sink = sink + mat[0];
+            }
+        });
+        const double ns_log = MeasureNsPerRotation(num, [&]() {
+            for (int32_t n = 0; n < num; n++) {
+                sink = sink + RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_list[n])[0];
+            }
+        });
+        printf("%12s %16.2f %16.2f %16.2f %16.2f\n", TRIG_MODE_NAME[i], ns_euler2mat, ns_mat2euler, ns_exp, ns_log);
+    }
+    RotationMatrix::SetTrigMode(RotationMatrix::TRIG_MODE::EXACT);
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "converter.h"
+#include "float_text.h"
+#include "batch_converter.h"
+
+/*** Macro ***/
+static constexpr int32_t BLOCK_SIZE = 2048;        /* rotations converted at once. The buffers stay in the cache */
+static constexpr size_t ERROR_TEXT_LENGTH = 80;
+
+/*** Global variable ***/
+
+/*** Function ***/
+struct BatchConverter::Buffer {
+    Buffer(int32_t input_component_num, int32_t output_component_num)
+        : input(static_cast<size_t>(BLOCK_SIZE) * input_component_num)
+        , mat3_rot(static_cast<size_t>(BLOCK_SIZE) * 9)
+        , output(static_cast<size_t>(BLOCK_SIZE) * output_component_num)
+        , text(static_cast<size_t>(BLOCK_SIZE) * output_component_num * (FloatText::FORMAT_MAX_LENGTH + 1))
+    {}
+
+    std::vector<float> input;       /* planes of the input representation */
+    std::vector<float> mat3_rot;
+    std::vector<float> output;      /* planes of all the output representations */
+    std::vector<char> text;
+};
+
+static bool IsAngleComponent(REPRESENTATION_TYPE type, int32_t component)
+{
+    switch (type) {
+    case REPRESENTATION_TYPE::ROTATION_VECTOR:
+    case REPRESENTATION_TYPE::EULER_MOBILE:
+    case REPRESENTATION_TYPE::EULER_FIXED:
+        return true;
+    case REPRESENTATION_TYPE::AXIS_ANGLE:
+        return component == 3;
+    default:
+        return false;
+    }
+}
+
+static void ScaleAngles(REPRESENTATION_TYPE type, float scale, int32_t plane_stride, int32_t num, float* planes)
+{
+    for (int32_t c = 0; c < Converter::GetComponentNum(type); c++) {
+        if (!IsAngleComponent(type, c)) continue;
+        float* plane = planes + static_cast<size_t>(c) * plane_stride;
+        for (int32_t i = 0; i < num; i++) plane[i] *= scale;
+    }
+}
+
+static inline bool IsBlank(char c)
+{
+    return (c == ' ') || (c == '\t');
+}
+
+static inline const char* SkipBlank(const char* p, const char* last)
+{
+    while ((p < last) && IsBlank(*p)) p++;
+    return p;
+}
+
+static void ThrowInvalidLine(const char* message, const char* first, const char* last)
+{
+    const size_t length = std::min(static_cast<size_t>(last - first), ERROR_TEXT_LENGTH);
+    throw std::runtime_error(std::string(message) + ": \"" + std::string(first, length) + "\"");
+}
+
+BatchConverter::BatchConverter(const Setting& setting)
+    : m_setting(setting)
+{
+    if (setting.output_list.empty()) {
+        throw std::invalid_argument("No output representation");
+    }
+    m_input_component_num = Converter::GetComponentNum(setting.input.type);
+    m_output_component_num = 0;
+    for (const auto& output : setting.output_list) {
+        m_output_component_num += Converter::GetComponentNum(output.type);
+    }
+}
+
+size_t BatchConverter::GetInputRecordSize() const
+{
+    return sizeof(float) * m_input_component_num;
+}
+
+size_t BatchConverter::GetOutputRecordSize() const
+{
+    return sizeof(float) * m_output_component_num;
+}
+
+std::string BatchConverter::GetHeader() const
+{
+    std::string header;
+    for (const auto& output : m_setting.output_list) {
+        for (int32_t c = 0; c < Converter::GetComponentNum(output.type); c++) {
+            if (!header.empty()) header += ',';
+            header += Converter::GetComponentName(output.type, c);
+        }
+    }
+    return header + "\n";
+}
+
+size_t BatchConverter::FindChunkEnd(const char* data, size_t size) const
+{
+    if (m_setting.input_format == FORMAT::BINARY) {
+        return size - size % GetInputRecordSize();
+    }
+    for (size_t i = size; i > 0; i--) {
+        if (data[i - 1] == '\n') return i;
+    }
+    return 0;
+}
+
+int64_t BatchConverter::ConvertChunk(const char* data, size_t size, std::string& output, bool is_first_chunk) const
+{
+    Buffer buffer(m_input_component_num, m_output_component_num);
+    if (m_setting.input_format == FORMAT::BINARY) {
+        return ParseBinary(data, size, buffer, output);
+    } else {
+        return ParseCsv(data, size, is_first_chunk, buffer, output);
+    }
+}
+
+int64_t BatchConverter::ParseCsv(const char* data, size_t size, bool is_first_chunk, Buffer& buffer, std::string& output) const
+{
+    int64_t record_num = 0;
+    int32_t num = 0;
+    const char* const end = data + size;
+    for (const char* line = data; line < end; ) {
+        const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        const char* const next = line_end ? line_end + 1 : end;
+        if (!line_end) line_end = end;
+        if ((line_end > line) && (line_end[-1] == '\r')) line_end--;
+
+        const char* p = SkipBlank(line, line_end);
+        bool is_record = (p < line_end) && (*p != '#');
+        for (int32_t c = 0; is_record && (c < m_input_component_num); c++) {
+            if (c > 0) {
+                p = SkipBlank(p, line_end);
+                if ((p < line_end) && (*p == ',')) p = SkipBlank(p + 1, line_end);
+            }
+            float value;
+            const char* value_end = FloatText::Parse(p, line_end, value);
+            const bool is_valid = (value_end != p) && ((value_end == line_end) || IsBlank(*value_end) || (*value_end == ','));
+            if (!is_valid) {
+                if (is_first_chunk && (line == data) && (c == 0) && std::isalpha(static_cast<unsigned char>(*p))) {
+                    is_record = false;  /* header */
+                    break;
+                }
+                ThrowInvalidLine("Invalid value", line, line_end);
+            }
+            buffer.input[static_cast<size_t>(c) * BLOCK_SIZE + num] = value;
+            p = value_end;
+        }
+        if (is_record) {
+            p = SkipBlank(p, line_end);
+            if ((p < line_end) && (*p == ',')) p = SkipBlank(p + 1, line_end);
+            if (p != line_end) ThrowInvalidLine("Too many values", line, line_end);
+            if (++num == BLOCK_SIZE) {
+                ConvertBlock(buffer.input.data(), BLOCK_SIZE, num, buffer, output);
+                record_num += num;
+                num = 0;
+            }
+        }
+        line = next;
+    }
+
+    if (num > 0) {
+        ConvertBlock(buffer.input.data(), BLOCK_SIZE, num, buffer, output);
+        record_num += num;
+    }
+    return record_num;
+}
+
+int64_t BatchConverter::ParseBinary(const char* data, size_t size, Buffer& buffer, std::string& output) const
+{
+    const size_t record_size = GetInputRecordSize();
+    if (size % record_size != 0) {
+        throw std::runtime_error("The size of binary input is not a multiple of the record size (" + std::to_string(record_size) + " bytes)");
+    }
+    const int64_t record_num = static_cast<int64_t>(size / record_size);
+    for (int64_t first = 0; first < record_num; first += BLOCK_SIZE) {
+        const int32_t num = static_cast<int32_t>(std::min<int64_t>(BLOCK_SIZE, record_num - first));
+        const char* block = data + first * record_size;
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t c = 0; c < m_input_component_num; c++) {
+                std::memcpy(&buffer.input[static_cast<size_t>(c) * num + i], block + i * record_size + c * sizeof(float), sizeof(float));
+            }
+        }
+        ConvertBlock(buffer.input.data(), num, num, buffer, output);
+    }
+    return record_num;
+}
+
+void BatchConverter::ConvertPlanes(const float* planes, int32_t plane_stride, int32_t num, std::string& output) const
+{
+    Buffer buffer(m_input_component_num, m_output_component_num);
+    for (int32_t first = 0; first < num; first += BLOCK_SIZE) {
+        ConvertBlock(planes + first, plane_stride, std::min(BLOCK_SIZE, num - first), buffer, output);
+    }
+}
+
+/* num <= BLOCK_SIZE */
+void BatchConverter::ConvertBlock(const float* planes, int32_t plane_stride, int32_t num, Buffer& buffer, std::string& output) const
+{
+    const float to_radian = static_cast<float>(M_PI / 180.0);
+    const float to_degree = static_cast<float>(180.0 / M_PI);
+    if (m_setting.is_degree) {
+        /* Planes given by the caller are not modified */
+        if (planes != buffer.input.data()) {
+            for (int32_t c = 0; c < m_input_component_num; c++) {
+                std::copy(planes + static_cast<size_t>(c) * plane_stride, planes + static_cast<size_t>(c) * plane_stride + num, &buffer.input[static_cast<size_t>(c) * num]);
+            }
+            plane_stride = num;
+        }
+        ScaleAngles(m_setting.input.type, to_radian, plane_stride, num, buffer.input.data());
+        planes = buffer.input.data();
+    }
+    Converter::ConvertToRotationMatrices(m_setting.input, planes, plane_stride, num, m_setting.is_normalize_rotation_matrix, buffer.mat3_rot.data());
+    float* output_planes = buffer.output.data();
+    for (const auto& representation : m_setting.output_list) {
+        Converter::ConvertFromRotationMatrices(representation, buffer.mat3_rot.data(), num, output_planes);
+        if (m_setting.is_degree) ScaleAngles(representation.type, to_degree, num, num, output_planes);
+        output_planes += static_cast<size_t>(Converter::GetComponentNum(representation.type)) * num;
+    }
+
+    /* Planes to records */
+    char* text = buffer.text.data();
+    if (m_setting.output_format == FORMAT::BINARY) {
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t k = 0; k < m_output_component_num; k++) {
+                std::memcpy(text, &buffer.output[static_cast<size_t>(k) * num + i], sizeof(float));
+                text += sizeof(float);
+            }
+        }
+    } else {
+        for (int32_t i = 0; i < num; i++) {
+            for (int32_t k = 0; k < m_output_component_num; k++) {
+                if (k > 0) *text++ = ',';
+                text = FloatText::Format(buffer.output[static_cast<size_t>(k) * num + i], m_setting.precision, text);
+            }
+            *text++ = '\n';
+        }
+    }
+    output.append(buffer.text.data(), text - buffer.text.data());
+}
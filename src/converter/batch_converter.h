@@ -0,0 +1,91 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef BATCH_CONVERTER_H
+#define BATCH_CONVERTER_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "converter.h"
+
+/*
+ * Convert chunks of records (one rotation per record) from a representation into a set of representations.
+ * CSV: one record per line. Values are separated by ',' and / or spaces. Empty lines and lines starting with '#' (comments)
+ *      are skipped. The first line of the input is skipped if its first field is a word (header).
+ * BINARY: records of float32 in the native byte order, without a header or padding.
+ * Output records have the components of the output representations in the order of output_list.
+ * A chunk is converted independently of the others (ConvertChunk is const), so that chunks can be converted in parallel.
+ */
+class BatchConverter
+{
+public:
+    enum class FORMAT {
+        CSV = 0,
+        BINARY,
+    };
+
+    struct Setting {
+        Converter::Representation input;
+        std::vector<Converter::Representation> output_list;
+        FORMAT input_format;
+        FORMAT output_format;
+        bool is_normalize_rotation_matrix;
+        bool is_degree;         /* angles of input and output are in degree */
+        int32_t precision;      /* digits after the decimal point of CSV output */
+    };
+
+public:
+    /* Throw std::invalid_argument if output_list is empty */
+    explicit BatchConverter(const Setting& setting);
+    ~BatchConverter() {}
+
+    /* The end of the last complete record in [data, data + size) (CSV: just after the last new line) */
+    size_t FindChunkEnd(const char* data, size_t size) const;
+
+    /* Convert the records in a chunk and append the result to output. Return the number of records.
+     * The chunk must end at the end of a record (the last line of the input doesn't need a new line).
+     * is_first_chunk: the chunk is at the beginning of the input, so that its first line can be a header.
+     * Throw std::runtime_error for an invalid record */
+    int64_t ConvertChunk(const char* data, size_t size, std::string& output, bool is_first_chunk = false) const;
+
+    /* Convert num rotations of the input representation in planes (component c of the i-th rotation at planes[c * plane_stride + i],
+     * e.g. a block of a trajectory file) without parsing, and append the result to output. planes is not copied unless is_degree */
+    void ConvertPlanes(const float* planes, int32_t plane_stride, int32_t num, std::string& output) const;
+
+    /* The header line of CSV output (e.g. "qx,qy,qz,qw\n") */
+    std::string GetHeader() const;
+
+    /* Bytes of a binary record */
+    size_t GetInputRecordSize() const;
+    size_t GetOutputRecordSize() const;
+
+private:
+    BatchConverter();
+
+    struct Buffer;
+    int64_t ParseCsv(const char* data, size_t size, bool is_first_chunk, Buffer& buffer, std::string& output) const;
+    int64_t ParseBinary(const char* data, size_t size, Buffer& buffer, std::string& output) const;
+    void ConvertBlock(const float* planes, int32_t plane_stride, int32_t num, Buffer& buffer, std::string& output) const;
+
+private:
+    Setting m_setting;
+    int32_t m_input_component_num;
+    int32_t m_output_component_num;     /* total of all the outputs */
+};
+
+#endif
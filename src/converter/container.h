@@ -0,0 +1,271 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <vector>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+
+#ifndef M_PI
+static constexpr double M_PI = 3.14159265358979323846;
+#endif
+
+enum class REPRESENTATION_TYPE {
+    ROTATION_MATRIX = 0,
+    ROTATION_VECTOR,
+    AXIS_ANGLE,
+    QUATERNION,
+    EULER_MOBILE,
+    EULER_FIXED
+};
+
+class AngleUnit {
+public:
+    AngleUnit() : is_degree(true) {}
+    ~AngleUnit() {}
+
+    float GetAngleRange()
+    {
+        return is_degree ? 360.0f : static_cast<float>(2 * M_PI);
+    }
+    const char* GetAngleFormat()
+    {
+        return is_degree ? "%.1f" : "%.3f";
+    }
+    float GetAngleDragSpeed()
+    {
+        return is_degree ? 1.0f : 0.01f;
+    }
+
+    float Display(float rad)
+    {
+        return is_degree ? static_cast<float>(360.0 * rad / (2 * M_PI)) : rad;
+    }
+
+    float StoreAngle(float displayed_angle)
+    {
+        float rad = is_degree ? static_cast<float>(2 * M_PI * displayed_angle / 360.0) : displayed_angle;
+        return rad;
+    }
+
+public:
+    bool is_degree;
+};
+
+static constexpr int32_t REPRESENTATION_TYPE_NUM = 6;
+
+class InputContainer {
+public:
+    InputContainer() : version() { Reset(); }
+    ~InputContainer() {}
+    void Reset()
+    {
+        selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::ROTATION_MATRIX);
+        rotation_matrix = Matrix::Identity(3);
+        rotation_vector = Matrix(1, 3);
+        axis_angle = Matrix(1, 4);
+        quaternion = Matrix(1, 4);
+        quaternion[3] = 1.0;
+        mobile_euler_order = 0;
+        mobile_euler_angle = Matrix(1, 3);
+        fixed_euler_order = 0;
+        fixed_euler_angle = Matrix(1, 3);
+        MarkAllChanged();
+    }
+
+    /* Call after changing the values (or the euler order) of a representation, so that they are converted again */
+    void MarkChanged(REPRESENTATION_TYPE type)
+    {
+        version[static_cast<int32_t>(type)]++;
+    }
+
+    void MarkAllChanged()
+    {
+        for (int32_t i = 0; i < REPRESENTATION_TYPE_NUM; i++) version[i]++;
+    }
+
+    uint32_t GetVersion(REPRESENTATION_TYPE type) const
+    {
+        return version[static_cast<int32_t>(type)];
+    }
+
+public:
+    /* contain angle as radian */
+    int32_t selected_representation_type;
+    Matrix rotation_matrix;
+    Matrix rotation_vector;
+    Matrix axis_angle;
+    Matrix quaternion;
+    int32_t mobile_euler_order;
+    Matrix mobile_euler_angle;
+    int32_t fixed_euler_order;
+    Matrix fixed_euler_angle;
+
+private:
+    uint32_t version[REPRESENTATION_TYPE_NUM];   /* incremented by every change of each representation */
+};
+
+/* The output representations are calculated from the rotation matrix when they are read first, and kept until the rotation matrix is changed,
+ * so that only the representations which are actually read (e.g. displayed) are converted */
+class OutputContainer {
+public:
+    OutputContainer() { Reset(); }
+    ~OutputContainer() {}
+    void Reset()
+    {
+        rotation_matrix = Matrix::Identity(3);
+        InvalidateCache();
+        source_representation_type = -1;
+        source_version = 0;
+        source_is_normalized = false;
+    }
+
+    /* The cache is kept if the matrix is the same */
+    void SetRotationMatrix(const Matrix& mat3_rot)
+    {
+        bool is_same_rotation = true;
+        for (int32_t i = 0; i < 9; i++) {
+            is_same_rotation &= (rotation_matrix[i] == mat3_rot[i]);
+        }
+        if (is_same_rotation) return;
+        for (int32_t i = 0; i < 9; i++) {
+            rotation_matrix[i] = mat3_rot[i];
+        }
+        InvalidateCache();
+    }
+
+    const Matrix& GetRotationMatrix() const
+    {
+        return rotation_matrix;
+    }
+
+    const Matrix& GetRotationVector() const
+    {
+        if (!is_rotation_vector_valid) {
+            rotation_vector = RotationMatrix::ConvertRotationMatrix2RotationVector(rotation_matrix);
+            is_rotation_vector_valid = true;
+        }
+        return rotation_vector;
+    }
+
+    const Matrix& GetAxisAngle() const
+    {
+        if (!is_axis_angle_valid) {
+            axis_angle = RotationMatrix::ConvertRotationMatrix2AxisAngle(rotation_matrix);
+            is_axis_angle_valid = true;
+        }
+        return axis_angle;
+    }
+
+    const Matrix& GetQuaternion() const
+    {
+        if (!is_quaternion_valid) {
+            quaternion = RotationMatrix::ConvertRotationMatrix2Quaternion(rotation_matrix);
+            is_quaternion_valid = true;
+        }
+        return quaternion;
+    }
+
+    /* order is RotationMatrix::EULER_ORDER. All the orders are calculated at once because they share asin / atan2 */
+    const Matrix& GetMobileEulerAngle(int32_t order) const
+    {
+        UpdateEulerAngle();
+        return mobile_euler_angle[order];
+    }
+
+    const Matrix& GetFixedEulerAngle(int32_t order) const
+    {
+        UpdateEulerAngle();
+        return fixed_euler_angle[order];
+    }
+
+private:
+    void InvalidateCache()
+    {
+        is_rotation_vector_valid = false;
+        is_axis_angle_valid = false;
+        is_quaternion_valid = false;
+        is_euler_angle_valid = false;
+    }
+
+    void UpdateEulerAngle() const
+    {
+        if (is_euler_angle_valid) return;
+        Vec3 mobile[6];
+        Vec3 fixed[6];
+        RotationMatrix::DecomposeAllEuler(rotation_matrix.View(), mobile, fixed);
+        for (int32_t i = 0; i < 6; i++) {
+            mobile_euler_angle[i] = static_cast<Matrix>(mobile[i]);
+            fixed_euler_angle[i] = static_cast<Matrix>(fixed[i]);
+        }
+        is_euler_angle_valid = true;
+    }
+
+private:
+    /* contain angle as radian */
+    Matrix rotation_matrix;
+    mutable Matrix rotation_vector;
+    mutable Matrix axis_angle;
+    mutable Matrix quaternion;
+    mutable Matrix mobile_euler_angle[6];
+    mutable Matrix fixed_euler_angle[6];
+    mutable bool is_rotation_vector_valid;
+    mutable bool is_axis_angle_valid;
+    mutable bool is_quaternion_valid;
+    mutable bool is_euler_angle_valid;
+
+public:
+    /* The input which the rotation matrix is converted from. -1 if it is not converted yet */
+    int32_t source_representation_type;
+    uint32_t source_version;
+    bool source_is_normalized;
+};
+
+
+class SettingContainer {
+public:
+    SettingContainer() {
+        is_dark_mode = true;
+        is_draw_ground = true;
+        is_view_from_axis = true;
+        is_camera_revolution = true;
+        is_normalize_rotation_matrix = true;
+        is_update_input_pressed = false;
+        is_reset_view_pressed = false;
+        is_reset_value_pressed = false;
+    }
+    ~SettingContainer() {}
+
+public:
+    bool is_dark_mode;
+    bool is_draw_ground;
+    bool is_view_from_axis;
+    bool is_camera_revolution;
+    bool is_normalize_rotation_matrix;
+    bool is_update_input_pressed;
+    bool is_reset_view_pressed;
+    bool is_reset_value_pressed;
+};
+
+
+#endif
@@ -0,0 +1,279 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include "batch_converter.h"
+#include "spmc_queue.h"
+#include "conversion_pipeline.h"
+
+/*** Macro ***/
+static constexpr int32_t SPIN_NUM = 16;     /* tries (yielding the CPU) before sleeping while waiting */
+
+/*** Global variable ***/
+
+/*** Function ***/
+static inline int64_t GetTimeNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ConversionPipeline::ConversionPipeline(const BatchConverter& converter, const Setting& setting)
+    : m_converter(converter)
+    , m_setting(setting)
+    , m_free_queue(setting.chunk_num > 0 ? setting.chunk_num : 1)
+    , m_input_queue(setting.chunk_num > 0 ? setting.chunk_num : 1)
+    , m_total_chunk_num(-1)
+    , m_max_input_queue_depth(0)
+    , m_max_output_queue_depth(0)
+    , m_is_aborted(false)
+    , m_is_run(false)
+{
+    if (setting.worker_num <= 0 || setting.chunk_size == 0 || setting.chunk_num <= 0) {
+        throw std::invalid_argument("Invalid pipeline setting");
+    }
+    m_output_slot.reset(new std::atomic<Chunk*>[setting.chunk_num]);
+    for (int32_t i = 0; i < setting.chunk_num; i++) {
+        m_chunk_list.emplace_back(new Chunk());
+        m_output_slot[i].store(nullptr, std::memory_order_relaxed);
+        m_free_queue.TryPush(m_chunk_list.back().get());
+    }
+}
+
+ConversionPipeline::~ConversionPipeline()
+{
+}
+
+/* Try is_ready a few times, then sleep until a notification makes it true.
+ * A notifier changes the state before it reads waiter_num, and a waiter increments waiter_num before it checks the state (with fences
+ * between them), so that either the waiter sees the new state or the notifier sees the waiter. The notifier locks the mutex before notifying,
+ * so that the notification doesn't come between the check and the sleep */
+template<typename PREDICATE>
+void ConversionPipeline::Wait(Event& event, PREDICATE is_ready)
+{
+    for (int32_t spin = 0; spin < SPIN_NUM; spin++) {
+        if (is_ready()) return;
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(event.mutex);
+    event.waiter_num.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!is_ready()) event.condition.wait(lock);
+    event.waiter_num.fetch_sub(1);
+}
+
+void ConversionPipeline::Notify(Event& event, bool is_all)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (event.waiter_num.load(std::memory_order_relaxed) == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(event.mutex);
+    }
+    if (is_all) {
+        event.condition.notify_all();
+    } else {
+        event.condition.notify_one();
+    }
+}
+
+int64_t ConversionPipeline::Run(const ReadFunc& read_func, const WriteFunc& write_func)
+{
+    if (m_is_run) throw std::logic_error("ConversionPipeline::Run can be called only once");
+    m_is_run = true;
+
+    std::vector<std::thread> thread_list;
+    try {
+        thread_list.emplace_back([this, &write_func]() { WriterLoop(write_func); });
+        for (int32_t i = 0; i < m_setting.worker_num; i++) {
+            thread_list.emplace_back([this]() { ConverterLoop(); });
+        }
+        ReaderLoop(read_func);
+    } catch (...) {
+        Abort(std::current_exception());
+    }
+    for (auto& thread : thread_list) thread.join();
+
+    if (m_exception) std::rethrow_exception(m_exception);
+    return m_writer_counter.record_num.load();
+}
+
+void ConversionPipeline::ReaderLoop(const ReadFunc& read_func)
+{
+    const size_t chunk_size = m_setting.chunk_size;
+    std::vector<char> carry;    /* incomplete record at the end of the previous chunk */
+    int64_t sequence = 0;
+    for (bool is_eof = false; !is_eof; ) {
+        Chunk* chunk = nullptr;
+        const int64_t wait_start = GetTimeNs();
+        Wait(m_free_event, [this, &chunk]() { return m_free_queue.TryPop(chunk) || IsAborted(); });
+        if (IsAborted()) return;
+        const int64_t busy_start = GetTimeNs();
+        m_reader_counter.wait_ns += busy_start - wait_start;
+
+        /* Read until the chunk is full, or until it has a complete record and the input has no more bytes for now (a short read).
+         * The last line of the input may not have a new line */
+        std::vector<char>& input = chunk->input;
+        input.assign(carry.begin(), carry.end());
+        size_t chunk_end = 0;
+        for (;;) {
+            const size_t size = input.size();
+            const size_t read_size = (size < chunk_size) ? chunk_size - size : chunk_size;     /* a record longer than a chunk */
+            input.resize(size + read_size);
+            const size_t read_byte = read_func(input.data() + size, read_size);
+            input.resize(size + read_byte);
+            m_reader_counter.byte_num += read_byte;
+            if (read_byte == 0) {
+                is_eof = true;
+                chunk_end = input.size();
+                break;
+            }
+            chunk_end = m_converter.FindChunkEnd(input.data(), input.size());
+            if (chunk_end > 0 && (input.size() >= chunk_size || read_byte < read_size)) break;
+        }
+        carry.assign(input.begin() + chunk_end, input.end());
+        input.resize(chunk_end);
+
+        /* An empty chunk at the end is not used any more */
+        if (!input.empty()) {
+            chunk->sequence = sequence++;
+            m_input_queue.TryPush(chunk);   /* never full because all the chunks fit in it */
+            Notify(m_input_event, false);
+            m_reader_counter.chunk_num++;
+            UpdateMax(m_max_input_queue_depth, static_cast<int32_t>(m_input_queue.GetSize()));
+        }
+        m_reader_counter.busy_ns += GetTimeNs() - busy_start;
+    }
+    m_total_chunk_num.store(sequence, std::memory_order_release);
+    m_input_queue.Close();
+    Notify(m_input_event, true);
+    Notify(m_output_event, true);
+}
+
+void ConversionPipeline::ConverterLoop()
+{
+    try {
+        for (;;) {
+            Chunk* chunk = nullptr;
+            bool is_end = false;
+            const int64_t wait_start = GetTimeNs();
+            Wait(m_input_event, [this, &chunk, &is_end]() {
+                if (m_input_queue.TryPop(chunk)) return true;
+                /* Values pushed before Close are still in the queue */
+                is_end = (m_input_queue.IsClosed() && !m_input_queue.TryPop(chunk)) || IsAborted();
+                return is_end || (chunk != nullptr);
+            });
+            const int64_t busy_start = GetTimeNs();
+            m_converter_counter.wait_ns += busy_start - wait_start;
+            if (is_end) return;
+
+            chunk->output.clear();
+            chunk->record_num = m_converter.ConvertChunk(chunk->input.data(), chunk->input.size(), chunk->output, chunk->sequence == 0);
+            m_converter_counter.chunk_num++;
+            m_converter_counter.byte_num += chunk->output.size();
+            m_converter_counter.record_num += chunk->record_num;
+            m_output_slot[chunk->sequence % m_setting.chunk_num].store(chunk, std::memory_order_release);
+            Notify(m_output_event, true);
+            UpdateMax(m_max_output_queue_depth, static_cast<int32_t>(m_converter_counter.chunk_num.load() - m_writer_counter.chunk_num.load()));
+            m_converter_counter.busy_ns += GetTimeNs() - busy_start;
+        }
+    } catch (...) {
+        Abort(std::current_exception());
+    }
+}
+
+void ConversionPipeline::WriterLoop(const WriteFunc& write_func)
+{
+    try {
+        for (int64_t sequence = 0; ; sequence++) {
+            std::atomic<Chunk*>& slot = m_output_slot[sequence % m_setting.chunk_num];
+            Chunk* chunk = nullptr;
+            bool is_end = false;
+            const int64_t wait_start = GetTimeNs();
+            Wait(m_output_event, [this, &slot, &chunk, &is_end, sequence]() {
+                chunk = slot.load(std::memory_order_acquire);
+                if (chunk) return true;
+                const int64_t total_chunk_num = m_total_chunk_num.load(std::memory_order_acquire);
+                is_end = (total_chunk_num >= 0 && sequence >= total_chunk_num) || IsAborted();
+                return is_end;
+            });
+            const int64_t busy_start = GetTimeNs();
+            m_writer_counter.wait_ns += busy_start - wait_start;
+            if (is_end) return;
+
+            slot.store(nullptr, std::memory_order_relaxed);
+            write_func(chunk->output, chunk->record_num);
+            m_writer_counter.chunk_num++;
+            m_writer_counter.byte_num += chunk->output.size();
+            m_writer_counter.record_num += chunk->record_num;
+            m_free_queue.TryPush(chunk);    /* never full because all the chunks fit in it */
+            Notify(m_free_event, false);
+            m_writer_counter.busy_ns += GetTimeNs() - busy_start;
+        }
+    } catch (...) {
+        Abort(std::current_exception());
+    }
+}
+
+/* Keep the first exception and stop all the stages */
+void ConversionPipeline::Abort(std::exception_ptr exception)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_exception_mutex);
+        if (!m_exception) m_exception = exception;
+        m_is_aborted.store(true, std::memory_order_release);
+    }
+    Notify(m_free_event, true);
+    Notify(m_input_event, true);
+    Notify(m_output_event, true);
+}
+
+void ConversionPipeline::UpdateMax(std::atomic<int32_t>& max_value, int32_t value)
+{
+    int32_t current = max_value.load(std::memory_order_relaxed);
+    while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+ConversionPipeline::StageStatistics ConversionPipeline::GetStageStatistics(const StageCounter& counter)
+{
+    StageStatistics statistics;
+    statistics.chunk_num = counter.chunk_num.load();
+    statistics.byte_num = counter.byte_num.load();
+    statistics.record_num = counter.record_num.load();
+    statistics.busy_time = counter.busy_ns.load() * 1e-9;
+    statistics.wait_time = counter.wait_ns.load() * 1e-9;
+    return statistics;
+}
+
+ConversionPipeline::Statistics ConversionPipeline::GetStatistics() const
+{
+    Statistics statistics;
+    statistics.reader = GetStageStatistics(m_reader_counter);
+    statistics.converter = GetStageStatistics(m_converter_counter);
+    statistics.writer = GetStageStatistics(m_writer_counter);
+    statistics.input_queue_depth = static_cast<int32_t>(m_input_queue.GetSize());
+    statistics.output_queue_depth = static_cast<int32_t>(statistics.converter.chunk_num - statistics.writer.chunk_num);
+    statistics.max_input_queue_depth = m_max_input_queue_depth.load();
+    statistics.max_output_queue_depth = m_max_output_queue_depth.load();
+    return statistics;
+}
@@ -0,0 +1,153 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef CONVERSION_PIPELINE_H
+#define CONVERSION_PIPELINE_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "batch_converter.h"
+#include "spmc_queue.h"
+
+/*
+ * Streaming conversion in three pipelined stages:
+ *   reader (the thread calling Run): reads the input and cuts it into chunks at the ends of records. A chunk is passed on when it's full,
+ *                                    or as soon as the input has no more bytes for now, so that records arriving slowly are not delayed
+ *   converters (worker threads): convert chunks by BatchConverter (parse, RotationMatrix batch functions and format)
+ *   writer (a thread): writes the converted chunks in the order of the input
+ * A fixed number of chunks circulate: free chunks -> reader -> input queue -> converters -> reorder slots -> writer -> free chunks.
+ * The queues are lock-free SpmcQueue. A stage waits when its queue is empty or no chunk is free (spins a little, then sleeps until the
+ * other stage notifies it), so that memory is bounded, a slow stage holds back the stages before it, and idle threads don't use the CPU.
+ * The statistics tell the bottleneck: the stage with the least wait time.
+ */
+class ConversionPipeline
+{
+public:
+    struct Setting {
+        int32_t worker_num;     /* converter threads */
+        size_t chunk_size;      /* max bytes of input in a chunk (a chunk is longer if a record is longer than it) */
+        int32_t chunk_num;      /* chunks in flight. More than worker_num so that the reader and the writer don't stall the workers */
+    };
+
+    struct StageStatistics {
+        int64_t chunk_num;
+        int64_t byte_num;       /* reader: input, converter and writer: output */
+        int64_t record_num;     /* converter and writer */
+        double busy_time;       /* sec, total of the threads of the stage (the reader: including waiting for the input) */
+        double wait_time;       /* sec, waiting for the previous stage (the reader: for a free chunk). Mostly sleeping */
+    };
+
+    struct Statistics {
+        StageStatistics reader;
+        StageStatistics converter;
+        StageStatistics writer;
+        int32_t input_queue_depth;          /* chunks waiting for a converter */
+        int32_t output_queue_depth;         /* converted chunks waiting for the writer */
+        int32_t max_input_queue_depth;
+        int32_t max_output_queue_depth;
+    };
+
+    /* Return bytes read into buffer (up to size). Like read(2), return what is available without waiting for size bytes.
+     * 0 at the end of the input */
+    using ReadFunc = std::function<size_t(char* buffer, size_t size)>;
+    /* Called in the order of the input */
+    using WriteFunc = std::function<void(const std::string& data, int64_t record_num)>;
+
+public:
+    /* converter must outlive the pipeline. Throw std::invalid_argument for invalid setting */
+    ConversionPipeline(const BatchConverter& converter, const Setting& setting);
+    ~ConversionPipeline();
+
+    /* Convert all the input and return the number of records. An exception thrown in any stage stops the pipeline and is re-thrown here.
+     * Call only once */
+    int64_t Run(const ReadFunc& read_func, const WriteFunc& write_func);
+
+    /* Can be called from another thread while running */
+    Statistics GetStatistics() const;
+
+private:
+    ConversionPipeline();
+    ConversionPipeline(const ConversionPipeline&) = delete;
+    ConversionPipeline& operator=(const ConversionPipeline&) = delete;
+
+    struct Chunk {
+        int64_t sequence;
+        std::vector<char> input;
+        std::string output;
+        int64_t record_num;
+    };
+
+    /* Sleeping threads waiting for a condition. waiter_num lets the notifier skip the mutex when nobody sleeps */
+    struct Event {
+        Event() : waiter_num(0) {}
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::atomic<int32_t> waiter_num;
+    };
+
+    struct StageCounter {
+        StageCounter() : chunk_num(0), byte_num(0), record_num(0), busy_ns(0), wait_ns(0) {}
+        std::atomic<int64_t> chunk_num;
+        std::atomic<int64_t> byte_num;
+        std::atomic<int64_t> record_num;
+        std::atomic<int64_t> busy_ns;
+        std::atomic<int64_t> wait_ns;
+    };
+
+    void ReaderLoop(const ReadFunc& read_func);
+    void ConverterLoop();
+    void WriterLoop(const WriteFunc& write_func);
+    void Abort(std::exception_ptr exception);
+    template<typename PREDICATE>
+    static void Wait(Event& event, PREDICATE is_ready);
+    static void Notify(Event& event, bool is_all);
+    bool IsAborted() const { return m_is_aborted.load(std::memory_order_acquire); }
+    static StageStatistics GetStageStatistics(const StageCounter& counter);
+    static void UpdateMax(std::atomic<int32_t>& max_value, int32_t value);
+
+private:
+    const BatchConverter& m_converter;
+    Setting m_setting;
+    std::vector<std::unique_ptr<Chunk>> m_chunk_list;
+    SpmcQueue<Chunk*> m_free_queue;                         /* writer -> reader */
+    SpmcQueue<Chunk*> m_input_queue;                        /* reader -> converters */
+    std::unique_ptr<std::atomic<Chunk*>[]> m_output_slot;   /* converters -> writer. Chunk i is at i % chunk_num, so that the writer takes them in order */
+    std::atomic<int64_t> m_total_chunk_num;                 /* -1 until the reader reaches the end of the input */
+    Event m_free_event;                                     /* the reader waits for a free chunk */
+    Event m_input_event;                                    /* converters wait for a chunk in the input queue */
+    Event m_output_event;                                   /* the writer waits for the next chunk */
+
+    StageCounter m_reader_counter;
+    StageCounter m_converter_counter;
+    StageCounter m_writer_counter;
+    std::atomic<int32_t> m_max_input_queue_depth;
+    std::atomic<int32_t> m_max_output_queue_depth;
+
+    std::atomic<bool> m_is_aborted;
+    bool m_is_run;
+    std::mutex m_exception_mutex;
+    std::exception_ptr m_exception;
+};
+
+#endif
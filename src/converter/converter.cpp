@@ -0,0 +1,207 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "container.h"
+#include "converter.h"
+
+/*** Macro ***/
+
+/*** Global variable ***/
+/* Indexed by REPRESENTATION_TYPE */
+static const char* REPRESENTATION_NAME[] = {
+    "matrix",
+    "rotation_vector",
+    "axis_angle",
+    "quaternion",
+    "euler_mobile",
+    "euler_fixed",
+};
+
+static constexpr int32_t COMPONENT_NUM[] = { 9, 3, 4, 4, 3, 3 };
+
+static const char* COMPONENT_NAME[][9] = {
+    { "r00", "r01", "r02", "r10", "r11", "r12", "r20", "r21", "r22" },
+    { "vx", "vy", "vz" },
+    { "ax", "ay", "az", "angle" },
+    { "qx", "qy", "qz", "qw" },
+    { "x", "y", "z" },
+    { "x", "y", "z" },
+};
+
+/* Indexed by RotationMatrix::EULER_ORDER */
+static const char* EULER_ORDER_NAME[] = { "XYZ", "XZY", "YXZ", "YZX", "ZXY", "ZYX" };
+
+/*** Function ***/
+int32_t Converter::GetComponentNum(REPRESENTATION_TYPE type)
+{
+    return COMPONENT_NUM[static_cast<int32_t>(type)];
+}
+
+const char* Converter::GetComponentName(REPRESENTATION_TYPE type, int32_t component)
+{
+    return COMPONENT_NAME[static_cast<int32_t>(type)][component];
+}
+
+Converter::Representation Converter::ParseRepresentation(const std::string& name)
+{
+    const size_t colon = name.find(':');
+    const std::string type_name = name.substr(0, colon);
+    Representation representation = { REPRESENTATION_TYPE::ROTATION_MATRIX, RotationMatrix::EULER_ORDER::XYZ };
+    const int32_t type_num = static_cast<int32_t>(sizeof(REPRESENTATION_NAME) / sizeof(REPRESENTATION_NAME[0]));
+    const auto type_it = std::find(REPRESENTATION_NAME, REPRESENTATION_NAME + type_num, type_name);
+    if (type_it == REPRESENTATION_NAME + type_num) {
+        throw std::invalid_argument("Unknown representation: " + name);
+    }
+    representation.type = static_cast<REPRESENTATION_TYPE>(type_it - REPRESENTATION_NAME);
+
+    if (colon != std::string::npos) {
+        const std::string order_name = name.substr(colon + 1);
+        const auto order_it = std::find(EULER_ORDER_NAME, EULER_ORDER_NAME + 6, order_name);
+        const bool is_euler = (representation.type == REPRESENTATION_TYPE::EULER_MOBILE) || (representation.type == REPRESENTATION_TYPE::EULER_FIXED);
+        if (!is_euler || order_it == EULER_ORDER_NAME + 6) {
+            throw std::invalid_argument("Invalid euler order: " + name);
+        }
+        representation.order = static_cast<RotationMatrix::EULER_ORDER>(order_it - EULER_ORDER_NAME);
+    }
+    return representation;
+}
+
+std::string Converter::GetRepresentationName(const Representation& representation)
+{
+    std::string name = REPRESENTATION_NAME[static_cast<int32_t>(representation.type)];
+    if ((representation.type == REPRESENTATION_TYPE::EULER_MOBILE) || (representation.type == REPRESENTATION_TYPE::EULER_FIXED)) {
+        name += std::string(":") + EULER_ORDER_NAME[static_cast<int32_t>(representation.order)];
+    }
+    return name;
+}
+
+void Converter::ConvertAll(InputContainer& input_container, OutputContainer& output_container, bool is_normalize_rotation_matrix)
+{
+    const REPRESENTATION_TYPE selected_type = static_cast<REPRESENTATION_TYPE>(input_container.selected_representation_type);
+    const uint32_t version = input_container.GetVersion(selected_type);
+    const bool is_normalized = is_normalize_rotation_matrix && (selected_type == REPRESENTATION_TYPE::ROTATION_MATRIX);
+    if (output_container.source_representation_type == input_container.selected_representation_type
+        && output_container.source_version == version && output_container.source_is_normalized == is_normalized) {
+        return;
+    }
+    output_container.source_representation_type = input_container.selected_representation_type;
+    output_container.source_version = version;
+    output_container.source_is_normalized = is_normalized;
+
+    /* First, Convert the selected input representation to rotatin matrix (mat3_rot) */
+    Matrix mat3_rot = Matrix::Identity(3);
+    switch (selected_type) {
+    case REPRESENTATION_TYPE::ROTATION_MATRIX:
+        for (int32_t i = 0; i < 9; i++) {
+            mat3_rot[i] = input_container.rotation_matrix[i];
+        }
+        if (is_normalized) {
+            const Mat3 mat3_rot_normalized = RotationMatrix::NormalizeRotationMatrix(mat3_rot.View());
+            for (int32_t i = 0; i < 9; i++) {
+                mat3_rot[i] = mat3_rot_normalized[i];
+            }
+        }
+        break;
+    case REPRESENTATION_TYPE::ROTATION_VECTOR:
+        mat3_rot = RotationMatrix::ConvertRotationVector2RotationMatrix(input_container.rotation_vector[0], input_container.rotation_vector[1], input_container.rotation_vector[2]);
+        break;
+    case REPRESENTATION_TYPE::AXIS_ANGLE:
+        mat3_rot = RotationMatrix::ConvertAxisAngle2RotationMatrix(input_container.axis_angle[0], input_container.axis_angle[1], input_container.axis_angle[2], input_container.axis_angle[3]);
+        break;
+    case REPRESENTATION_TYPE::QUATERNION:
+        mat3_rot = RotationMatrix::ConvertQuaternion2RotationMatrix(input_container.quaternion[0], input_container.quaternion[1], input_container.quaternion[2], input_container.quaternion[3]);
+        break;
+    case REPRESENTATION_TYPE::EULER_MOBILE:
+        mat3_rot = RotationMatrix::ConvertEulerMobile2RotationMatrix(static_cast<RotationMatrix::EULER_ORDER>(input_container.mobile_euler_order), input_container.mobile_euler_angle[0], input_container.mobile_euler_angle[1], input_container.mobile_euler_angle[2]);
+        break;
+    case REPRESENTATION_TYPE::EULER_FIXED:
+        mat3_rot = RotationMatrix::ConvertEulerFixed2RotationMatrix(static_cast<RotationMatrix::EULER_ORDER>(input_container.fixed_euler_order), input_container.fixed_euler_angle[0], input_container.fixed_euler_angle[1], input_container.fixed_euler_angle[2]);
+        break;
+    }
+
+    /* The other representations are converted when they are read */
+    output_container.SetRotationMatrix(mat3_rot);
+}
+
+void Converter::ConvertToRotationMatrices(const Representation& input, const float* planes, int32_t num, bool is_normalize_rotation_matrix, float* mat3_rot)
+{
+    ConvertToRotationMatrices(input, planes, num, num, is_normalize_rotation_matrix, mat3_rot);
+}
+
+void Converter::ConvertToRotationMatrices(const Representation& input, const float* planes, int32_t plane_stride, int32_t num, bool is_normalize_rotation_matrix, float* mat3_rot)
+{
+    const float* p[9];
+    for (int32_t c = 0; c < GetComponentNum(input.type); c++) p[c] = planes + static_cast<size_t>(c) * plane_stride;
+    switch (input.type) {
+    case REPRESENTATION_TYPE::ROTATION_MATRIX:
+        for (int32_t c = 0; c < 9; c++) {
+            std::copy(p[c], p[c] + num, mat3_rot + static_cast<size_t>(c) * num);
+        }
+        if (is_normalize_rotation_matrix) {
+            RotationMatrix::NormalizeRotationMatrices(mat3_rot, num);
+        }
+        break;
+    case REPRESENTATION_TYPE::ROTATION_VECTOR:
+        RotationMatrix::ConvertRotationVectors2RotationMatrices(p[0], p[1], p[2], num, mat3_rot);
+        break;
+    case REPRESENTATION_TYPE::AXIS_ANGLE:
+        RotationMatrix::ConvertAxisAngles2RotationMatrices(p[0], p[1], p[2], p[3], num, mat3_rot);
+        break;
+    case REPRESENTATION_TYPE::QUATERNION:
+        RotationMatrix::ConvertQuaternions2RotationMatrices(p[0], p[1], p[2], p[3], num, mat3_rot);
+        break;
+    case REPRESENTATION_TYPE::EULER_MOBILE:
+        RotationMatrix::ConvertEulerMobiles2RotationMatrices(input.order, p[0], p[1], p[2], num, mat3_rot);
+        break;
+    case REPRESENTATION_TYPE::EULER_FIXED:
+        RotationMatrix::ConvertEulerFixeds2RotationMatrices(input.order, p[0], p[1], p[2], num, mat3_rot);
+        break;
+    }
+}
+
+void Converter::ConvertFromRotationMatrices(const Representation& output, const float* mat3_rot, int32_t num, float* planes)
+{
+    float* p[9];
+    for (int32_t c = 0; c < GetComponentNum(output.type); c++) p[c] = planes + static_cast<size_t>(c) * num;
+    switch (output.type) {
+    case REPRESENTATION_TYPE::ROTATION_MATRIX:
+        std::copy(mat3_rot, mat3_rot + static_cast<size_t>(num) * 9, planes);
+        break;
+    case REPRESENTATION_TYPE::ROTATION_VECTOR:
+        RotationMatrix::ConvertRotationMatrices2RotationVectors(mat3_rot, num, p[0], p[1], p[2]);
+        break;
+    case REPRESENTATION_TYPE::AXIS_ANGLE:
+        RotationMatrix::ConvertRotationMatrices2AxisAngles(mat3_rot, num, p[0], p[1], p[2], p[3]);
+        break;
+    case REPRESENTATION_TYPE::QUATERNION:
+        RotationMatrix::ConvertRotationMatrices2Quaternions(mat3_rot, num, p[0], p[1], p[2], p[3]);
+        break;
+    case REPRESENTATION_TYPE::EULER_MOBILE:
+        RotationMatrix::ConvertRotationMatrices2EulerMobiles(output.order, mat3_rot, num, p[0], p[1], p[2]);
+        break;
+    case REPRESENTATION_TYPE::EULER_FIXED:
+        RotationMatrix::ConvertRotationMatrices2EulerFixeds(output.order, mat3_rot, num, p[0], p[1], p[2]);
+        break;
+    }
+}
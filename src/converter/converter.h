@@ -0,0 +1,60 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef CONVERTER_H
+#define CONVERTER_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "rotation_matrix.h"
+#include "container.h"
+
+/*
+ * Conversion between the representations of REPRESENTATION_TYPE, shared by the application and the batch tools (no OpenGL).
+ * The components of each representation are in the same order as InputContainer:
+ *   rotation matrix: 9 (row-major), rotation vector: x, y, z, axis-angle: x, y, z, angle, quaternion: x, y, z, w, euler angles: x, y, z (angles are radian)
+ */
+namespace Converter
+{
+    /* A representation with the order of euler angles (the order is not used by the other types) */
+    struct Representation {
+        REPRESENTATION_TYPE type;
+        RotationMatrix::EULER_ORDER order;
+    };
+
+    int32_t GetComponentNum(REPRESENTATION_TYPE type);
+
+    /* name[:order] (e.g. "quaternion", "euler_mobile:ZYX"). The order is XYZ if omitted. Throw std::invalid_argument for an unknown name */
+    Representation ParseRepresentation(const std::string& name);
+    std::string GetRepresentationName(const Representation& representation);
+    /* Names of the components for a header (e.g. "qx") */
+    const char* GetComponentName(REPRESENTATION_TYPE type, int32_t component);
+
+    /* Convert the selected input representation into the rotation matrix of the output container.
+     * Incremental: nothing is done if the selected input representation (and the normalization setting for a rotation matrix) is not changed since the last call.
+     * The output representations are converted from the rotation matrix on demand, and not again if it is the same (e.g. only the selection is changed) */
+    void ConvertAll(InputContainer& input_container, OutputContainer& output_container, bool is_normalize_rotation_matrix);
+
+    /* Batch versions for num rotations in structure-of-arrays layout: component c of the i-th rotation is planes[c * num + i].
+     * mat3_rot is the 9 planes of RotationMatrix batch functions */
+    void ConvertToRotationMatrices(const Representation& input, const float* planes, int32_t num, bool is_normalize_rotation_matrix, float* mat3_rot);
+    /* The same with component c of the i-th rotation at planes[c * plane_stride + i] (e.g. a block of a trajectory file, without copy) */
+    void ConvertToRotationMatrices(const Representation& input, const float* planes, int32_t plane_stride, int32_t num, bool is_normalize_rotation_matrix, float* mat3_rot);
+    void ConvertFromRotationMatrices(const Representation& output, const float* mat3_rot, int32_t num, float* planes);
+}
+
+#endif
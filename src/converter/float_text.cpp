@@ -0,0 +1,204 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+
+#include "float_text.h"
+
+/*** Macro ***/
+static constexpr int32_t MAX_SIGNIFICANT_DIGIT = 19;            /* digits which fit in uint64_t */
+static constexpr uint64_t MAX_EXACT_MANTISSA = 1ULL << 53;     /* integers exactly representable in double */
+static constexpr int32_t MAX_EXACT_EXPONENT = 22;               /* powers of 10 exactly representable in double */
+static constexpr int32_t MAX_PRECISION = 9;
+static constexpr double FIXED_NOTATION_LIMIT = 1e9;
+
+/*** Global variable ***/
+static constexpr double POW10[MAX_EXACT_EXPONENT + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static constexpr uint64_t POW10_INTEGER[MAX_PRECISION + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+};
+
+/* "00" "01" ... "99" */
+static const char DIGIT_PAIR[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*** Function ***/
+static inline bool IsDigit(char c)
+{
+    return static_cast<uint32_t>(c - '0') < 10;
+}
+
+/* Division by a constant is a multiplication, while division by a variable is one of the slowest instructions */
+template<int32_t PRECISION>
+static inline void Split(uint64_t scaled, uint64_t& integer, uint32_t& fraction)
+{
+    integer = scaled / POW10_INTEGER[PRECISION];
+    fraction = static_cast<uint32_t>(scaled % POW10_INTEGER[PRECISION]);
+}
+
+/* strtof needs a null-terminated string. Return first if nothing is parsed */
+static const char* ParseByStrtof(const char* first, const char* last, float& value)
+{
+    char buffer[128];
+    const size_t length = std::min(static_cast<size_t>(last - first), sizeof(buffer) - 1);
+    std::copy(first, first + length, buffer);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    const float result = std::strtof(buffer, &end);
+    if (end == buffer) return first;
+    value = result;
+    return first + (end - buffer);
+}
+
+const char* FloatText::Parse(const char* first, const char* last, float& value)
+{
+    const char* p = first;
+    const bool is_negative = (p < last) && (*p == '-');
+    if ((p < last) && (*p == '-' || *p == '+')) p++;
+
+    /* Significant digits go to the mantissa. Leading zeros are skipped, and the digits after MAX_SIGNIFICANT_DIGIT only move the exponent */
+    uint64_t mantissa = 0;
+    int32_t digit_num = 0;
+    int32_t exponent = 0;
+    bool has_digit = false;
+    bool is_truncated = false;
+    for (; (p < last) && IsDigit(*p); p++) {
+        has_digit = true;
+        const uint32_t digit = static_cast<uint32_t>(*p - '0');
+        if (digit_num < MAX_SIGNIFICANT_DIGIT) {
+            mantissa = mantissa * 10 + digit;
+            if (mantissa > 0) digit_num++;
+        } else {
+            exponent++;
+            is_truncated |= (digit != 0);
+        }
+    }
+    if ((p < last) && (*p == '.')) {
+        for (p++; (p < last) && IsDigit(*p); p++) {
+            has_digit = true;
+            const uint32_t digit = static_cast<uint32_t>(*p - '0');
+            if (digit_num < MAX_SIGNIFICANT_DIGIT) {
+                mantissa = mantissa * 10 + digit;
+                if (mantissa > 0) digit_num++;
+                exponent--;
+            } else {
+                is_truncated |= (digit != 0);
+            }
+        }
+    }
+    if (!has_digit) {
+        /* inf, nan or not a number (strtof would skip spaces) */
+        const bool is_word = (p < last) && (std::isalpha(static_cast<unsigned char>(*p)) != 0);
+        return is_word ? ParseByStrtof(first, last, value) : first;
+    }
+
+    /* The exponent part is a part of the number only if it has digits */
+    if ((p < last) && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        const bool is_negative_exponent = (q < last) && (*q == '-');
+        if ((q < last) && (*q == '-' || *q == '+')) q++;
+        if ((q < last) && IsDigit(*q)) {
+            int32_t exponent_value = 0;
+            for (; (q < last) && IsDigit(*q); q++) {
+                if (exponent_value < 100000) exponent_value = exponent_value * 10 + (*q - '0');
+            }
+            exponent += is_negative_exponent ? -exponent_value : exponent_value;
+            p = q;
+        }
+    }
+
+    if (mantissa == 0) {
+        value = is_negative ? -0.0f : 0.0f;
+        return p;
+    }
+    if (is_truncated || mantissa > MAX_EXACT_MANTISSA || exponent < -MAX_EXACT_EXPONENT || exponent > MAX_EXACT_EXPONENT) {
+        return ParseByStrtof(first, p, value);
+    }
+
+    /* Both the mantissa and the power of 10 are exact, so that the double is correctly rounded */
+    double result = static_cast<double>(mantissa);
+    result = (exponent < 0) ? result / POW10[-exponent] : result * POW10[exponent];
+    value = static_cast<float>(is_negative ? -result : result);
+    return p;
+}
+
+char* FloatText::Format(float value, int32_t precision, char* buffer)
+{
+    const double v = value;
+    if (!(std::abs(v) < FIXED_NOTATION_LIMIT)) {
+        const int32_t length = std::snprintf(buffer, FORMAT_MAX_LENGTH, "%.9g", v);
+        return buffer + length;
+    }
+    precision = std::max(0, std::min(precision, MAX_PRECISION));
+
+    /* |value| * 10^precision < 1e18 fits in uint64_t */
+    const uint64_t scaled = static_cast<uint64_t>(std::abs(v) * POW10[precision] + 0.5);
+    char* p = buffer;
+    if (std::signbit(value) && scaled != 0) *p++ = '-';
+
+    uint64_t integer;
+    uint32_t fraction;
+    switch (precision) {
+    case 0: Split<0>(scaled, integer, fraction); break;
+    case 1: Split<1>(scaled, integer, fraction); break;
+    case 2: Split<2>(scaled, integer, fraction); break;
+    case 3: Split<3>(scaled, integer, fraction); break;
+    case 4: Split<4>(scaled, integer, fraction); break;
+    case 5: Split<5>(scaled, integer, fraction); break;
+    case 6: Split<6>(scaled, integer, fraction); break;
+    case 7: Split<7>(scaled, integer, fraction); break;
+    case 8: Split<8>(scaled, integer, fraction); break;
+    default: Split<9>(scaled, integer, fraction); break;
+    }
+    char digits[20];
+    char* d = digits + sizeof(digits);
+    for (; integer >= 100; integer /= 100) {
+        d -= 2;
+        std::memcpy(d, &DIGIT_PAIR[(integer % 100) * 2], 2);
+    }
+    if (integer >= 10) {
+        d -= 2;
+        std::memcpy(d, &DIGIT_PAIR[integer * 2], 2);
+    } else {
+        *--d = static_cast<char>('0' + integer);
+    }
+    const size_t integer_length = digits + sizeof(digits) - d;
+    std::memcpy(p, d, integer_length);
+    p += integer_length;
+
+    if (precision > 0) {
+        *p++ = '.';
+        int32_t i = precision;
+        for (; i >= 2; i -= 2) {
+            std::memcpy(p + i - 2, &DIGIT_PAIR[(fraction % 100) * 2], 2);
+            fraction /= 100;
+        }
+        if (i == 1) p[0] = static_cast<char>('0' + fraction);
+        p += precision;
+    }
+    return p;
+}
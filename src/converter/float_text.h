@@ -0,0 +1,40 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef FLOAT_TEXT_H
+#define FLOAT_TEXT_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Locale-independent float <-> text conversion for large text files, in the manner of std::from_chars / std::to_chars (which are not in C++14).
+ * Parse handles [+-]digits[.digits][(e|E)[+-]digits] with up to 19 significant digits and a decimal exponent within +-22 in double precision
+ * (then rounded to float). Other numbers (and inf / nan) fall back to strtof.
+ */
+namespace FloatText
+{
+    /* The longest text of Format */
+    static constexpr int32_t FORMAT_MAX_LENGTH = 48;
+
+    /* Parse a number at [first, last) without skipping spaces. Return the end of the number, or first if it is not a number */
+    const char* Parse(const char* first, const char* last, float& value);
+
+    /* Write value in fixed notation with precision (0 - 9) digits after the decimal point (without the terminating null).
+     * Values too large for it (|value| >= 1e9) and inf / nan are written by "%.9g". Return the end */
+    char* Format(float value, int32_t precision, char* buffer);
+}
+
+#endif
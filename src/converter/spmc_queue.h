@@ -0,0 +1,120 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef SPMC_QUEUE_H
+#define SPMC_QUEUE_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+
+/*
+ * Bounded lock-free ring buffer for a single producer and multiple consumers.
+ * Each slot has a sequence number: the producer writes a slot when its sequence is the push position (the slot is free), and a consumer
+ * takes the slot by CAS on the head when its sequence is the push position + 1 (the slot is filled). Nothing blocks: TryPush fails when
+ * the queue is full (backpressure to the producer) and TryPop fails when it's empty.
+ * Close tells consumers that nothing is pushed any more. The values in the queue can still be popped.
+ */
+template<typename T>
+class SpmcQueue
+{
+public:
+    /* capacity is rounded up to a power of 2 */
+    explicit SpmcQueue(size_t capacity)
+        : m_capacity(RoundUpPowerOf2(capacity)), m_mask(m_capacity - 1), m_slot(new Slot[m_capacity]), m_head(0), m_tail(0), m_is_closed(false)
+    {
+        for (size_t i = 0; i < m_capacity; i++) m_slot[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    ~SpmcQueue() {}
+
+    /* Call only from the producer */
+    bool TryPush(const T& value)
+    {
+        const size_t position = m_tail.load(std::memory_order_relaxed);
+        Slot& slot = m_slot[position & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position) return false;    /* full */
+        slot.value = value;
+        slot.sequence.store(position + 1, std::memory_order_release);
+        m_tail.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool TryPop(T& value)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slot[position & m_mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(position + m_capacity, std::memory_order_release);     /* free for the next round */
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   /* empty */
+            } else {
+                position = m_head.load(std::memory_order_relaxed);      /* taken by another consumer */
+            }
+        }
+    }
+
+    /* Call only from the producer, after the last push */
+    void Close() { m_is_closed.store(true, std::memory_order_release); }
+    bool IsClosed() const { return m_is_closed.load(std::memory_order_acquire); }
+
+    size_t GetCapacity() const { return m_capacity; }
+    /* Approximate while other threads push or pop */
+    size_t GetSize() const
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        return (tail > head) ? tail - head : 0;
+    }
+
+private:
+    SpmcQueue();
+    SpmcQueue(const SpmcQueue&) = delete;
+    SpmcQueue& operator=(const SpmcQueue&) = delete;
+
+    static size_t RoundUpPowerOf2(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slot;
+    /* The head (consumers) and the tail (producer) are on different cache lines, so that they don't invalidate each other */
+    char m_padding0[CACHE_LINE_SIZE];
+    std::atomic<size_t> m_head;
+    char m_padding1[CACHE_LINE_SIZE];
+    std::atomic<size_t> m_tail;
+    char m_padding2[CACHE_LINE_SIZE];
+    std::atomic<bool> m_is_closed;
+};
+
+#endif
@@ -0,0 +1,432 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "converter.h"
+#include "trajectory_file.h"
+
+/*** Macro ***/
+static constexpr char MAGIC[8] = { 'R', 'O', 'T', 'T', 'R', 'A', 'J', '\0' };
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+static constexpr uint32_t FORMAT_VERSION = 1;
+static constexpr uint32_t FLAG_TIMESTAMP = 1 << 0;
+static constexpr int32_t EULER_ORDER_NUM = 6;
+
+/*** Global variable ***/
+
+/*** Function ***/
+struct Header {
+    char magic[8];
+    uint32_t byte_order;            /* BYTE_ORDER_MARK in the byte order of the writer */
+    uint32_t version;
+    uint32_t header_size;           /* offset of block 0 */
+    int32_t representation_type;
+    int32_t euler_order;
+    int32_t component_num;
+    uint32_t flags;
+    int32_t block_capacity;         /* records in a block (plane stride) */
+    int64_t block_size;             /* bytes */
+    int64_t count;                  /* committed records */
+    uint8_t reserved[72];
+};
+static_assert(sizeof(Header) == 128, "The header is a multiple of 64 bytes so that the columns are aligned");
+
+static int64_t CalculateBlockSize(int32_t component_num, bool has_timestamp, int32_t block_capacity)
+{
+    return static_cast<int64_t>(block_capacity) * (sizeof(float) * component_num + (has_timestamp ? sizeof(int64_t) : 0));
+}
+
+static void ValidateHeader(const Header& header)
+{
+    const char* error = nullptr;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not a trajectory file";
+    } else if (header.byte_order != BYTE_ORDER_MARK) {
+        error = "different byte order";
+    } else if (header.version != FORMAT_VERSION || header.header_size != sizeof(Header)) {
+        error = "unsupported version";
+    } else if (header.representation_type < 0 || header.representation_type >= REPRESENTATION_TYPE_NUM
+        || header.euler_order < 0 || header.euler_order >= EULER_ORDER_NUM
+        || header.component_num != Converter::GetComponentNum(static_cast<REPRESENTATION_TYPE>(header.representation_type))) {
+        error = "invalid representation";
+    } else if (header.block_capacity <= 0 || header.block_capacity % TrajectoryFile::BLOCK_CAPACITY_UNIT != 0
+        || header.block_size != CalculateBlockSize(header.component_num, (header.flags & FLAG_TIMESTAMP) != 0, header.block_capacity)
+        || header.count < 0) {
+        error = "invalid block";
+    }
+    if (error) throw std::runtime_error(std::string("Invalid trajectory file: ") + error);
+}
+
+static void Seek(FILE* fp, int64_t offset)
+{
+#ifdef _WIN32
+    const int32_t ret = _fseeki64(fp, offset, SEEK_SET);
+#else
+    const int32_t ret = fseeko(fp, static_cast<off_t>(offset), SEEK_SET);
+#endif
+    if (ret != 0) throw std::runtime_error("Failed to seek trajectory file");
+}
+
+static void ReadAt(FILE* fp, int64_t offset, void* data, size_t size)
+{
+    Seek(fp, offset);
+    if (fread(data, 1, size, fp) != size) throw std::runtime_error("Failed to read trajectory file");
+}
+
+static void WriteAt(FILE* fp, int64_t offset, const void* data, size_t size)
+{
+    Seek(fp, offset);
+    if (fwrite(data, 1, size, fp) != size) throw std::runtime_error("Failed to write trajectory file");
+}
+
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path, const Converter::Representation& representation, bool has_timestamp, int32_t block_capacity)
+    : m_fp(nullptr)
+{
+    if (block_capacity <= 0 || block_capacity % TrajectoryFile::BLOCK_CAPACITY_UNIT != 0) {
+        throw std::invalid_argument("Block capacity must be a multiple of " + std::to_string(TrajectoryFile::BLOCK_CAPACITY_UNIT));
+    }
+    m_representation = representation;
+    m_has_timestamp = has_timestamp;
+    m_component_num = Converter::GetComponentNum(representation.type);
+    m_block_capacity = block_capacity;
+    m_block_size = CalculateBlockSize(m_component_num, has_timestamp, block_capacity);
+    m_count = 0;
+    m_committed_count = 0;
+    m_written_count = 0;
+    m_last_timestamp = std::numeric_limits<int64_t>::min();
+    m_block_value.resize(static_cast<size_t>(m_component_num) * block_capacity);
+    m_block_timestamp.resize(has_timestamp ? block_capacity : 0);
+
+    Open(path, "w+b");
+    try {
+        WriteHeader();
+    } catch (...) {
+        fclose(m_fp);
+        throw;
+    }
+}
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path)
+    : m_fp(nullptr)
+{
+    Open(path, "r+b");
+    try {
+        Load();
+    } catch (...) {
+        fclose(m_fp);
+        throw;
+    }
+}
+
+void TrajectoryWriter::WriteHeader()
+{
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.version = FORMAT_VERSION;
+    header.header_size = sizeof(Header);
+    header.representation_type = static_cast<int32_t>(m_representation.type);
+    header.euler_order = static_cast<int32_t>(m_representation.order);
+    header.component_num = m_component_num;
+    header.flags = m_has_timestamp ? FLAG_TIMESTAMP : 0;
+    header.block_capacity = m_block_capacity;
+    header.block_size = m_block_size;
+    header.count = 0;
+    WriteAt(m_fp, 0, &header, sizeof(header));
+    Sync();
+}
+
+void TrajectoryWriter::Load()
+{
+    Header header;
+    ReadAt(m_fp, 0, &header, sizeof(header));
+    ValidateHeader(header);
+    m_representation.type = static_cast<REPRESENTATION_TYPE>(header.representation_type);
+    m_representation.order = static_cast<RotationMatrix::EULER_ORDER>(header.euler_order);
+    m_has_timestamp = (header.flags & FLAG_TIMESTAMP) != 0;
+    m_component_num = header.component_num;
+    m_block_capacity = header.block_capacity;
+    m_block_size = header.block_size;
+    m_count = header.count;
+    m_committed_count = header.count;
+    m_written_count = header.count;
+    m_last_timestamp = std::numeric_limits<int64_t>::min();
+    m_block_value.resize(static_cast<size_t>(m_component_num) * m_block_capacity);
+    m_block_timestamp.resize(m_has_timestamp ? m_block_capacity : 0);
+
+    /* Load the last block if it is not full. Records after the count (not committed before a crash) are discarded */
+    const int64_t block_offset = sizeof(Header) + (m_count / m_block_capacity) * m_block_size;
+    const int32_t record_num = static_cast<int32_t>(m_count % m_block_capacity);
+    if (record_num > 0) {
+        for (int32_t c = 0; c < m_component_num; c++) {
+            ReadAt(m_fp, block_offset + static_cast<int64_t>(sizeof(float)) * c * m_block_capacity, &m_block_value[static_cast<size_t>(c) * m_block_capacity], sizeof(float) * record_num);
+        }
+    }
+    if (m_has_timestamp && m_count > 0) {
+        const int64_t last = m_count - 1;
+        const int64_t timestamp_offset = sizeof(Header) + (last / m_block_capacity) * m_block_size + static_cast<int64_t>(sizeof(float)) * m_component_num * m_block_capacity;
+        if (record_num > 0) {
+            ReadAt(m_fp, timestamp_offset, m_block_timestamp.data(), sizeof(int64_t) * record_num);
+            m_last_timestamp = m_block_timestamp[record_num - 1];
+        } else {
+            ReadAt(m_fp, timestamp_offset + static_cast<int64_t>(sizeof(int64_t)) * (last % m_block_capacity), &m_last_timestamp, sizeof(int64_t));
+        }
+    }
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    if (m_fp) {
+        try {
+            Commit();
+        } catch (...) {
+        }
+        fclose(m_fp);
+    }
+}
+
+void TrajectoryWriter::Open(const std::string& path, const char* mode)
+{
+    m_fp = fopen(path.c_str(), mode);
+    if (!m_fp) throw std::runtime_error("Failed to open " + path);
+}
+
+void TrajectoryWriter::Append(const float* record, int64_t timestamp)
+{
+    const int32_t i = static_cast<int32_t>(m_count % m_block_capacity);
+    if (m_has_timestamp) {
+        if (timestamp < m_last_timestamp) throw std::invalid_argument("Timestamp must be non-decreasing");
+        m_block_timestamp[i] = timestamp;
+        m_last_timestamp = timestamp;
+    }
+    for (int32_t c = 0; c < m_component_num; c++) {
+        m_block_value[static_cast<size_t>(c) * m_block_capacity + i] = record[c];
+    }
+    m_count++;
+    if (i == m_block_capacity - 1) WriteBlock();
+}
+
+void TrajectoryWriter::AppendRecords(const float* record_list, int64_t num, const int64_t* timestamp_list)
+{
+    if (m_has_timestamp && num > 0) {
+        if (!timestamp_list) throw std::invalid_argument("No timestamp");
+        /* Check all the timestamps first, so that nothing is appended if any of them is invalid */
+        int64_t last_timestamp = m_last_timestamp;
+        for (int64_t i = 0; i < num; i++) {
+            if (timestamp_list[i] < last_timestamp) throw std::invalid_argument("Timestamp must be non-decreasing");
+            last_timestamp = timestamp_list[i];
+        }
+    }
+    for (int64_t i = 0; i < num; i++) {
+        Append(record_list + i * m_component_num, timestamp_list ? timestamp_list[i] : 0);
+    }
+}
+
+void TrajectoryWriter::Commit()
+{
+    WriteBlock();
+    if (m_committed_count == m_count) return;
+    /* The count is updated only after the data reaches the storage */
+    Sync();
+    WriteCount(m_count);
+    Sync();
+    m_committed_count = m_count;
+}
+
+/* Write the block of the buffered records (the whole block including unused records, so that the file always has complete blocks) */
+void TrajectoryWriter::WriteBlock()
+{
+    if (m_written_count == m_count) return;
+    const int64_t block = (m_count - 1) / m_block_capacity;
+    const int64_t block_offset = sizeof(Header) + block * m_block_size;
+    WriteAt(m_fp, block_offset, m_block_value.data(), sizeof(float) * m_block_value.size());
+    if (m_has_timestamp) {
+        if (fwrite(m_block_timestamp.data(), sizeof(int64_t), m_block_timestamp.size(), m_fp) != m_block_timestamp.size()) {
+            throw std::runtime_error("Failed to write trajectory file");
+        }
+    }
+    m_written_count = m_count;
+}
+
+/* The count is 8 bytes within a sector, so that it is written atomically */
+void TrajectoryWriter::WriteCount(int64_t count)
+{
+    WriteAt(m_fp, offsetof(Header, count), &count, sizeof(count));
+}
+
+void TrajectoryWriter::Sync()
+{
+    if (fflush(m_fp) != 0) throw std::runtime_error("Failed to write trajectory file");
+#ifdef _WIN32
+    const int32_t ret = _commit(_fileno(m_fp));
+#else
+    const int32_t ret = fsync(fileno(m_fp));
+#endif
+    if (ret != 0) throw std::runtime_error("Failed to sync trajectory file");
+}
+
+
+TrajectoryReader::TrajectoryReader(const std::string& path)
+    : m_data(nullptr), m_mapped_size(0)
+{
+#ifdef _WIN32
+    m_file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file_handle == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open " + path);
+    LARGE_INTEGER file_size;
+    m_mapping_handle = nullptr;
+    if (GetFileSizeEx(m_file_handle, &file_size) && file_size.QuadPart >= static_cast<LONGLONG>(sizeof(Header))) {
+        m_mapping_handle = CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (m_mapping_handle) {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        m_mapped_size = static_cast<size_t>(file_size.QuadPart);
+    }
+    if (!m_data) {
+        if (m_mapping_handle) CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+        throw std::runtime_error("Failed to map " + path);
+    }
+#else
+    const int32_t fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Failed to open " + path);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size >= static_cast<off_t>(sizeof(Header))) {
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const char*>(data);
+            m_mapped_size = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+    close(fd);      /* the mapping is kept */
+    if (!m_data) throw std::runtime_error("Failed to map " + path);
+#endif
+
+    try {
+        Header header;
+        std::memcpy(&header, m_data, sizeof(header));
+        ValidateHeader(header);
+        m_representation.type = static_cast<REPRESENTATION_TYPE>(header.representation_type);
+        m_representation.order = static_cast<RotationMatrix::EULER_ORDER>(header.euler_order);
+        m_has_timestamp = (header.flags & FLAG_TIMESTAMP) != 0;
+        m_component_num = header.component_num;
+        m_block_capacity = header.block_capacity;
+        m_block_size = header.block_size;
+        m_count = header.count;
+        if (m_mapped_size < sizeof(Header) + static_cast<uint64_t>(GetBlockNum()) * static_cast<uint64_t>(m_block_size)) {
+            throw std::runtime_error("Invalid trajectory file: truncated");
+        }
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+
+    if (m_has_timestamp) {
+        m_block_first_timestamp.resize(GetBlockNum());
+        for (int64_t block = 0; block < GetBlockNum(); block++) {
+            m_block_first_timestamp[block] = GetBlockTimestamps(block)[0];
+        }
+    }
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+    Unmap();
+}
+
+void TrajectoryReader::Unmap()
+{
+    if (!m_data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping_handle);
+    CloseHandle(m_file_handle);
+#else
+    munmap(const_cast<char*>(m_data), m_mapped_size);
+#endif
+    m_data = nullptr;
+}
+
+const char* TrajectoryReader::GetBlock(int64_t block) const
+{
+    return m_data + sizeof(Header) + block * m_block_size;
+}
+
+int32_t TrajectoryReader::GetBlockRecordNum(int64_t block) const
+{
+    return static_cast<int32_t>(std::min<int64_t>(m_block_capacity, m_count - block * m_block_capacity));
+}
+
+const float* TrajectoryReader::GetBlockPlanes(int64_t block) const
+{
+    return reinterpret_cast<const float*>(GetBlock(block));
+}
+
+const int64_t* TrajectoryReader::GetBlockTimestamps(int64_t block) const
+{
+    if (!m_has_timestamp) return nullptr;
+    return reinterpret_cast<const int64_t*>(GetBlock(block) + sizeof(float) * m_component_num * m_block_capacity);
+}
+
+float TrajectoryReader::GetValue(int64_t index, int32_t component) const
+{
+    return GetBlockPlanes(index / m_block_capacity)[static_cast<size_t>(component) * m_block_capacity + index % m_block_capacity];
+}
+
+void TrajectoryReader::GetRecord(int64_t index, float* record) const
+{
+    const float* planes = GetBlockPlanes(index / m_block_capacity);
+    const int64_t i = index % m_block_capacity;
+    for (int32_t c = 0; c < m_component_num; c++) {
+        record[c] = planes[static_cast<size_t>(c) * m_block_capacity + i];
+    }
+}
+
+int64_t TrajectoryReader::GetTimestamp(int64_t index) const
+{
+    if (!m_has_timestamp) return 0;
+    return GetBlockTimestamps(index / m_block_capacity)[index % m_block_capacity];
+}
+
+int64_t TrajectoryReader::FindIndex(int64_t timestamp) const
+{
+    const auto block_it = std::upper_bound(m_block_first_timestamp.begin(), m_block_first_timestamp.end(), timestamp);
+    if (block_it == m_block_first_timestamp.begin()) return -1;
+    const int64_t block = (block_it - m_block_first_timestamp.begin()) - 1;
+    const int64_t* timestamps = GetBlockTimestamps(block);
+    const int64_t i = std::upper_bound(timestamps, timestamps + GetBlockRecordNum(block), timestamp) - timestamps;
+    return block * m_block_capacity + i - 1;
+}
@@ -0,0 +1,154 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "converter.h"
+
+/*
+ * Binary file of a rotation trajectory (a sequence of rotations in a representation, with optional timestamps).
+ * Layout (native byte order):
+ *   header (128 bytes): magic, version, representation type, euler order, component num, flags, block capacity, block size, count
+ *   block 0, block 1, ...: each block has block_capacity records in structure-of-arrays layout.
+ *     component c: float[block_capacity], ..., (timestamp: int64_t[block_capacity])
+ * Every column starts at a multiple of 64 bytes, so that a mapped block can be passed to the batch converters as planes
+ * (plane stride = block capacity) without copy.
+ * The count in the header is the number of committed records. Data after it is ignored, so that the file is consistent at any time.
+ */
+namespace TrajectoryFile
+{
+    static constexpr int32_t DEFAULT_BLOCK_CAPACITY = 4096;
+    static constexpr int32_t BLOCK_CAPACITY_UNIT = 16;      /* float[16] = 64 bytes */
+}
+
+/*
+ * Append records to a new or an existing trajectory file.
+ * Records are buffered, and a block is written when it gets full. Commit writes the rest and updates the count in the header after the data
+ * is flushed to the storage, so that a crash (at any point) leaves the file with the records committed so far.
+ * Timestamps must be non-decreasing. Throw std::runtime_error for I/O errors and std::invalid_argument for invalid arguments.
+ */
+class TrajectoryWriter
+{
+public:
+    /* Create a new file (an existing file is overwritten). block_capacity must be a multiple of BLOCK_CAPACITY_UNIT */
+    TrajectoryWriter(const std::string& path, const Converter::Representation& representation, bool has_timestamp,
+        int32_t block_capacity = TrajectoryFile::DEFAULT_BLOCK_CAPACITY);
+    /* Open an existing file to append records */
+    explicit TrajectoryWriter(const std::string& path);
+    /* Commit the records (errors are ignored. Call Commit to check them) */
+    ~TrajectoryWriter();
+
+    /* A record has the components of the representation. timestamp is ignored if the file has no timestamp */
+    void Append(const float* record, int64_t timestamp = 0);
+    /* num records in array-of-structures layout (record i at record_list[i * component num]). timestamp_list can be nullptr without timestamp.
+     * All or nothing: if an argument is invalid (e.g. a timestamp goes back), no record is appended */
+    void AppendRecords(const float* record_list, int64_t num, const int64_t* timestamp_list = nullptr);
+    void Commit();
+
+    int64_t GetCount() const { return m_count; }     /* including records not committed yet */
+    int64_t GetCommittedCount() const { return m_committed_count; }
+    int32_t GetComponentNum() const { return m_component_num; }
+
+private:
+    TrajectoryWriter();
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    void Open(const std::string& path, const char* mode);
+    void WriteHeader();
+    void Load();
+    void WriteBlock();
+    void WriteCount(int64_t count);
+    void Sync();
+
+private:
+    FILE* m_fp;
+    Converter::Representation m_representation;
+    bool m_has_timestamp;
+    int32_t m_component_num;
+    int32_t m_block_capacity;
+    int64_t m_block_size;
+    int64_t m_count;
+    int64_t m_committed_count;
+    int64_t m_written_count;                /* records written to the file (not committed yet if larger than m_committed_count) */
+    int64_t m_last_timestamp;
+    std::vector<float> m_block_value;       /* the last block (not full) */
+    std::vector<int64_t> m_block_timestamp;
+};
+
+/*
+ * Read a trajectory file mapped on memory (zero copy).
+ * Record access by index is O(1). Search by timestamp uses a sparse index (the first timestamp of each block, built when the file is opened)
+ * and a binary search in a block.
+ * The file must not be shrunk while it is mapped. Records appended after opening are not visible.
+ * Throw std::runtime_error if the file can't be opened or is broken.
+ */
+class TrajectoryReader
+{
+public:
+    explicit TrajectoryReader(const std::string& path);
+    ~TrajectoryReader();
+
+    const Converter::Representation& GetRepresentation() const { return m_representation; }
+    int32_t GetComponentNum() const { return m_component_num; }
+    bool HasTimestamp() const { return m_has_timestamp; }
+    int64_t GetCount() const { return m_count; }
+
+    /* Blocks for batch conversion. Component c of the i-th record in a block is planes[c * GetBlockCapacity() + i] */
+    int32_t GetBlockCapacity() const { return m_block_capacity; }
+    int64_t GetBlockNum() const { return (m_count + m_block_capacity - 1) / m_block_capacity; }
+    int32_t GetBlockRecordNum(int64_t block) const;
+    const float* GetBlockPlanes(int64_t block) const;
+    const int64_t* GetBlockTimestamps(int64_t block) const;    /* nullptr without timestamp */
+
+    /* Random access by index */
+    float GetValue(int64_t index, int32_t component) const;
+    void GetRecord(int64_t index, float* record) const;
+    int64_t GetTimestamp(int64_t index) const;                  /* 0 without timestamp */
+
+    /* The index of the last record whose timestamp is <= timestamp. -1 if there is no such record (or no timestamp) */
+    int64_t FindIndex(int64_t timestamp) const;
+
+private:
+    TrajectoryReader();
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    const char* GetBlock(int64_t block) const;
+    void Unmap();
+
+private:
+    const char* m_data;
+    size_t m_mapped_size;
+#ifdef _WIN32
+    void* m_file_handle;
+    void* m_mapping_handle;
+#endif
+    Converter::Representation m_representation;
+    bool m_has_timestamp;
+    int32_t m_component_num;
+    int32_t m_block_capacity;
+    int64_t m_block_size;
+    int64_t m_count;
+    std::vector<int64_t> m_block_first_timestamp;      /* sparse index */
+};
+
+#endif
@@ -25,6 +25,7 @@ limitations under the License.
 
 /* for my modules */
 #include "matrix.h"
+#include "matrix_col_major.h"
 #include "transformation_matrix.h"
 #include "shader.h"
 
@@ -113,11 +114,12 @@ Shape::Shape(const std::vector<Object::Vertex>& vertex_list, const std::vector<G
     m_index_num = static_cast<GLsizei>(index_list.size());
 }
 
-void Shape::Draw(const Matrix& viewprojection, const Matrix& model) const
+void Shape::Draw(const Mat4ColMajor& viewprojection, const Matrix& model) const
 {
     glUseProgram(m_program_id);
-    const Matrix modelviewprojection = viewprojection * model;
-    glUniformMatrix4fv(m_modelviewprojection_loc, 1, GL_TRUE, modelviewprojection.Data());
+    /* The result is column-major, which is the layout OpenGL expects */
+    const Mat4ColMajor modelviewprojection = viewprojection * model;
+    glUniformMatrix4fv(m_modelviewprojection_loc, 1, GL_FALSE, modelviewprojection.Data());
     m_object->Bind();
     Execute();
 }
@@ -25,6 +25,7 @@ limitations under the License.
 #include <GLFW/glfw3.h>
 
 #include "matrix.h"
+#include "matrix_col_major.h"
 
 class Object
 {
@@ -53,7 +54,7 @@ class Shape
 public:
     Shape(const std::vector<Object::Vertex>& vertex_list, const std::vector<GLuint>& index_list = {});
     virtual ~Shape() {}
-    void Draw(const Matrix& viewprojection, const Matrix& model) const;
+    void Draw(const Mat4ColMajor& viewprojection, const Matrix& model) const;
 
 public:
     static void SetLineWidth(float width);
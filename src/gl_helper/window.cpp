@@ -27,6 +27,7 @@ limitations under the License.
 
 /* for my modules */
 #include "matrix.h"
+#include "matrix_fixed.h"
 #include "transformation_matrix.h"
 #include "projection_matrix.h"
 #include "rotation_matrix.h"
@@ -109,41 +110,48 @@ void Window::SetIsCameraRevolution(bool is_camera_revolution)
     m_is_camera_revolution = is_camera_revolution;
 }
 
-Matrix Window::GetViewProjectionFromAxisX(float cx, float cy, float fovy, float z_near, float z_far)
+Mat4ColMajor Window::GetViewProjectionFromAxisX(float cx, float cy, float fovy, float z_near, float z_far)
 {
-    Matrix view = Matrix::Identity(4);
-    view = TransformationMatrix::Translate(-1.0f, 0.0f, 0.0f) * view;  /* move to origin */
-    view = TransformationMatrix::RotateY(static_cast<float>(-M_PI / 2.0)) * view; /* rotate*/
+    Mat4 translate, rotate;
+    Mat4ColMajor projection;
+    TransformationMatrix::Translate(-1.0f, 0.0f, 0.0f, translate);  /* move to origin */
+    TransformationMatrix::RotateY(static_cast<float>(-M_PI / 2.0), rotate); /* rotate*/
     const float aspect = static_cast<float>(m_width) / m_height;
-    const Matrix projection = ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far);
-    return projection * view;
+    ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far, projection);
+    return projection * (rotate * translate);
 }
 
-Matrix Window::GetViewProjectionFromAxisY(float cx, float cy, float fovy, float z_near, float z_far)
+Mat4ColMajor Window::GetViewProjectionFromAxisY(float cx, float cy, float fovy, float z_near, float z_far)
 {
-    Matrix view = Matrix::Identity(4);
-    view = TransformationMatrix::Translate(0.0f, -1.0f, 0.0f) * view;  /* move to origin */
-    view = TransformationMatrix::RotateX(static_cast<float>(M_PI / 2.0)) * view; /* rotate*/
+    Mat4 translate, rotate;
+    Mat4ColMajor projection;
+    TransformationMatrix::Translate(0.0f, -1.0f, 0.0f, translate);  /* move to origin */
+    TransformationMatrix::RotateX(static_cast<float>(M_PI / 2.0), rotate); /* rotate*/
     const float aspect = static_cast<float>(m_width) / m_height;
-    const Matrix projection = ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far);
-    return projection * view;
+    ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far, projection);
+    return projection * (rotate * translate);
 }
 
-Matrix Window::GetViewProjectionFromAxisZ(float cx, float cy, float fovy, float z_near, float z_far)
+Mat4ColMajor Window::GetViewProjectionFromAxisZ(float cx, float cy, float fovy, float z_near, float z_far)
 {
-    Matrix view = Matrix::Identity(4);
-    view = TransformationMatrix::Translate(0.0f, 0.0f, -1.0f) * view;  /* move to origin */
+    Mat4 translate;
+    Mat4ColMajor projection;
+    TransformationMatrix::Translate(0.0f, 0.0f, -1.0f, translate);  /* move to origin */
     const float aspect = static_cast<float>(m_width) / m_height;
-    const Matrix projection = ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far);
-    return projection * view;
+    ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far, projection);
+    return projection * translate;
 }
-Matrix Window::GetViewProjection(float cx, float cy, float fovy, float z_near, float z_far)
+Mat4ColMajor Window::GetViewProjection(float cx, float cy, float fovy, float z_near, float z_far)
 {
-    Matrix view = Matrix::Identity(4);
-    view = TransformationMatrix::Translate(-m_camera_pos[0], -m_camera_pos[1], -m_camera_pos[2]) * view;  /* move to origin */
-    view = TransformationMatrix::RotateX(m_camera_angle[0]) * TransformationMatrix::RotateY(m_camera_angle[1]) * TransformationMatrix::RotateZ(m_camera_angle[2]) * view; /* rotate*/
+    Mat4 translate, rotate_x, rotate_y, rotate_z;
+    Mat4ColMajor projection;
+    TransformationMatrix::Translate(-m_camera_pos[0], -m_camera_pos[1], -m_camera_pos[2], translate);  /* move to origin */
+    TransformationMatrix::RotateX(m_camera_angle[0], rotate_x);
+    TransformationMatrix::RotateY(m_camera_angle[1], rotate_y);
+    TransformationMatrix::RotateZ(m_camera_angle[2], rotate_z);
+    const Mat4 view = rotate_x * rotate_y * rotate_z * translate; /* rotate*/
     const float aspect = static_cast<float>(m_width) / m_height;
-    const Matrix projection = ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far);
+    ProjectionMatrix::Perspective(cx, cy, fovy, aspect, z_near, z_far, projection);
     return projection * view;
 }
 
@@ -316,9 +324,12 @@ void Window::SwapBuffers()
 void Window::MoveCameraPosFromCameraCoordinate(float dx, float dy, float dz)
 {
     // dx, dy, dz are in camera coordinate
-    Matrix rot = TransformationMatrix::RotateX(m_camera_angle[0]) * TransformationMatrix::RotateY(m_camera_angle[1]);
-    Matrix trans = TransformationMatrix::Translate(dx, dy, dz);
-    Matrix pos_in_world = rot.Transpose() * trans;  // use transpose instead of inverse, since rot is orthogonal matrix
+    Mat4 rot_x, rot_y, trans;
+    TransformationMatrix::RotateX(m_camera_angle[0], rot_x);
+    TransformationMatrix::RotateY(m_camera_angle[1], rot_y);
+    TransformationMatrix::Translate(dx, dy, dz, trans);
+    const Mat4 rot = rot_x * rot_y;
+    const Mat4 pos_in_world = rot.Transpose() * trans;  // use transpose instead of inverse, since rot is orthogonal matrix
     m_camera_pos[0] += pos_in_world(0, 3);  // tx in world coordinate
     m_camera_pos[1] += pos_in_world(1, 3);  // ty in world coordinate
     m_camera_pos[2] += pos_in_world(2, 3);  // tz in world coordinate
@@ -27,6 +27,7 @@ limitations under the License.
 
 /* for my modules */
 #include "matrix.h"
+#include "matrix_col_major.h"
 
 class Window
 {
@@ -40,10 +41,10 @@ public:
     void LookAt(const std::array<float, 3>& eye, const std::array<float, 3>& gaze, const std::array<float, 3>& up);
     bool FrameStart();
     void SwapBuffers();
-    Matrix GetViewProjection(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.1f, float z_far = 1000.0f);
-    Matrix GetViewProjectionFromAxisX(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
-    Matrix GetViewProjectionFromAxisY(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
-    Matrix GetViewProjectionFromAxisZ(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
+    Mat4ColMajor GetViewProjection(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.1f, float z_far = 1000.0f);
+    Mat4ColMajor GetViewProjectionFromAxisX(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
+    Mat4ColMajor GetViewProjectionFromAxisY(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
+    Mat4ColMajor GetViewProjectionFromAxisZ(float cx = 0.0f, float cy = 0.0f, float fovy = 1.0f, float z_near = 0.9f, float z_far = 1000.0f);
     
     GLFWwindow* GetWindow();
     void SetIsDarkMode(bool);
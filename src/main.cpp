@@ -32,6 +32,7 @@ limitations under the License.
 #include "shape.h"
 #include "object_data.h"
 #include "container.h"
+#include "converter.h"
 #include "window.h"
 #include "ui.h"
 #include "rotation_matrix.h"
@@ -55,57 +56,15 @@ static constexpr float PROJECTION_OFFSET_CY = 0.2f; /* add offset for cx because
 /*** Global variable ***/
 
 /*** Function ***/
-static void ConvertAll(InputContainer& input_container, OutputContainer& output_container, bool is_normalize_rotation_matrix)
-{
-    /* First, Convert the selected input representation to rotatin matrix (mat3_rot) */
-    Matrix mat3_rot = Matrix::Identity(3);
-    switch (static_cast<REPRESENTATION_TYPE>(input_container.selected_representation_type)) {
-    case REPRESENTATION_TYPE::ROTATION_MATRIX:
-        for (int32_t i = 0; i < 9; i++) {
-            mat3_rot[i] = input_container.rotation_matrix[i];
-        }
-        if (is_normalize_rotation_matrix) {
-            mat3_rot = RotationMatrix::NormalizeRotationMatrix(mat3_rot);
-        }
-        break;
-    case REPRESENTATION_TYPE::ROTATION_VECTOR:
-        mat3_rot = RotationMatrix::ConvertRotationVector2RotationMatrix(input_container.rotation_vector[0], input_container.rotation_vector[1], input_container.rotation_vector[2]);
-        break;
-    case REPRESENTATION_TYPE::AXIS_ANGLE:
-        mat3_rot = RotationMatrix::ConvertAxisAngle2RotationMatrix(input_container.axis_angle[0], input_container.axis_angle[1], input_container.axis_angle[2], input_container.axis_angle[3]);
-        break;
-    case REPRESENTATION_TYPE::QUATERNION:
-        mat3_rot = RotationMatrix::ConvertQuaternion2RotationMatrix(input_container.quaternion[0], input_container.quaternion[1], input_container.quaternion[2], input_container.quaternion[3]);
-        break;
-    case REPRESENTATION_TYPE::EULER_MOBILE:
-        mat3_rot = RotationMatrix::ConvertEulerMobile2RotationMatrix(static_cast<RotationMatrix::EULER_ORDER>(input_container.mobile_euler_order), input_container.mobile_euler_angle[0], input_container.mobile_euler_angle[1], input_container.mobile_euler_angle[2]);
-        break;
-    case REPRESENTATION_TYPE::EULER_FIXED:
-        mat3_rot = RotationMatrix::ConvertEulerFixed2RotationMatrix(static_cast<RotationMatrix::EULER_ORDER>(input_container.fixed_euler_order), input_container.fixed_euler_angle[0], input_container.fixed_euler_angle[1], input_container.fixed_euler_angle[2]);
-        break;
-    }
-
-    /* Then, Convert the calculated rotation matrix (mat3_rot) to all the other representations (output) */
-    for (int32_t i = 0; i < 9; i++) {
-        output_container.rotation_matrix[i] = mat3_rot[i];
-    }
-    output_container.rotation_vector = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot);
-    output_container.axis_angle = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_rot);
-    output_container.quaternion = RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot);
-    for (int32_t i = 0; i < static_cast<int32_t>(sizeof(output_container.mobile_euler_angle) / sizeof(Matrix)); i++) {
-        output_container.mobile_euler_angle[i] = RotationMatrix::ConvertRotationMatrix2EulerMobile(static_cast<RotationMatrix::EULER_ORDER>(i), mat3_rot);
-        output_container.fixed_euler_angle[i] = RotationMatrix::ConvertRotationMatrix2EulerFixed(static_cast<RotationMatrix::EULER_ORDER>(i), mat3_rot);
-    }
-}
-
 static void OverwriteInput(InputContainer& input_container, OutputContainer& output_container)
 {
-    input_container.rotation_matrix = output_container.rotation_matrix;
-    input_container.quaternion = output_container.quaternion;
-    input_container.axis_angle = output_container.axis_angle;
-    input_container.rotation_vector = output_container.rotation_vector;
-    input_container.mobile_euler_angle = output_container.mobile_euler_angle[input_container.mobile_euler_order];
-    input_container.fixed_euler_angle = output_container.fixed_euler_angle[input_container.fixed_euler_order];
+    input_container.rotation_matrix = output_container.GetRotationMatrix();
+    input_container.quaternion = output_container.GetQuaternion();
+    input_container.axis_angle = output_container.GetAxisAngle();
+    input_container.rotation_vector = output_container.GetRotationVector();
+    input_container.mobile_euler_angle = output_container.GetMobileEulerAngle(input_container.mobile_euler_order);
+    input_container.fixed_euler_angle = output_container.GetFixedEulerAngle(input_container.fixed_euler_order);
+    input_container.MarkAllChanged();
 }
 
 static void ResetValues(InputContainer& input_container, OutputContainer& output_container)
@@ -150,18 +109,19 @@ int main(int argc, char *argv[])
         }
 
         /* Draw bases */
+        const Mat4ColMajor view_projection = my_window.GetViewProjection(PROJECTION_OFFSET_CX, PROJECTION_OFFSET_CY);
         if (setting_container.is_draw_ground) {
             Shape::SetLineWidth(0.5f);
-            ground->Draw(my_window.GetViewProjection(PROJECTION_OFFSET_CX, PROJECTION_OFFSET_CY), TransformationMatrix::Translate(0.0f, -1.0f, 0.0f));
+            ground->Draw(view_projection, TransformationMatrix::Translate(0.0f, -1.0f, 0.0f));
         }
         Shape::SetLineWidth(2.0f);
-        axes->Draw(my_window.GetViewProjection(PROJECTION_OFFSET_CX, PROJECTION_OFFSET_CY), Matrix::Identity(4));
+        axes->Draw(view_projection, Matrix::Identity(4));
         
         /* Draw monolith */
-        Matrix model_pose = TransformationMatrix::Expand3to4(output_container.rotation_matrix);
-        object->Draw(my_window.GetViewProjection(PROJECTION_OFFSET_CX, PROJECTION_OFFSET_CY), model_pose);
+        Matrix model_pose = TransformationMatrix::Expand3to4(output_container.GetRotationMatrix());
+        object->Draw(view_projection, model_pose);
         Shape::SetLineWidth(10.0f);
-        object_axes->Draw(my_window.GetViewProjection(PROJECTION_OFFSET_CX, PROJECTION_OFFSET_CY), model_pose);
+        object_axes->Draw(view_projection, model_pose);
 
         /* Draw monolith from each axis*/
         if (setting_container.is_view_from_axis) {
@@ -169,17 +129,18 @@ int main(int argc, char *argv[])
             static constexpr float SIZE_VIEW_FROM_AXIS = 0.1f;
             static constexpr float START_POS_OF_VIEW_FROM_AXIS = 0.4f;
             static constexpr float INTERVAL_OF_VIEW_FROM_AXIS = 0.6f;
-            model_pose = model_pose * TransformationMatrix::Scale(SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS);
-            Matrix view_projection_from_x = my_window.GetViewProjectionFromAxisX(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 0);
-            Matrix view_projection_from_y = my_window.GetViewProjectionFromAxisY(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 1);
-            Matrix view_projection_from_z = my_window.GetViewProjectionFromAxisZ(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 2);
-            axes->Draw(view_projection_from_x, TransformationMatrix::Scale(SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS));
+            const Matrix scale = TransformationMatrix::Scale(SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS);
+            model_pose *= scale;
+            const Mat4ColMajor view_projection_from_x = my_window.GetViewProjectionFromAxisX(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 0);
+            const Mat4ColMajor view_projection_from_y = my_window.GetViewProjectionFromAxisY(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 1);
+            const Mat4ColMajor view_projection_from_z = my_window.GetViewProjectionFromAxisZ(-(0.91f - SIZE_VIEW_FROM_AXIS), -START_POS_OF_VIEW_FROM_AXIS + INTERVAL_OF_VIEW_FROM_AXIS * 2);
+            axes->Draw(view_projection_from_x, scale);
             object->Draw(view_projection_from_x, model_pose);
             object_axes->Draw(view_projection_from_x, model_pose);
-            axes->Draw(view_projection_from_y, TransformationMatrix::Scale(SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS));
+            axes->Draw(view_projection_from_y, scale);
             object->Draw(view_projection_from_y, model_pose);
             object_axes->Draw(view_projection_from_y, model_pose);
-            axes->Draw(view_projection_from_z, TransformationMatrix::Scale(SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS, SIZE_VIEW_FROM_AXIS));
+            axes->Draw(view_projection_from_z, scale);
             object->Draw(view_projection_from_z, model_pose);
             object_axes->Draw(view_projection_from_z, model_pose);
         }
@@ -192,7 +153,7 @@ int main(int argc, char *argv[])
         }
 
         /* Convert representations of rotation */
-        ConvertAll(input_container, output_container, setting_container.is_normalize_rotation_matrix);
+        Converter::ConvertAll(input_container, output_container, setting_container.is_normalize_rotation_matrix);
         if (setting_container.is_update_input_pressed) {
             OverwriteInput(input_container, output_container);
         }
@@ -16,6 +16,7 @@ limitations under the License.
 #include <cstdint>
 #include <cstdio>
 #include <climits>
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 
@@ -44,10 +45,10 @@ Matrix::Matrix(int32_t rows, int32_t cols)
 
     m_rows = rows;
     m_cols = cols;
-    m_data_array = std::vector<float>(static_cast<size_t>(m_rows) * m_cols);
+    m_data_array.resize(static_cast<size_t>(m_rows) * m_cols);
 }
 
-Matrix::Matrix(int32_t rows, int32_t cols, float* data)
+Matrix::Matrix(int32_t rows, int32_t cols, const float* data)
     : Matrix(rows, cols)
 {
     std::copy(data, data + static_cast<size_t>(m_rows) * m_cols, m_data_array.data());
@@ -65,127 +66,88 @@ Matrix::~Matrix()
     // do nothing
 }
 
-const float* Matrix::Data() const
+Matrix& Matrix::operator*=(float k)
 {
-    return m_data_array.data();
+    const size_t size = m_data_array.size();
+    for (size_t i = 0; i < size; i++) {
+        m_data_array[i] *= k;
+    }
+    return *this;
 }
 
-float* Matrix::Data()
+static void CheckBlock(int32_t row, int32_t col, int32_t rows, int32_t cols, int32_t mat_rows, int32_t mat_cols)
 {
-    return &m_data_array[0];
+    if (row < 0 || col < 0 || rows <= 0 || cols <= 0 || row + rows > mat_rows || col + cols > mat_cols) {
+        throw std::out_of_range("Invalid index");
+    }
 }
 
-const float& Matrix::operator[](int32_t i) const
+MatrixView Matrix::View()
 {
-    return m_data_array.at(i);
+    return MatrixView(Data(), m_rows, m_cols, m_cols);
 }
 
-float& Matrix::operator[](int32_t i)
+ConstMatrixView Matrix::View() const
 {
-    return m_data_array.at(i);
+    return ConstMatrixView(Data(), m_rows, m_cols, m_cols);
 }
 
-float& Matrix::operator() (int32_t row, int32_t col)
+MatrixView Matrix::Block(int32_t row, int32_t col, int32_t rows, int32_t cols)
 {
-    if (row >= m_rows || col >= m_cols) throw std::out_of_range("Invalid index");
-    return m_data_array.at(row * m_cols + col);
+    CheckBlock(row, col, rows, cols, m_rows, m_cols);
+    return MatrixView(Data() + row * m_cols + col, rows, cols, m_cols);
 }
 
-const float& Matrix::operator() (int32_t row, int32_t col) const
+ConstMatrixView Matrix::Block(int32_t row, int32_t col, int32_t rows, int32_t cols) const
 {
-    if (row >= m_rows || col >= m_cols) throw std::out_of_range("Invalid index");
-    return m_data_array.at(row * m_cols + col);
+    CheckBlock(row, col, rows, cols, m_rows, m_cols);
+    return ConstMatrixView(Data() + row * m_cols + col, rows, cols, m_cols);
 }
 
-Matrix Matrix::operator+(const Matrix& right) const
+MatrixView Matrix::Row(int32_t row)
 {
-    const Matrix& left = *this;
-    if ((left.m_rows != right.m_rows) || (left.m_cols != right.m_cols)) throw std::out_of_range("Invalid index");
-    Matrix ret(left.m_rows, right.m_cols);
-    for (int32_t i = 0; i < m_rows * m_cols; i++) {
-        ret[i] = left[i] + right[i];
-    }
-    return ret;
+    return Block(row, 0, 1, m_cols);
 }
 
-Matrix Matrix::operator-(const Matrix& right) const
+ConstMatrixView Matrix::Row(int32_t row) const
 {
-    const Matrix& left = *this;
-    if ((left.m_rows != right.m_rows) || (left.m_cols != right.m_cols)) throw std::out_of_range("Invalid index");
-    Matrix ret(left.m_rows, right.m_cols);
-    for (int32_t i = 0; i < m_rows * m_cols; i++) {
-        ret[i] = left[i] - right[i];
-    }
-    return ret;
+    return Block(row, 0, 1, m_cols);
 }
 
-Matrix Matrix::operator*(const float& k) const
+MatrixView Matrix::Col(int32_t col)
 {
-    const Matrix& left = *this;
-    Matrix ret(left.m_rows, left.m_cols);
-    for (int32_t i = 0; i < m_rows * m_cols; i++) {
-        ret[i] = left[i] * k;
-    }
-    return ret;
+    return Block(0, col, m_rows, 1);
 }
 
-Matrix Matrix::operator*(const Matrix& right) const
+ConstMatrixView Matrix::Col(int32_t col) const
 {
-    const Matrix& left = *this;
-    if (left.m_cols != right.m_rows) throw std::out_of_range("Invalid index");
-    Matrix ret(left.m_rows, right.m_cols);
-    for (int32_t row = 0; row < left.m_rows; row++) {
-        for (int32_t col = 0; col < right.m_cols; col++) {
-            ret(row, col) = 0.0f;
-            for (int32_t i = 0; i < left.m_cols; i++) {
-                ret(row, col) += left(row, i) * right(i, col);
-            }
-        }
-    }
-    return ret;
+    return Block(0, col, m_rows, 1);
 }
+
 Matrix Matrix::Transpose() const
 {
-    const Matrix& mat = *this;
-    Matrix ret(mat.m_cols, mat.m_rows);
-    for (int32_t row = 0; row < m_rows; row++) {
-        for (int32_t col = 0; col < m_cols; col++) {
-            ret(col, row) = mat(row, col);
-        }
-    }
+    Matrix ret(m_cols, m_rows);
+    TransposeInto(ret, *this);
     return ret;
 }
 
-Matrix Matrix::Inverse() const
+Matrix Matrix::Inverse(MATRIX_STRUCTURE structure) const
 {
     if (m_rows != m_cols) {
         throw std::out_of_range("Invalid shape");
     }
-    Matrix mat = *this;
-    int32_t n = mat.m_rows;
-    Matrix ret = Identity(n);
-    for (int32_t y = 0; y < n; y++) {
-        if (mat(y, y) == 0) {
-            throw std::out_of_range("Tried to calculate an inverse of non - singular matrix");
-        }
-        float scale_to_1 = 1.0f / mat(y, y);
-        for (int32_t x = 0; x < n; x++) {
-            mat(y, x) *= scale_to_1;
-            ret(y, x) *= scale_to_1;
-        }
-        for (int32_t yy = 0; yy < n; yy++) {
-            if (yy != y) {
-                float scale_to_0 = mat(yy, y);
-                for (int32_t x = 0; x < n; x++) {
-                    mat(yy, x) -= mat(y, x) * scale_to_0;
-                    ret(yy, x) -= ret(y, x) * scale_to_0;
-                }
-            }
-        }
-    }
+    Matrix ret(m_rows, m_cols);
+    MatrixInverse::Invert(Data(), ret.Data(), m_rows, structure);
     return ret;
 }
 
+void Matrix::Reshape(int32_t rows, int32_t cols)
+{
+    m_rows = rows;
+    m_cols = cols;
+    m_data_array.resize(static_cast<size_t>(rows) * cols);
+}
+
 void Matrix::Print() const
 {
     if (m_rows == 1) {
@@ -210,9 +172,55 @@ void Matrix::Print() const
 Matrix Matrix::Identity(int32_t size)
 {
     Matrix ret(size, size);
-    std::fill(ret.Data(), ret.Data() + size * size, 0.0f);
+    float* d = ret.Data();
     for (int32_t i = 0; i < size; i++) {
-        ret(i, i) = 1.0f;
+        d[i * size + i] = 1.0f;
     }
     return ret;
 }
+
+void MultiplyInto(Matrix& dst, const Matrix& left, const Matrix& right)
+{
+    dst = left * right;     /* aliasing is checked in operator= */
+}
+
+void TransposeInto(Matrix& dst, const Matrix& mat)
+{
+    const int32_t rows = mat.m_rows;
+    const int32_t cols = mat.m_cols;
+    if (&dst == &mat) {
+        if (rows == cols) {
+            float* d = dst.Data();
+            for (int32_t row = 0; row < rows; row++) {
+                for (int32_t col = row + 1; col < cols; col++) {
+                    std::swap(d[row * cols + col], d[col * cols + row]);
+                }
+            }
+        } else {
+            dst = mat.Transpose();
+        }
+        return;
+    }
+    dst.Reshape(cols, rows);
+    const float* s = mat.Data();
+    float* d = dst.Data();
+    for (int32_t row = 0; row < rows; row++) {
+        for (int32_t col = 0; col < cols; col++) {
+            d[col * rows + row] = s[row * cols + col];
+        }
+    }
+}
+
+void InverseInto(Matrix& dst, const Matrix& mat, MATRIX_STRUCTURE structure)
+{
+    if (mat.m_rows != mat.m_cols) {
+        throw std::out_of_range("Invalid shape");
+    }
+    if (&dst == &mat) {
+        const Matrix src = mat;
+        MatrixInverse::Invert(src.Data(), dst.Data(), src.m_rows, structure);
+        return;
+    }
+    dst.Reshape(mat.m_rows, mat.m_cols);
+    MatrixInverse::Invert(mat.Data(), dst.Data(), mat.m_rows, structure);
+}
@@ -18,36 +18,191 @@ limitations under the License.
 /*** Include ***/
 #include <cstdint>
 #include <cstdio>
+#include <algorithm>
 #include <vector>
+#include <stdexcept>
 
-class Matrix
+#include "matrix_storage.h"
+#include "matrix_expression.h"
+#include "matrix_view.h"
+#include "matrix_inverse.h"
+
+class Matrix : public MatrixExpression<Matrix>
 {
 public:
     Matrix();
     Matrix(int32_t rows, int32_t cols);
-    Matrix(int32_t rows, int32_t cols, float* data);
+    Matrix(int32_t rows, int32_t cols, const float* data);
     Matrix(int32_t rows, int32_t cols, const std::vector<float>& data);
+    template<typename E>
+    Matrix(const MatrixExpression<E>& expr);
+    Matrix(const Matrix& mat) = default;
+    Matrix(Matrix&& mat) = default;
     ~Matrix();
+    Matrix& operator=(const Matrix& mat) = default;
+    Matrix& operator=(Matrix&& mat) = default;
+    int32_t Rows() const;
+    int32_t Cols() const;
     const float* Data() const;
     float* Data();
     const float& operator[](int32_t i) const;
     float& operator[](int32_t i);
     float& operator() (int32_t row, int32_t col);
     const float& operator() (int32_t row, int32_t col) const;
-    Matrix operator+(const Matrix& right) const;
-    Matrix operator-(const Matrix& right) const;
-    Matrix operator*(const float& k) const;
-    Matrix operator*(const Matrix& right) const;
+    template<typename E>
+    Matrix& operator=(const MatrixExpression<E>& expr);
+    template<typename E>
+    Matrix& operator+=(const MatrixExpression<E>& expr);
+    template<typename E>
+    Matrix& operator-=(const MatrixExpression<E>& expr);
+    Matrix& operator*=(float k);
+    template<typename E>
+    Matrix& operator*=(const MatrixExpression<E>& expr);
+    float Coeff(int32_t i) const { return m_data_array[i]; }  /* unchecked access for expression evaluation */
+    bool References(const Matrix& mat) const { return this == &mat; }
+    void EvaluateTo(float* dst) const { std::copy(m_data_array.begin(), m_data_array.end(), dst); }
+    MatrixView View();
+    ConstMatrixView View() const;
+    MatrixView Block(int32_t row, int32_t col, int32_t rows, int32_t cols);
+    ConstMatrixView Block(int32_t row, int32_t col, int32_t rows, int32_t cols) const;
+    MatrixView Row(int32_t row);
+    ConstMatrixView Row(int32_t row) const;
+    MatrixView Col(int32_t col);
+    ConstMatrixView Col(int32_t col) const;
     Matrix Transpose() const;
-    Matrix Inverse() const;
+    Matrix Inverse(MATRIX_STRUCTURE structure = MATRIX_STRUCTURE::GENERAL) const;  /* structure is a hint to use a cheaper calculation */
     void Print() const;
 
     static Matrix Identity(int32_t size);
 
 private:
-    std::vector<float> m_data_array;
+    void Reshape(int32_t rows, int32_t cols);
+    friend void TransposeInto(Matrix& dst, const Matrix& mat);
+    friend void InverseInto(Matrix& dst, const Matrix& mat, MATRIX_STRUCTURE structure);
+
+private:
+    MatrixStorage m_data_array;     /* elements are inline for 16 or fewer */
     int32_t m_rows;
     int32_t m_cols;
 };
 
+/* Element access is checked (throws std::out_of_range) only when MATRIX_BOUNDS_CHECK is defined (Debug build and tests) */
+inline int32_t Matrix::Rows() const
+{
+    return m_rows;
+}
+
+inline int32_t Matrix::Cols() const
+{
+    return m_cols;
+}
+
+inline const float* Matrix::Data() const
+{
+    return m_data_array.data();
+}
+
+inline float* Matrix::Data()
+{
+    return m_data_array.data();
+}
+
+#ifdef MATRIX_BOUNDS_CHECK
+inline const float& Matrix::operator[](int32_t i) const
+{
+    return m_data_array.at(i);
+}
+
+inline float& Matrix::operator[](int32_t i)
+{
+    return m_data_array.at(i);
+}
+
+inline float& Matrix::operator() (int32_t row, int32_t col)
+{
+    if (row < 0 || row >= m_rows || col < 0 || col >= m_cols) throw std::out_of_range("Invalid index");
+    return m_data_array[row * m_cols + col];
+}
+
+inline const float& Matrix::operator() (int32_t row, int32_t col) const
+{
+    if (row < 0 || row >= m_rows || col < 0 || col >= m_cols) throw std::out_of_range("Invalid index");
+    return m_data_array[row * m_cols + col];
+}
+#else
+inline const float& Matrix::operator[](int32_t i) const
+{
+    return m_data_array[i];
+}
+
+inline float& Matrix::operator[](int32_t i)
+{
+    return m_data_array[i];
+}
+
+inline float& Matrix::operator() (int32_t row, int32_t col)
+{
+    return m_data_array[row * m_cols + col];
+}
+
+inline const float& Matrix::operator() (int32_t row, int32_t col) const
+{
+    return m_data_array[row * m_cols + col];
+}
+#endif
+
+template<typename E>
+Matrix::Matrix(const MatrixExpression<E>& expr)
+    : Matrix(expr.Rows(), expr.Cols())
+{
+    expr.Derived().EvaluateTo(m_data_array.data());
+}
+
+template<typename E>
+Matrix& Matrix::operator=(const MatrixExpression<E>& expr)
+{
+    if (expr.Derived().References(*this)) {
+        /* the destination is used in the expression (e.g. a = a * b), so evaluate into a temporary */
+        *this = Matrix(expr);
+    } else {
+        m_rows = expr.Rows();
+        m_cols = expr.Cols();
+        m_data_array.resize(static_cast<size_t>(m_rows) * m_cols);
+        expr.Derived().EvaluateTo(m_data_array.data());
+    }
+    return *this;
+}
+
+/* Coefficient-wise operations are evaluated directly into this matrix */
+template<typename E>
+Matrix& Matrix::operator+=(const MatrixExpression<E>& expr)
+{
+    return *this = *this + expr;
+}
+
+template<typename E>
+Matrix& Matrix::operator-=(const MatrixExpression<E>& expr)
+{
+    return *this = *this - expr;
+}
+
+/* this = this * expr. A temporary is used, but it is inline for small matrices */
+template<typename E>
+Matrix& Matrix::operator*=(const MatrixExpression<E>& expr)
+{
+    return *this = *this * expr;
+}
+
+/* Write the result into dst, reusing its buffer (no allocation if dst already has enough size).
+ * dst can be one of the inputs. In that case the result goes through a temporary */
+void MultiplyInto(Matrix& dst, const Matrix& left, const Matrix& right);
+void TransposeInto(Matrix& dst, const Matrix& mat);
+void InverseInto(Matrix& dst, const Matrix& mat, MATRIX_STRUCTURE structure = MATRIX_STRUCTURE::GENERAL);
+
+template<typename E>
+Matrix MatrixExpression<E>::eval() const
+{
+    return Matrix(*this);
+}
+
 #endif
@@ -0,0 +1,148 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_COL_MAJOR_H
+#define MATRIX_COL_MAJOR_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+
+/*
+ * 4x4 matrix stored in column-major order, which is the layout OpenGL expects.
+ * Data() can be uploaded by glUniformMatrix4fv with transpose = GL_FALSE, so no reordering is needed per draw.
+ * Element access by (row, col) has the same meaning as Matrix/Mat4. Only the order in memory is different.
+ * A product with a row-major matrix on the right reads it in place and the result is column-major.
+ */
+class Mat4ColMajor
+{
+public:
+    static constexpr int32_t SIZE = 4;
+
+    Mat4ColMajor()
+    {
+        m_data_array.fill(0.0f);
+    }
+
+    /* Reorder a row-major matrix */
+    explicit Mat4ColMajor(const Mat4& mat)
+    {
+        for (int32_t row = 0; row < SIZE; row++) {
+            for (int32_t col = 0; col < SIZE; col++) {
+                m_data_array[col * SIZE + row] = mat(row, col);
+            }
+        }
+    }
+
+    explicit operator Mat4() const
+    {
+        Mat4 ret;
+        for (int32_t row = 0; row < SIZE; row++) {
+            for (int32_t col = 0; col < SIZE; col++) {
+                ret(row, col) = m_data_array[col * SIZE + row];
+            }
+        }
+        return ret;
+    }
+
+    static constexpr int32_t Rows() { return SIZE; }
+    static constexpr int32_t Cols() { return SIZE; }
+
+    const float* Data() const
+    {
+        return m_data_array.data();
+    }
+
+    float* Data()
+    {
+        return m_data_array.data();
+    }
+
+#ifdef MATRIX_BOUNDS_CHECK
+    float& operator() (int32_t row, int32_t col)
+    {
+        if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) throw std::out_of_range("Invalid index");
+        return m_data_array[col * SIZE + row];
+    }
+
+    const float& operator() (int32_t row, int32_t col) const
+    {
+        if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) throw std::out_of_range("Invalid index");
+        return m_data_array[col * SIZE + row];
+    }
+#else
+    float& operator() (int32_t row, int32_t col)
+    {
+        return m_data_array[col * SIZE + row];
+    }
+
+    const float& operator() (int32_t row, int32_t col) const
+    {
+        return m_data_array[col * SIZE + row];
+    }
+#endif
+
+    Mat4ColMajor operator*(const Mat4ColMajor& right) const
+    {
+        return Multiply(right.Data(), 1, SIZE);
+    }
+
+    Mat4ColMajor operator*(const Mat4& right) const
+    {
+        return Multiply(right.Data(), SIZE, 1);
+    }
+
+    Mat4ColMajor operator*(const Matrix& right) const
+    {
+        if (right.Rows() != SIZE || right.Cols() != SIZE) throw std::out_of_range("Invalid shape");
+        return Multiply(right.Data(), SIZE, 1);
+    }
+
+    static Mat4ColMajor Identity()
+    {
+        Mat4ColMajor ret;
+        for (int32_t i = 0; i < SIZE; i++) {
+            ret.m_data_array[i * SIZE + i] = 1.0f;
+        }
+        return ret;
+    }
+
+private:
+    /* right(k, col) is right[k * row_stride + col * col_stride]. The innermost loop runs down a column of this and the result */
+    Mat4ColMajor Multiply(const float* right, int32_t row_stride, int32_t col_stride) const
+    {
+        Mat4ColMajor ret;
+        float* d = ret.Data();
+        for (int32_t col = 0; col < SIZE; col++) {
+            for (int32_t k = 0; k < SIZE; k++) {
+                const float r = right[k * row_stride + col * col_stride];
+                const float* l = &m_data_array[k * SIZE];
+                for (int32_t row = 0; row < SIZE; row++) {
+                    d[col * SIZE + row] += l[row] * r;
+                }
+            }
+        }
+        return ret;
+    }
+
+private:
+    std::array<float, SIZE * SIZE> m_data_array;
+};
+
+#endif
@@ -0,0 +1,290 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_EXPRESSION_H
+#define MATRIX_EXPRESSION_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <stdexcept>
+
+#include "matrix_gemm.h"
+
+/*
+ * Expression templates for Matrix arithmetic.
+ * operator+, operator-, operator*(float) and operator*(Matrix) don't calculate anything,
+ * but return a light-weight expression object. The expression is evaluated only when it is assigned to a Matrix
+ * (or when eval() is called), so that a chain like "a * 2 + b - c" runs in a single loop writing into the destination.
+ * For a product chain like "a * b * c", each row of the result is streamed through a small scratch buffer.
+ * A large product is calculated by the cache-blocked kernel (MatrixGemm) instead.
+ *
+ * Note: an expression keeps references to the Matrix operands. Don't store it with "auto", but assign it to a Matrix
+ *       or call eval() within the same statement.
+ * Note: if the destination appears in a product (e.g. "a = a * b"), the result is evaluated into a temporary Matrix
+ *       automatically. Call eval() to force a temporary explicitly.
+ */
+
+class Matrix;
+
+template<typename E>
+class MatrixExpression
+{
+public:
+    const E& Derived() const { return static_cast<const E&>(*this); }
+    int32_t Rows() const { return Derived().Rows(); }
+    int32_t Cols() const { return Derived().Cols(); }
+    Matrix eval() const;    /* defined in matrix.h */
+};
+
+template<typename L, typename R> class MatrixSum;
+template<typename L, typename R> class MatrixDifference;
+template<typename E> class MatrixScale;
+template<typename L, typename R> class MatrixProduct;
+
+/* Type to evaluate an expression into */
+template<typename E>
+struct MatrixEvaluated { using type = Matrix; };
+
+/* How an operand is held in a coefficient-wise expression: Matrix by reference, product evaluated, others by value */
+template<typename E>
+struct MatrixCoeffOperand { using type = const E; };
+template<>
+struct MatrixCoeffOperand<Matrix> { using type = const Matrix&; };
+template<typename L, typename R>
+struct MatrixCoeffOperand<MatrixProduct<L, R>> { using type = const Matrix; };
+
+/* How an operand is held in a product: Matrix by reference, left product by value (streamed row by row), others evaluated */
+template<typename E>
+struct MatrixProductLeftOperand { using type = const Matrix; };
+template<>
+struct MatrixProductLeftOperand<Matrix> { using type = const Matrix&; };
+template<typename L, typename R>
+struct MatrixProductLeftOperand<MatrixProduct<L, R>> { using type = const MatrixProduct<L, R>; };
+
+template<typename E>
+struct MatrixProductRightOperand { using type = const Matrix; };
+template<>
+struct MatrixProductRightOperand<Matrix> { using type = const Matrix&; };
+
+/* Whether writing the result coefficient-wise into mat breaks reading the operand.
+ * A Matrix operand is read at the same index as written, so it is safe. A view or a nested expression may not be */
+template<typename E>
+bool IsCoeffAliased(const E& operand, const Matrix& mat) { return operand.References(mat); }
+inline bool IsCoeffAliased(const Matrix&, const Matrix&) { return false; }
+
+
+template<typename L, typename R>
+class MatrixSum : public MatrixExpression<MatrixSum<L, R>>
+{
+public:
+    MatrixSum(const L& left, const R& right)
+        : m_left(left), m_right(right)
+    {
+        if ((m_left.Rows() != m_right.Rows()) || (m_left.Cols() != m_right.Cols())) throw std::out_of_range("Invalid index");
+    }
+    int32_t Rows() const { return m_left.Rows(); }
+    int32_t Cols() const { return m_left.Cols(); }
+    float Coeff(int32_t i) const { return m_left.Coeff(i) + m_right.Coeff(i); }
+    bool References(const Matrix& mat) const { return IsCoeffAliased(m_left, mat) || IsCoeffAliased(m_right, mat); }
+    void EvaluateTo(float* dst) const
+    {
+        const int32_t size = Rows() * Cols();
+        for (int32_t i = 0; i < size; i++) dst[i] = Coeff(i);
+    }
+
+private:
+    typename MatrixCoeffOperand<L>::type m_left;
+    typename MatrixCoeffOperand<R>::type m_right;
+};
+
+template<typename L, typename R>
+class MatrixDifference : public MatrixExpression<MatrixDifference<L, R>>
+{
+public:
+    MatrixDifference(const L& left, const R& right)
+        : m_left(left), m_right(right)
+    {
+        if ((m_left.Rows() != m_right.Rows()) || (m_left.Cols() != m_right.Cols())) throw std::out_of_range("Invalid index");
+    }
+    int32_t Rows() const { return m_left.Rows(); }
+    int32_t Cols() const { return m_left.Cols(); }
+    float Coeff(int32_t i) const { return m_left.Coeff(i) - m_right.Coeff(i); }
+    bool References(const Matrix& mat) const { return IsCoeffAliased(m_left, mat) || IsCoeffAliased(m_right, mat); }
+    void EvaluateTo(float* dst) const
+    {
+        const int32_t size = Rows() * Cols();
+        for (int32_t i = 0; i < size; i++) dst[i] = Coeff(i);
+    }
+
+private:
+    typename MatrixCoeffOperand<L>::type m_left;
+    typename MatrixCoeffOperand<R>::type m_right;
+};
+
+template<typename E>
+class MatrixScale : public MatrixExpression<MatrixScale<E>>
+{
+public:
+    MatrixScale(const E& mat, float k)
+        : m_mat(mat), m_k(k)
+    {
+        // do nothing
+    }
+    int32_t Rows() const { return m_mat.Rows(); }
+    int32_t Cols() const { return m_mat.Cols(); }
+    float Coeff(int32_t i) const { return m_mat.Coeff(i) * m_k; }
+    bool References(const Matrix& mat) const { return IsCoeffAliased(m_mat, mat); }
+    void EvaluateTo(float* dst) const
+    {
+        const int32_t size = Rows() * Cols();
+        for (int32_t i = 0; i < size; i++) dst[i] = Coeff(i);
+    }
+
+private:
+    typename MatrixCoeffOperand<E>::type m_mat;
+    float m_k;
+};
+
+template<typename L, typename R>
+class MatrixProduct : public MatrixExpression<MatrixProduct<L, R>>
+{
+public:
+    MatrixProduct(const L& left, const R& right)
+        : m_left(left), m_right(right)
+    {
+        if (m_left.Cols() != m_right.Rows()) throw std::out_of_range("Invalid index");
+    }
+    int32_t Rows() const { return m_left.Rows(); }
+    int32_t Cols() const { return m_right.Cols(); }
+
+    bool References(const Matrix& mat) const
+    {
+        return IsReferenced(m_left, mat) || IsReferenced(m_right, mat);
+    }
+
+    /* Number of floats needed to stream rows of the intermediate products */
+    int32_t ScratchSize() const
+    {
+        return LeftScratchSize(m_left);
+    }
+
+    /* Calculate one row of the result into dst. scratch must have ScratchSize() floats */
+    void EvaluateRow(int32_t row, float* dst, float* scratch) const
+    {
+        const int32_t inner = m_left.Cols();
+        const int32_t cols = m_right.Cols();
+        const float* left_row = LeftRow(m_left, row, scratch);
+        const float* right = m_right.Data();
+        for (int32_t col = 0; col < cols; col++) dst[col] = 0.0f;
+        for (int32_t i = 0; i < inner; i++) {
+            const float l = left_row[i];
+            const float* right_row = right + static_cast<size_t>(i) * cols;
+            for (int32_t col = 0; col < cols; col++) {
+                dst[col] += l * right_row[col];
+            }
+        }
+    }
+
+    void EvaluateTo(float* dst) const
+    {
+        if (MatrixGemm::IsLargeSize(Rows(), Cols(), m_left.Cols())) {
+            typename MatrixEvaluated<L>::type left_evaluated;
+            const float* left = LeftData(m_left, left_evaluated);
+            MatrixGemm::Multiply(left, m_right.Data(), dst, Rows(), Cols(), m_left.Cols());
+            return;
+        }
+
+        static constexpr int32_t STACK_SCRATCH_SIZE = 64;
+        float stack_scratch[STACK_SCRATCH_SIZE];
+        std::vector<float> heap_scratch;
+        float* scratch = stack_scratch;
+        const int32_t scratch_size = ScratchSize();
+        if (scratch_size > STACK_SCRATCH_SIZE) {
+            heap_scratch.resize(scratch_size);
+            scratch = heap_scratch.data();
+        }
+        const int32_t rows = Rows();
+        const int32_t cols = Cols();
+        for (int32_t row = 0; row < rows; row++) {
+            EvaluateRow(row, dst + static_cast<size_t>(row) * cols, scratch);
+        }
+    }
+
+private:
+    /* The generic version is for Matrix. The overloads for MatrixProduct are for the streamed left operand */
+    template<typename M>
+    static bool IsReferenced(const M& operand, const Matrix& mat) { return &operand == &mat; }
+    template<typename LL, typename LR>
+    static bool IsReferenced(const MatrixProduct<LL, LR>& operand, const Matrix& mat) { return operand.References(mat); }
+
+    template<typename M>
+    static int32_t LeftScratchSize(const M&) { return 0; }
+    template<typename LL, typename LR>
+    static int32_t LeftScratchSize(const MatrixProduct<LL, LR>& left) { return left.Cols() + left.ScratchSize(); }
+
+    template<typename M, typename T>
+    static const float* LeftData(const M& left, T&) { return left.Data(); }
+    template<typename LL, typename LR, typename T>
+    static const float* LeftData(const MatrixProduct<LL, LR>& left, T& left_evaluated)
+    {
+        left_evaluated = left;
+        return left_evaluated.Data();
+    }
+
+    template<typename M>
+    static const float* LeftRow(const M& left, int32_t row, float*)
+    {
+        return left.Data() + static_cast<size_t>(row) * left.Cols();
+    }
+    template<typename LL, typename LR>
+    static const float* LeftRow(const MatrixProduct<LL, LR>& left, int32_t row, float* scratch)
+    {
+        left.EvaluateRow(row, scratch, scratch + left.Cols());
+        return scratch;
+    }
+
+private:
+    typename MatrixProductLeftOperand<L>::type m_left;
+    typename MatrixProductRightOperand<R>::type m_right;
+};
+
+
+/*** Operators ***/
+template<typename L, typename R>
+MatrixSum<L, R> operator+(const MatrixExpression<L>& left, const MatrixExpression<R>& right)
+{
+    return MatrixSum<L, R>(left.Derived(), right.Derived());
+}
+
+template<typename L, typename R>
+MatrixDifference<L, R> operator-(const MatrixExpression<L>& left, const MatrixExpression<R>& right)
+{
+    return MatrixDifference<L, R>(left.Derived(), right.Derived());
+}
+
+template<typename E>
+MatrixScale<E> operator*(const MatrixExpression<E>& mat, const float& k)
+{
+    return MatrixScale<E>(mat.Derived(), k);
+}
+
+template<typename L, typename R>
+MatrixProduct<L, R> operator*(const MatrixExpression<L>& left, const MatrixExpression<R>& right)
+{
+    return MatrixProduct<L, R>(left.Derived(), right.Derived());
+}
+
+#endif
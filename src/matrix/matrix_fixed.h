@@ -0,0 +1,294 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_FIXED_H
+#define MATRIX_FIXED_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "matrix.h"
+
+/* Compile-time sized matrix. Elements are stored inline (row-major), so no heap allocation happens */
+template<int32_t ROWS, int32_t COLS>
+class MatrixFixed
+{
+    static_assert(ROWS > 0 && COLS > 0, "size must be greater than 0");
+
+public:
+    MatrixFixed()
+    {
+        m_data_array.fill(0.0f);
+    }
+
+    MatrixFixed(const std::array<float, ROWS * COLS>& data)
+        : m_data_array(data)
+    {
+        // do nothing
+    }
+
+    explicit MatrixFixed(const float* data)
+    {
+        std::copy(data, data + ROWS * COLS, m_data_array.data());
+    }
+
+    explicit MatrixFixed(const Matrix& mat)
+    {
+        if (mat.Rows() != ROWS || mat.Cols() != COLS) throw std::out_of_range("Invalid shape");
+        std::copy(mat.Data(), mat.Data() + ROWS * COLS, m_data_array.data());
+    }
+
+    /* template so that a braced list is never taken as a view */
+    template<typename VIEW, typename = typename std::enable_if<std::is_base_of<ConstMatrixView, VIEW>::value>::type>
+    explicit MatrixFixed(const VIEW& view)
+    {
+        if (view.Rows() != ROWS || view.Cols() != COLS) throw std::out_of_range("Invalid shape");
+        view.EvaluateTo(m_data_array.data());
+    }
+
+    operator ConstMatrixView() const
+    {
+        return ConstMatrixView(Data(), ROWS, COLS, COLS);
+    }
+
+    explicit operator Matrix() const
+    {
+        return Matrix(ROWS, COLS, m_data_array.data());
+    }
+
+    static constexpr int32_t Rows() { return ROWS; }
+    static constexpr int32_t Cols() { return COLS; }
+
+    const float* Data() const
+    {
+        return m_data_array.data();
+    }
+
+    float* Data()
+    {
+        return m_data_array.data();
+    }
+
+    /* Element access is checked only when MATRIX_BOUNDS_CHECK is defined, same as Matrix */
+#ifdef MATRIX_BOUNDS_CHECK
+    const float& operator[](int32_t i) const
+    {
+        return m_data_array.at(i);
+    }
+
+    float& operator[](int32_t i)
+    {
+        return m_data_array.at(i);
+    }
+
+    float& operator() (int32_t row, int32_t col)
+    {
+        if (row < 0 || row >= ROWS || col < 0 || col >= COLS) throw std::out_of_range("Invalid index");
+        return m_data_array[row * COLS + col];
+    }
+
+    const float& operator() (int32_t row, int32_t col) const
+    {
+        if (row < 0 || row >= ROWS || col < 0 || col >= COLS) throw std::out_of_range("Invalid index");
+        return m_data_array[row * COLS + col];
+    }
+#else
+    const float& operator[](int32_t i) const
+    {
+        return m_data_array[i];
+    }
+
+    float& operator[](int32_t i)
+    {
+        return m_data_array[i];
+    }
+
+    float& operator() (int32_t row, int32_t col)
+    {
+        return m_data_array[row * COLS + col];
+    }
+
+    const float& operator() (int32_t row, int32_t col) const
+    {
+        return m_data_array[row * COLS + col];
+    }
+#endif
+
+    MatrixView Block(int32_t row, int32_t col, int32_t rows, int32_t cols)
+    {
+        CheckBlock(row, col, rows, cols);
+        return MatrixView(Data() + row * COLS + col, rows, cols, COLS);
+    }
+
+    ConstMatrixView Block(int32_t row, int32_t col, int32_t rows, int32_t cols) const
+    {
+        CheckBlock(row, col, rows, cols);
+        return ConstMatrixView(Data() + row * COLS + col, rows, cols, COLS);
+    }
+
+    MatrixView Row(int32_t row) { return Block(row, 0, 1, COLS); }
+    ConstMatrixView Row(int32_t row) const { return Block(row, 0, 1, COLS); }
+    MatrixView Col(int32_t col) { return Block(0, col, ROWS, 1); }
+    ConstMatrixView Col(int32_t col) const { return Block(0, col, ROWS, 1); }
+
+    MatrixFixed operator+(const MatrixFixed& right) const
+    {
+        MatrixFixed ret;
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            ret.m_data_array[i] = m_data_array[i] + right.m_data_array[i];
+        }
+        return ret;
+    }
+
+    MatrixFixed operator-(const MatrixFixed& right) const
+    {
+        MatrixFixed ret;
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            ret.m_data_array[i] = m_data_array[i] - right.m_data_array[i];
+        }
+        return ret;
+    }
+
+    MatrixFixed operator*(const float& k) const
+    {
+        MatrixFixed ret;
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            ret.m_data_array[i] = m_data_array[i] * k;
+        }
+        return ret;
+    }
+
+    template<int32_t RIGHT_COLS>
+    MatrixFixed<ROWS, RIGHT_COLS> operator*(const MatrixFixed<COLS, RIGHT_COLS>& right) const
+    {
+        MatrixFixed<ROWS, RIGHT_COLS> ret;
+        const float* r = right.Data();
+        float* d = ret.Data();
+        for (int32_t row = 0; row < ROWS; row++) {
+            for (int32_t i = 0; i < COLS; i++) {
+                const float l = m_data_array[row * COLS + i];
+                for (int32_t col = 0; col < RIGHT_COLS; col++) {
+                    d[row * RIGHT_COLS + col] += l * r[i * RIGHT_COLS + col];
+                }
+            }
+        }
+        return ret;
+    }
+
+    MatrixFixed& operator+=(const MatrixFixed& right)
+    {
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            m_data_array[i] += right.m_data_array[i];
+        }
+        return *this;
+    }
+
+    MatrixFixed& operator-=(const MatrixFixed& right)
+    {
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            m_data_array[i] -= right.m_data_array[i];
+        }
+        return *this;
+    }
+
+    MatrixFixed& operator*=(const float& k)
+    {
+        for (int32_t i = 0; i < ROWS * COLS; i++) {
+            m_data_array[i] *= k;
+        }
+        return *this;
+    }
+
+    MatrixFixed& operator*=(const MatrixFixed<COLS, COLS>& right)
+    {
+        return *this = *this * right;
+    }
+
+    MatrixFixed<COLS, ROWS> Transpose() const
+    {
+        MatrixFixed<COLS, ROWS> ret;
+        float* d = ret.Data();
+        for (int32_t row = 0; row < ROWS; row++) {
+            for (int32_t col = 0; col < COLS; col++) {
+                d[col * ROWS + row] = m_data_array[row * COLS + col];
+            }
+        }
+        return ret;
+    }
+
+    MatrixFixed Inverse(MATRIX_STRUCTURE structure = MATRIX_STRUCTURE::GENERAL) const
+    {
+        static_assert(ROWS == COLS, "Invalid shape");
+        MatrixFixed ret;
+        MatrixInverse::Invert(Data(), ret.Data(), ROWS, structure);
+        return ret;
+    }
+
+    void Print() const
+    {
+        static_cast<Matrix>(*this).Print();
+    }
+
+    static MatrixFixed Identity()
+    {
+        static_assert(ROWS == COLS, "Invalid shape");
+        MatrixFixed ret;
+        for (int32_t i = 0; i < ROWS; i++) {
+            ret.m_data_array[i * COLS + i] = 1.0f;
+        }
+        return ret;
+    }
+
+private:
+    static void CheckBlock(int32_t row, int32_t col, int32_t rows, int32_t cols)
+    {
+        if (row < 0 || col < 0 || rows <= 0 || cols <= 0 || row + rows > ROWS || col + cols > COLS) {
+            throw std::out_of_range("Invalid index");
+        }
+    }
+
+private:
+    std::array<float, ROWS * COLS> m_data_array;
+};
+
+/* Same as MultiplyInto/TransposeInto/InverseInto for Matrix. The result is calculated on the stack, so dst can be one of the inputs */
+template<int32_t ROWS, int32_t INNER, int32_t COLS>
+void MultiplyInto(MatrixFixed<ROWS, COLS>& dst, const MatrixFixed<ROWS, INNER>& left, const MatrixFixed<INNER, COLS>& right)
+{
+    dst = left * right;
+}
+
+template<int32_t ROWS, int32_t COLS>
+void TransposeInto(MatrixFixed<COLS, ROWS>& dst, const MatrixFixed<ROWS, COLS>& mat)
+{
+    dst = mat.Transpose();
+}
+
+template<int32_t SIZE>
+void InverseInto(MatrixFixed<SIZE, SIZE>& dst, const MatrixFixed<SIZE, SIZE>& mat, MATRIX_STRUCTURE structure = MATRIX_STRUCTURE::GENERAL)
+{
+    dst = mat.Inverse(structure);
+}
+
+using Mat3 = MatrixFixed<3, 3>;
+using Mat4 = MatrixFixed<4, 4>;
+using Vec3 = MatrixFixed<3, 1>;
+using Vec4 = MatrixFixed<4, 1>;
+
+#endif
@@ -0,0 +1,285 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+#include <functional>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include "matrix_gemm.h"
+#include "matrix_thread_pool.h"
+
+/*** Macro ***/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEMM_USE_SSE
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEMM_USE_AVX2
+#define GEMM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+/* Block sizes: a KC x NR panel of B stays in L1, an MC x KC block of A in L2 */
+static constexpr int32_t KC = 256;
+static constexpr int32_t MC = 96;       /* multiple of all MR */
+static constexpr int32_t NC = 2048;     /* multiple of all NR */
+static constexpr int64_t LARGE_SIZE_THRESHOLD = 32 * 32 * 32;   /* m * n * k */
+
+/*** Global variable ***/
+
+/*** Function ***/
+/* Micro kernels calculate c (MR x NR, row stride = ldc) += a_pack (KC x MR) * b_pack (KC x NR) */
+typedef void (*MicroKernelFunc)(int32_t kc, const float* a_pack, const float* b_pack, float* c, int32_t ldc);
+
+struct MicroKernel {
+    const char* name;
+    int32_t mr;
+    int32_t nr;
+    MicroKernelFunc func;
+};
+
+#ifndef GEMM_USE_SSE
+static void MicroKernelScalar4x4(int32_t kc, const float* a_pack, const float* b_pack, float* c, int32_t ldc)
+{
+    float acc[4][4] = {};
+    for (int32_t p = 0; p < kc; p++) {
+        const float* a = a_pack + p * 4;
+        const float* b = b_pack + p * 4;
+        for (int32_t i = 0; i < 4; i++) {
+            for (int32_t j = 0; j < 4; j++) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+    }
+    for (int32_t i = 0; i < 4; i++) {
+        for (int32_t j = 0; j < 4; j++) {
+            c[i * ldc + j] += acc[i][j];
+        }
+    }
+}
+#endif
+
+#ifdef GEMM_USE_SSE
+static void MicroKernelSse4x8(int32_t kc, const float* a_pack, const float* b_pack, float* c, int32_t ldc)
+{
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+    for (int32_t p = 0; p < kc; p++) {
+        const __m128 b0 = _mm_loadu_ps(b_pack + p * 8);
+        const __m128 b1 = _mm_loadu_ps(b_pack + p * 8 + 4);
+        const float* a = a_pack + p * 4;
+        __m128 a_i = _mm_set1_ps(a[0]);
+        c00 = _mm_add_ps(c00, _mm_mul_ps(a_i, b0));
+        c01 = _mm_add_ps(c01, _mm_mul_ps(a_i, b1));
+        a_i = _mm_set1_ps(a[1]);
+        c10 = _mm_add_ps(c10, _mm_mul_ps(a_i, b0));
+        c11 = _mm_add_ps(c11, _mm_mul_ps(a_i, b1));
+        a_i = _mm_set1_ps(a[2]);
+        c20 = _mm_add_ps(c20, _mm_mul_ps(a_i, b0));
+        c21 = _mm_add_ps(c21, _mm_mul_ps(a_i, b1));
+        a_i = _mm_set1_ps(a[3]);
+        c30 = _mm_add_ps(c30, _mm_mul_ps(a_i, b0));
+        c31 = _mm_add_ps(c31, _mm_mul_ps(a_i, b1));
+    }
+    _mm_storeu_ps(c + 0 * ldc, _mm_add_ps(_mm_loadu_ps(c + 0 * ldc), c00));
+    _mm_storeu_ps(c + 0 * ldc + 4, _mm_add_ps(_mm_loadu_ps(c + 0 * ldc + 4), c01));
+    _mm_storeu_ps(c + 1 * ldc, _mm_add_ps(_mm_loadu_ps(c + 1 * ldc), c10));
+    _mm_storeu_ps(c + 1 * ldc + 4, _mm_add_ps(_mm_loadu_ps(c + 1 * ldc + 4), c11));
+    _mm_storeu_ps(c + 2 * ldc, _mm_add_ps(_mm_loadu_ps(c + 2 * ldc), c20));
+    _mm_storeu_ps(c + 2 * ldc + 4, _mm_add_ps(_mm_loadu_ps(c + 2 * ldc + 4), c21));
+    _mm_storeu_ps(c + 3 * ldc, _mm_add_ps(_mm_loadu_ps(c + 3 * ldc), c30));
+    _mm_storeu_ps(c + 3 * ldc + 4, _mm_add_ps(_mm_loadu_ps(c + 3 * ldc + 4), c31));
+}
+#endif
+
+#ifdef GEMM_USE_AVX2
+GEMM_TARGET_AVX2
+static void MicroKernelAvx2_6x16(int32_t kc, const float* a_pack, const float* b_pack, float* c, int32_t ldc)
+{
+    __m256 acc[6][2];
+    for (int32_t i = 0; i < 6; i++) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+    for (int32_t p = 0; p < kc; p++) {
+        const __m256 b0 = _mm256_loadu_ps(b_pack + p * 16);
+        const __m256 b1 = _mm256_loadu_ps(b_pack + p * 16 + 8);
+        const float* a = a_pack + p * 6;
+        for (int32_t i = 0; i < 6; i++) {
+            const __m256 a_i = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(a_i, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(a_i, b1, acc[i][1]);
+        }
+    }
+    for (int32_t i = 0; i < 6; i++) {
+        float* c_row = c + i * ldc;
+        _mm256_storeu_ps(c_row, _mm256_add_ps(_mm256_loadu_ps(c_row), acc[i][0]));
+        _mm256_storeu_ps(c_row + 8, _mm256_add_ps(_mm256_loadu_ps(c_row + 8), acc[i][1]));
+    }
+}
+
+static bool IsAvx2Supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+static const MicroKernel& SelectMicroKernel()
+{
+    static const MicroKernel kernel = []() {
+#ifdef GEMM_USE_AVX2
+        if (IsAvx2Supported()) return MicroKernel{ "avx2", 6, 16, MicroKernelAvx2_6x16 };
+#endif
+#ifdef GEMM_USE_SSE
+        return MicroKernel{ "sse", 4, 8, MicroKernelSse4x8 };
+#else
+        return MicroKernel{ "scalar", 4, 4, MicroKernelScalar4x4 };
+#endif
+    }();
+    return kernel;
+}
+
+/* Pack a (mc x kc) block of A into panels of MR rows. Each panel is stored as kc columns of MR values (zero padded) */
+static void PackA(const float* a, int32_t lda, int32_t mc, int32_t kc, int32_t mr, float* a_pack)
+{
+    for (int32_t ir = 0; ir < mc; ir += mr) {
+        const int32_t rows = std::min(mr, mc - ir);
+        for (int32_t p = 0; p < kc; p++) {
+            for (int32_t i = 0; i < rows; i++) {
+                a_pack[p * mr + i] = a[static_cast<size_t>(ir + i) * lda + p];
+            }
+            for (int32_t i = rows; i < mr; i++) {
+                a_pack[p * mr + i] = 0.0f;
+            }
+        }
+        a_pack += static_cast<size_t>(kc) * mr;
+    }
+}
+
+/* Pack a (kc x nc) block of B into panels of NR columns. Each panel is stored as kc rows of NR values (zero padded) */
+static void PackB(const float* b, int32_t ldb, int32_t kc, int32_t nc, int32_t nr, float* b_pack)
+{
+    for (int32_t jr = 0; jr < nc; jr += nr) {
+        const int32_t cols = std::min(nr, nc - jr);
+        for (int32_t p = 0; p < kc; p++) {
+            const float* b_row = b + static_cast<size_t>(p) * ldb + jr;
+            for (int32_t j = 0; j < cols; j++) {
+                b_pack[p * nr + j] = b_row[j];
+            }
+            for (int32_t j = cols; j < nr; j++) {
+                b_pack[p * nr + j] = 0.0f;
+            }
+        }
+        b_pack += static_cast<size_t>(kc) * nr;
+    }
+}
+
+/* c_block (mc x nc, row stride = ldc) += packed A block * packed B block */
+static void MacroKernel(const MicroKernel& kernel, int32_t mc, int32_t nc, int32_t kc, const float* a_pack, const float* b_pack, float* c_block, int32_t ldc)
+{
+    const int32_t mr = kernel.mr;
+    const int32_t nr = kernel.nr;
+    float tile[16 * 16];    /* for edge tiles. large enough for all micro kernels */
+    for (int32_t jr = 0; jr < nc; jr += nr) {
+        const int32_t cols = std::min(nr, nc - jr);
+        const float* b_panel = b_pack + static_cast<size_t>(jr / nr) * kc * nr;
+        for (int32_t ir = 0; ir < mc; ir += mr) {
+            const int32_t rows = std::min(mr, mc - ir);
+            const float* a_panel = a_pack + static_cast<size_t>(ir / mr) * kc * mr;
+            float* c_tile = c_block + static_cast<size_t>(ir) * ldc + jr;
+            if (rows == mr && cols == nr) {
+                kernel.func(kc, a_panel, b_panel, c_tile, ldc);
+            } else {
+                std::fill(tile, tile + mr * nr, 0.0f);
+                kernel.func(kc, a_panel, b_panel, tile, nr);
+                for (int32_t i = 0; i < rows; i++) {
+                    for (int32_t j = 0; j < cols; j++) {
+                        c_tile[static_cast<size_t>(i) * ldc + j] += tile[i * nr + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void MatrixGemm::Multiply(const float* a, const float* b, float* c, int32_t m, int32_t n, int32_t k)
+{
+    const MicroKernel& kernel = SelectMicroKernel();
+    const int32_t mr = kernel.mr;
+    const int32_t nr = kernel.nr;
+
+    /* Blocks of rows (and panels of B while packing) are distributed over threads for a large product */
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    const bool is_parallel = pool.IsParallelSize(static_cast<int64_t>(m) * n * k);
+    const auto parallel_for = [&pool, is_parallel](int32_t begin, int32_t end, const std::function<void(int32_t, int32_t)>& func) {
+        if (is_parallel) {
+            pool.ParallelFor(begin, end, func);
+        } else {
+            func(begin, end);
+        }
+    };
+
+    /* Make row blocks smaller than MC if there are not enough blocks for all threads */
+    int32_t mc_block = MC;
+    if (is_parallel) {
+        const int32_t thread_num = pool.GetThreadNum();
+        const int32_t rows_per_thread = (m + thread_num - 1) / thread_num;
+        mc_block = std::max(mr, std::min(MC, (rows_per_thread + mr - 1) / mr * mr));
+    }
+    const int32_t block_num = (m + mc_block - 1) / mc_block;
+
+    std::fill(c, c + static_cast<size_t>(m) * n, 0.0f);
+    std::vector<float> b_pack(static_cast<size_t>(KC) * (std::min(NC, n) + nr));
+
+    for (int32_t jc = 0; jc < n; jc += NC) {
+        const int32_t nc = std::min(NC, n - jc);
+        const int32_t panel_num = (nc + nr - 1) / nr;
+        for (int32_t pc = 0; pc < k; pc += KC) {
+            const int32_t kc = std::min(KC, k - pc);
+            parallel_for(0, panel_num, [&](int32_t panel_begin, int32_t panel_end) {
+                const int32_t col = panel_begin * nr;
+                PackB(b + static_cast<size_t>(pc) * n + jc + col, n, kc, std::min(nc - col, (panel_end - panel_begin) * nr), nr,
+                    b_pack.data() + static_cast<size_t>(panel_begin) * kc * nr);
+            });
+            parallel_for(0, block_num, [&](int32_t block_begin, int32_t block_end) {
+                static thread_local std::vector<float> a_pack;
+                a_pack.resize(static_cast<size_t>(MC) * KC);
+                for (int32_t block = block_begin; block < block_end; block++) {
+                    const int32_t ic = block * mc_block;
+                    const int32_t mc = std::min(mc_block, m - ic);
+                    PackA(a + static_cast<size_t>(ic) * k + pc, k, mc, kc, mr, a_pack.data());
+                    MacroKernel(kernel, mc, nc, kc, a_pack.data(), b_pack.data(), c + static_cast<size_t>(ic) * n + jc, n);
+                }
+            });
+        }
+    }
+}
+
+bool MatrixGemm::IsLargeSize(int32_t m, int32_t n, int32_t k)
+{
+    return static_cast<int64_t>(m) * n * k >= LARGE_SIZE_THRESHOLD;
+}
+
+const char* MatrixGemm::GetKernelName()
+{
+    return SelectMicroKernel().name;
+}
@@ -0,0 +1,35 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_GEMM_H
+#define MATRIX_GEMM_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+/* Cache-blocked, packed matrix multiplication used by Matrix::operator* for large matrices */
+namespace MatrixGemm
+{
+    /* c (m x n) = a (m x k) * b (k x n). All matrices are row-major and densely stored. c must not overlap a or b */
+    void Multiply(const float* a, const float* b, float* c, int32_t m, int32_t n, int32_t k);
+
+    /* Return true if the size is large enough for Multiply to be faster than a simple loop */
+    bool IsLargeSize(int32_t m, int32_t n, int32_t k);
+
+    /* Name of the micro kernel selected for this CPU (e.g. "avx2", "sse", "scalar") */
+    const char* GetKernelName();
+}
+
+#endif
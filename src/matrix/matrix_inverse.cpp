@@ -0,0 +1,284 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <stdexcept>
+
+#include "matrix_inverse.h"
+#include "matrix_thread_pool.h"
+
+/*** Macro ***/
+
+/*** Global variable ***/
+
+/*** Function ***/
+static void ThrowSingular()
+{
+    throw std::out_of_range("Tried to calculate an inverse of non - singular matrix");
+}
+
+static void InvertCofactor2x2(const float* m, float* dst)
+{
+    const float det = m[0] * m[3] - m[1] * m[2];
+    if (det == 0) ThrowSingular();
+    const float inv_det = 1.0f / det;
+    dst[0] = m[3] * inv_det;
+    dst[1] = -m[1] * inv_det;
+    dst[2] = -m[2] * inv_det;
+    dst[3] = m[0] * inv_det;
+}
+
+static void InvertCofactor3x3(const float* m, float* dst)
+{
+    const float c00 = m[4] * m[8] - m[5] * m[7];
+    const float c01 = m[5] * m[6] - m[3] * m[8];
+    const float c02 = m[3] * m[7] - m[4] * m[6];
+    const float det = m[0] * c00 + m[1] * c01 + m[2] * c02;
+    if (det == 0) ThrowSingular();
+    const float inv_det = 1.0f / det;
+    dst[0] = c00 * inv_det;
+    dst[1] = (m[2] * m[7] - m[1] * m[8]) * inv_det;
+    dst[2] = (m[1] * m[5] - m[2] * m[4]) * inv_det;
+    dst[3] = c01 * inv_det;
+    dst[4] = (m[0] * m[8] - m[2] * m[6]) * inv_det;
+    dst[5] = (m[2] * m[3] - m[0] * m[5]) * inv_det;
+    dst[6] = c02 * inv_det;
+    dst[7] = (m[1] * m[6] - m[0] * m[7]) * inv_det;
+    dst[8] = (m[0] * m[4] - m[1] * m[3]) * inv_det;
+}
+
+static void InvertCofactor4x4(const float* m, float* dst)
+{
+    /* 2x2 minors of the upper two rows (s) and the lower two rows (c) */
+    const float s0 = m[0] * m[5] - m[4] * m[1];
+    const float s1 = m[0] * m[6] - m[4] * m[2];
+    const float s2 = m[0] * m[7] - m[4] * m[3];
+    const float s3 = m[1] * m[6] - m[5] * m[2];
+    const float s4 = m[1] * m[7] - m[5] * m[3];
+    const float s5 = m[2] * m[7] - m[6] * m[3];
+    const float c0 = m[8] * m[13] - m[12] * m[9];
+    const float c1 = m[8] * m[14] - m[12] * m[10];
+    const float c2 = m[8] * m[15] - m[12] * m[11];
+    const float c3 = m[9] * m[14] - m[13] * m[10];
+    const float c4 = m[9] * m[15] - m[13] * m[11];
+    const float c5 = m[10] * m[15] - m[14] * m[11];
+    const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (det == 0) ThrowSingular();
+    const float inv_det = 1.0f / det;
+    dst[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inv_det;
+    dst[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inv_det;
+    dst[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inv_det;
+    dst[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inv_det;
+    dst[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inv_det;
+    dst[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inv_det;
+    dst[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inv_det;
+    dst[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inv_det;
+    dst[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inv_det;
+    dst[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inv_det;
+    dst[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inv_det;
+    dst[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inv_det;
+    dst[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inv_det;
+    dst[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inv_det;
+    dst[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inv_det;
+    dst[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inv_det;
+}
+
+/* PA = LU with partial pivoting, then solve LU x = P e_col for each column. Rows (and columns) are distributed over threads for a large matrix */
+static void InvertLu(const float* src, float* dst, int32_t n)
+{
+    std::vector<float> lu(src, src + static_cast<size_t>(n) * n);
+    std::vector<int32_t> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    const bool is_parallel = pool.IsParallelSize(static_cast<int64_t>(n) * n * n);
+
+    for (int32_t k = 0; k < n; k++) {
+        int32_t pivot = k;
+        for (int32_t i = k + 1; i < n; i++) {
+            if (std::abs(lu[i * n + k]) > std::abs(lu[pivot * n + k])) pivot = i;
+        }
+        if (lu[pivot * n + k] == 0) ThrowSingular();
+        if (pivot != k) {
+            std::swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n, lu.begin() + pivot * n);
+            std::swap(perm[k], perm[pivot]);
+        }
+
+        float* a = lu.data();
+        const float inv_pivot = 1.0f / a[k * n + k];
+        const auto eliminate = [a, n, k, inv_pivot](int32_t i_begin, int32_t i_end) {
+            for (int32_t i = i_begin; i < i_end; i++) {
+                const float l = a[i * n + k] * inv_pivot;
+                a[i * n + k] = l;
+                for (int32_t j = k + 1; j < n; j++) {
+                    a[i * n + j] -= l * a[k * n + j];
+                }
+            }
+        };
+        if (is_parallel) {
+            pool.ParallelFor(k + 1, n, eliminate);
+        } else {
+            eliminate(k + 1, n);
+        }
+    }
+
+    const float* a = lu.data();
+    const int32_t* p = perm.data();
+    const auto solve = [a, p, n, dst](int32_t col_begin, int32_t col_end) {
+        std::vector<float> x(n);
+        for (int32_t col = col_begin; col < col_end; col++) {
+            /* L y = P e_col (y is stored in x) */
+            for (int32_t i = 0; i < n; i++) {
+                float sum = (p[i] == col) ? 1.0f : 0.0f;
+                for (int32_t j = 0; j < i; j++) sum -= a[i * n + j] * x[j];
+                x[i] = sum;
+            }
+            /* U x = y */
+            for (int32_t i = n - 1; i >= 0; i--) {
+                float sum = x[i];
+                for (int32_t j = i + 1; j < n; j++) sum -= a[i * n + j] * x[j];
+                x[i] = sum / a[i * n + i];
+            }
+            for (int32_t i = 0; i < n; i++) dst[i * n + col] = x[i];
+        }
+    };
+    if (is_parallel) {
+        pool.ParallelFor(0, n, solve);
+    } else {
+        solve(0, n);
+    }
+}
+
+static void InvertGeneral(const float* src, float* dst, int32_t n)
+{
+    switch (n) {
+    case 1:
+        if (src[0] == 0) ThrowSingular();
+        dst[0] = 1.0f / src[0];
+        break;
+    case 2:
+        InvertCofactor2x2(src, dst);
+        break;
+    case 3:
+        InvertCofactor3x3(src, dst);
+        break;
+    case 4:
+        InvertCofactor4x4(src, dst);
+        break;
+    default:
+        InvertLu(src, dst, n);
+        break;
+    }
+}
+
+static void InvertRotation(const float* src, float* dst, int32_t n)
+{
+    for (int32_t row = 0; row < n; row++) {
+        for (int32_t col = 0; col < n; col++) {
+            dst[col * n + row] = src[row * n + col];
+        }
+    }
+}
+
+/* [A t; 0 1]^-1 = [A^-1 -A^-1*t; 0 1]. a_inv is the inverse of the upper-left block */
+static void ComposeAffineInverse(const float* src, const float* a_inv, float* dst, int32_t n)
+{
+    const int32_t m = n - 1;
+    for (int32_t row = 0; row < m; row++) {
+        float t = 0;
+        for (int32_t col = 0; col < m; col++) {
+            dst[row * n + col] = a_inv[row * m + col];
+            t -= a_inv[row * m + col] * src[col * n + m];
+        }
+        dst[row * n + m] = t;
+    }
+    for (int32_t col = 0; col < m; col++) {
+        dst[m * n + col] = 0.0f;
+    }
+    dst[m * n + m] = 1.0f;
+}
+
+/* [R t; 0 1]^-1 = [R^T -R^T*t; 0 1], written to dst directly */
+static void InvertRigid(const float* src, float* dst, int32_t n)
+{
+    const int32_t m = n - 1;
+    for (int32_t row = 0; row < m; row++) {
+        float t = 0;
+        for (int32_t col = 0; col < m; col++) {
+            dst[row * n + col] = src[col * n + row];
+            t -= src[col * n + row] * src[col * n + m];
+        }
+        dst[row * n + m] = t;
+    }
+    for (int32_t col = 0; col < m; col++) {
+        dst[m * n + col] = 0.0f;
+    }
+    dst[m * n + m] = 1.0f;
+}
+
+static void InvertAffine(const float* src, float* dst, int32_t n, bool is_rigid)
+{
+    if (n < 2) {
+        throw std::out_of_range("Invalid shape");
+    }
+    if (is_rigid) {
+        InvertRigid(src, dst, n);
+        return;
+    }
+
+    /* The upper-left block is inverted in a buffer on the stack for n <= 4 (cofactor formula), and on the heap otherwise */
+    static constexpr int32_t STACK_BLOCK_SIZE = 3;
+    const int32_t m = n - 1;
+    float a_stack[STACK_BLOCK_SIZE * STACK_BLOCK_SIZE];
+    float a_inv_stack[STACK_BLOCK_SIZE * STACK_BLOCK_SIZE];
+    std::vector<float> a_heap;
+    std::vector<float> a_inv_heap;
+    float* a = a_stack;
+    float* a_inv = a_inv_stack;
+    if (m > STACK_BLOCK_SIZE) {
+        a_heap.resize(static_cast<size_t>(m) * m);
+        a_inv_heap.resize(static_cast<size_t>(m) * m);
+        a = a_heap.data();
+        a_inv = a_inv_heap.data();
+    }
+    for (int32_t row = 0; row < m; row++) {
+        std::copy(src + row * n, src + row * n + m, a + row * m);
+    }
+    InvertGeneral(a, a_inv, m);
+    ComposeAffineInverse(src, a_inv, dst, n);
+}
+
+void MatrixInverse::Invert(const float* src, float* dst, int32_t n, MATRIX_STRUCTURE structure)
+{
+    switch (structure) {
+    case MATRIX_STRUCTURE::ROTATION:
+        InvertRotation(src, dst, n);
+        break;
+    case MATRIX_STRUCTURE::RIGID:
+        InvertAffine(src, dst, n, true);
+        break;
+    case MATRIX_STRUCTURE::AFFINE:
+        InvertAffine(src, dst, n, false);
+        break;
+    case MATRIX_STRUCTURE::GENERAL:
+    default:
+        InvertGeneral(src, dst, n);
+        break;
+    }
+}
@@ -0,0 +1,39 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_INVERSE_H
+#define MATRIX_INVERSE_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+/* Known structure of a square matrix, used to pick a cheaper way to calculate its inverse */
+enum class MATRIX_STRUCTURE {
+    GENERAL = 0,    /* no assumption */
+    ROTATION,       /* orthonormal matrix. The inverse is the transpose */
+    RIGID,          /* [R t; 0 1] with orthonormal R. The inverse is [R^T -R^T*t; 0 1] */
+    AFFINE,         /* [A t; 0 1]. The inverse is [A^-1 -A^-1*t; 0 1] */
+};
+
+/* Inverse of row-major, densely stored square matrices */
+namespace MatrixInverse
+{
+    /* dst (n x n) = src^-1. The structure is trusted and not verified. dst must not overlap src.
+     * A general matrix uses the cofactor formula for n <= 4 and LU decomposition with partial pivoting otherwise.
+     * Throw std::out_of_range if the matrix is singular */
+    void Invert(const float* src, float* dst, int32_t n, MATRIX_STRUCTURE structure = MATRIX_STRUCTURE::GENERAL);
+}
+
+#endif
@@ -0,0 +1,149 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_STORAGE_H
+#define MATRIX_STORAGE_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+
+/*
+ * Element storage of Matrix with the same interface as the subset of std::vector<float> used by Matrix.
+ * Up to INLINE_SIZE elements (enough for 3x1, 4x1, 3x3 and 4x4) are kept inside the object, so creating small matrices doesn't allocate.
+ * Larger sizes are allocated on the heap. The heap buffer is reused when the size shrinks or grows within its capacity.
+ */
+class MatrixStorage
+{
+public:
+    static constexpr size_t INLINE_SIZE = 16;
+
+    MatrixStorage()
+        : m_data(m_inline_data), m_size(0), m_capacity(INLINE_SIZE)
+    {
+        // do nothing
+    }
+
+    explicit MatrixStorage(size_t size)
+        : MatrixStorage()
+    {
+        resize(size);
+    }
+
+    MatrixStorage(const std::vector<float>& data)
+        : MatrixStorage()
+    {
+        assign(data.data(), data.size());
+    }
+
+    MatrixStorage(const MatrixStorage& other)
+        : MatrixStorage()
+    {
+        assign(other.m_data, other.m_size);
+    }
+
+    MatrixStorage(MatrixStorage&& other) noexcept
+        : MatrixStorage()
+    {
+        take(other);
+    }
+
+    MatrixStorage& operator=(const MatrixStorage& other)
+    {
+        if (this != &other) assign(other.m_data, other.m_size);
+        return *this;
+    }
+
+    MatrixStorage& operator=(MatrixStorage&& other) noexcept
+    {
+        if (this != &other) take(other);
+        return *this;
+    }
+
+    size_t size() const { return m_size; }
+    bool is_inline() const { return m_data == m_inline_data; }
+
+    const float* data() const { return m_data; }
+    float* data() { return m_data; }
+    const float* begin() const { return m_data; }
+    const float* end() const { return m_data + m_size; }
+
+    const float& operator[](size_t i) const { return m_data[i]; }
+    float& operator[](size_t i) { return m_data[i]; }
+
+    const float& at(size_t i) const
+    {
+        if (i >= m_size) throw std::out_of_range("Invalid index");
+        return m_data[i];
+    }
+
+    float& at(size_t i)
+    {
+        if (i >= m_size) throw std::out_of_range("Invalid index");
+        return m_data[i];
+    }
+
+    /* Existing elements are kept and new elements are filled with 0, like std::vector */
+    void resize(size_t size)
+    {
+        if (size > m_capacity) {
+            std::unique_ptr<float[]> heap_data(new float[size]);
+            std::copy(m_data, m_data + m_size, heap_data.get());
+            m_heap_data = std::move(heap_data);
+            m_data = m_heap_data.get();
+            m_capacity = size;
+        }
+        if (size > m_size) std::fill(m_data + m_size, m_data + size, 0.0f);
+        m_size = size;
+    }
+
+private:
+    void assign(const float* data, size_t size)
+    {
+        m_size = 0;     /* no need to keep the current elements */
+        resize(size);
+        std::copy(data, data + size, m_data);
+    }
+
+    /* Inline elements must be copied, while a heap buffer can be handed over. other becomes empty */
+    void take(MatrixStorage& other) noexcept
+    {
+        if (other.is_inline()) {
+            std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        } else {
+            m_heap_data = std::move(other.m_heap_data);
+            m_data = m_heap_data.get();
+            m_capacity = other.m_capacity;
+        }
+        m_size = other.m_size;
+        other.m_heap_data.reset();
+        other.m_data = other.m_inline_data;
+        other.m_size = 0;
+        other.m_capacity = INLINE_SIZE;
+    }
+
+private:
+    float m_inline_data[INLINE_SIZE];
+    std::unique_ptr<float[]> m_heap_data;
+    float* m_data;
+    size_t m_size;
+    size_t m_capacity;
+};
+
+#endif
@@ -0,0 +1,212 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "matrix_thread_pool.h"
+
+/*** Macro ***/
+static constexpr int32_t CHUNK_NUM_PER_THREAD = 4;      /* split a loop finer than the number of threads so that stealing can balance the load */
+static constexpr int64_t DEFAULT_PARALLEL_THRESHOLD = 64 * 64 * 64;
+
+/*** Global variable ***/
+static thread_local int32_t s_worker_index = -1;        /* -1 if the thread is not a worker */
+
+/*** Function ***/
+MatrixThreadPool& MatrixThreadPool::GetInstance()
+{
+    static MatrixThreadPool instance;
+    return instance;
+}
+
+MatrixThreadPool::MatrixThreadPool()
+    : m_queued_num(0), m_push_index(0), m_parallel_threshold(DEFAULT_PARALLEL_THRESHOLD), m_is_stop(false)
+{
+    SetThreadNum(0);
+}
+
+MatrixThreadPool::~MatrixThreadPool()
+{
+    Stop();
+}
+
+void MatrixThreadPool::SetThreadNum(int32_t thread_num)
+{
+    if (thread_num < 0) {
+        throw std::invalid_argument("thread_num must be 0 or greater");
+    }
+    if (thread_num == 0) {
+        thread_num = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    }
+#ifdef __EMSCRIPTEN__
+    thread_num = 1;
+#endif
+    Stop();
+    Start(thread_num - 1);
+}
+
+int32_t MatrixThreadPool::GetThreadNum() const
+{
+    return static_cast<int32_t>(m_thread_list.size()) + 1;
+}
+
+void MatrixThreadPool::SetParallelThreshold(int64_t work)
+{
+    m_parallel_threshold = work;
+}
+
+int64_t MatrixThreadPool::GetParallelThreshold() const
+{
+    return m_parallel_threshold;
+}
+
+bool MatrixThreadPool::IsParallelSize(int64_t work) const
+{
+    return (GetThreadNum() > 1) && (work >= m_parallel_threshold);
+}
+
+void MatrixThreadPool::ParallelFor(int32_t begin, int32_t end, const std::function<void(int32_t, int32_t)>& func)
+{
+    const int32_t size = end - begin;
+    if (size <= 0) return;
+    const int32_t thread_num = GetThreadNum();
+    const int32_t chunk_num = std::min(size, thread_num * CHUNK_NUM_PER_THREAD);
+    if (thread_num == 1 || chunk_num == 1) {
+        func(begin, end);
+        return;
+    }
+
+    std::atomic<int32_t> remaining_num(chunk_num);
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+    for (int32_t chunk = 0; chunk < chunk_num; chunk++) {
+        const int32_t chunk_begin = begin + static_cast<int32_t>(static_cast<int64_t>(size) * chunk / chunk_num);
+        const int32_t chunk_end = begin + static_cast<int32_t>(static_cast<int64_t>(size) * (chunk + 1) / chunk_num);
+        PushTask([&func, &remaining_num, &exception_mutex, &exception, chunk_begin, chunk_end]() {
+            try {
+                func(chunk_begin, chunk_end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!exception) exception = std::current_exception();
+            }
+            remaining_num--;    /* must be the last access to the variables of ParallelFor */
+        });
+    }
+
+    /* The calling thread also runs tasks until all the chunks are done */
+    std::function<void()> task;
+    while (remaining_num > 0) {
+        if (PopTask(s_worker_index, task)) {
+            task();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void MatrixThreadPool::Start(int32_t worker_num)
+{
+    m_is_stop = false;
+    m_queue_list.clear();
+    for (int32_t i = 0; i < std::max(worker_num, 1); i++) {
+        m_queue_list.push_back(std::unique_ptr<TaskQueue>(new TaskQueue));
+    }
+    for (int32_t i = 0; i < worker_num; i++) {
+        m_thread_list.push_back(std::thread(&MatrixThreadPool::WorkerLoop, this, i));
+    }
+}
+
+void MatrixThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_is_stop = true;
+    }
+    m_sleep_cv.notify_all();
+    for (auto& thread : m_thread_list) {
+        thread.join();
+    }
+    m_thread_list.clear();
+}
+
+void MatrixThreadPool::WorkerLoop(int32_t index)
+{
+    s_worker_index = index;
+    std::function<void()> task;
+    while (true) {
+        if (PopTask(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleep_cv.wait(lock, [this]() { return m_is_stop || m_queued_num > 0; });
+        if (m_is_stop && m_queued_num <= 0) break;
+    }
+    s_worker_index = -1;
+}
+
+void MatrixThreadPool::PushTask(std::function<void()> task)
+{
+    /* A worker pushes into its own queue. Other threads spread tasks over the queues */
+    const int32_t queue_num = static_cast<int32_t>(m_queue_list.size());
+    const int32_t index = (s_worker_index >= 0) ? s_worker_index : static_cast<int32_t>(m_push_index++ % queue_num);
+    {
+        std::lock_guard<std::mutex> lock(m_queue_list[index]->mutex);
+        m_queue_list[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_queued_num++;
+    }
+    m_sleep_cv.notify_one();
+}
+
+bool MatrixThreadPool::PopTask(int32_t index, std::function<void()>& task)
+{
+    const int32_t queue_num = static_cast<int32_t>(m_queue_list.size());
+    if (index >= 0) {
+        /* LIFO from its own queue */
+        TaskQueue& queue = *m_queue_list[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            m_queued_num--;
+            return true;
+        }
+    }
+
+    /* Steal the oldest task from the others */
+    const int32_t start = (index >= 0) ? index + 1 : 0;
+    for (int32_t i = 0; i < queue_num; i++) {
+        TaskQueue& queue = *m_queue_list[(start + i) % queue_num];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_queued_num--;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,83 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_THREAD_POOL_H
+#define MATRIX_THREAD_POOL_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+/*
+ * Work-stealing thread pool used by the heavy Matrix operations (large products and Inverse).
+ * Each worker has its own task queue. A worker pops tasks from the back of its own queue and steals from the front of the others
+ * when it runs out of work. The thread calling ParallelFor also runs tasks until the loop completes, so nested calls are safe.
+ * Operations whose amount of work is below the parallel threshold run on the calling thread, so small matrices (e.g. 3x3, 4x4)
+ * never pay for dispatch.
+ */
+class MatrixThreadPool
+{
+public:
+    static MatrixThreadPool& GetInstance();
+
+    /* Number of threads including the calling thread. 0 means the number of hardware threads. Don't call it while the pool is in use */
+    void SetThreadNum(int32_t thread_num);
+    int32_t GetThreadNum() const;
+
+    /* Minimum amount of work (the number of multiply-adds, e.g. m * n * k for a product) to use multiple threads */
+    void SetParallelThreshold(int64_t work);
+    int64_t GetParallelThreshold() const;
+    bool IsParallelSize(int64_t work) const;
+
+    /* Call func(chunk_begin, chunk_end) for chunks covering [begin, end) in parallel, and wait for all of them.
+     * An exception thrown by func is re-thrown on the calling thread */
+    void ParallelFor(int32_t begin, int32_t end, const std::function<void(int32_t, int32_t)>& func);
+
+private:
+    MatrixThreadPool();
+    ~MatrixThreadPool();
+    MatrixThreadPool(const MatrixThreadPool&) = delete;
+    MatrixThreadPool& operator=(const MatrixThreadPool&) = delete;
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void Start(int32_t worker_num);
+    void Stop();
+    void WorkerLoop(int32_t index);
+    void PushTask(std::function<void()> task);
+    bool PopTask(int32_t index, std::function<void()>& task);
+
+private:
+    std::vector<std::unique_ptr<TaskQueue>> m_queue_list;
+    std::vector<std::thread> m_thread_list;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cv;
+    std::atomic<int32_t> m_queued_num;
+    std::atomic<uint32_t> m_push_index;
+    std::atomic<int64_t> m_parallel_threshold;
+    bool m_is_stop;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+#include "matrix_expression.h"
+
+/*
+ * Non-owning views of a part of a matrix (a block, a row or a column), created by Matrix::Block/Row/Col.
+ * A view refers the elements of the original matrix with a row stride, so nothing is copied.
+ * A view can be used in arithmetic expressions like a Matrix, and a MatrixView can be assigned to write into the original matrix.
+ *
+ * Note: a view must not outlive the matrix it refers, and must not be used after the matrix is resized.
+ * Note: a view used in a product is copied into a temporary (inline for small blocks), since the product kernel needs dense rows.
+ */
+class ConstMatrixView : public MatrixExpression<ConstMatrixView>
+{
+public:
+    explicit ConstMatrixView(const float* data, int32_t rows, int32_t cols, int32_t stride)
+        : m_data(data), m_rows(rows), m_cols(cols), m_stride(stride)
+    {
+        // do nothing
+    }
+
+    int32_t Rows() const { return m_rows; }
+    int32_t Cols() const { return m_cols; }
+    int32_t Stride() const { return m_stride; }
+    const float* Data() const { return m_data; }
+
+    const float& operator() (int32_t row, int32_t col) const
+    {
+#ifdef MATRIX_BOUNDS_CHECK
+        if (row < 0 || row >= m_rows || col < 0 || col >= m_cols) throw std::out_of_range("Invalid index");
+#endif
+        return m_data[row * m_stride + col];
+    }
+
+    float Coeff(int32_t i) const
+    {
+        if (m_stride == m_cols) return m_data[i];
+        return m_data[(i / m_cols) * m_stride + i % m_cols];
+    }
+
+    /* True if the view overlaps the elements of mat */
+    template<typename M>
+    bool References(const M& mat) const
+    {
+        const float* begin = mat.Data();
+        const float* end = begin + mat.Rows() * mat.Cols();
+        return (m_data < end) && (m_data + (m_rows - 1) * m_stride + m_cols > begin);
+    }
+
+    void EvaluateTo(float* dst) const
+    {
+        for (int32_t row = 0; row < m_rows; row++) {
+            const float* src = m_data + row * m_stride;
+            for (int32_t col = 0; col < m_cols; col++) {
+                *dst++ = src[col];
+            }
+        }
+    }
+
+protected:
+    const float* m_data;
+    int32_t m_rows;
+    int32_t m_cols;
+    int32_t m_stride;
+};
+
+class MatrixView : public ConstMatrixView
+{
+public:
+    explicit MatrixView(float* data, int32_t rows, int32_t cols, int32_t stride)
+        : ConstMatrixView(data, rows, cols, stride)
+    {
+        // do nothing
+    }
+
+    float* Data() const { return const_cast<float*>(m_data); }
+
+    float& operator() (int32_t row, int32_t col) const
+    {
+        return const_cast<float&>(ConstMatrixView::operator()(row, col));
+    }
+
+    /* Assignment writes elements into the original matrix. The shape must be the same */
+    MatrixView& operator=(const MatrixView& view)
+    {
+        return Assign(view);
+    }
+
+    MatrixView& operator=(const ConstMatrixView& view)
+    {
+        return Assign(view);
+    }
+
+    template<typename E>
+    MatrixView& operator=(const MatrixExpression<E>& expr)
+    {
+        return Assign(expr.Derived());
+    }
+
+private:
+    template<typename E>
+    MatrixView& Assign(const E& expr)
+    {
+        if (expr.Rows() != m_rows || expr.Cols() != m_cols) throw std::out_of_range("Invalid shape");
+        /* evaluate first, because the expression may read the elements of this view */
+        const typename MatrixEvaluated<E>::type evaluated(expr);
+        const float* src = evaluated.Data();
+        float* dst = Data();
+        for (int32_t row = 0; row < m_rows; row++) {
+            for (int32_t col = 0; col < m_cols; col++) {
+                dst[row * m_stride + col] = *src++;
+            }
+        }
+        return *this;
+    }
+};
+
+#endif
@@ -0,0 +1,377 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+/* for my modules */
+#include "matrix_thread_pool.h"
+#include "converter.h"
+#include "batch_converter.h"
+#include "trajectory_file.h"
+#include "conversion_pipeline.h"
+
+/*** Macro ***/
+/* Setting */
+static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;   /* bytes of input converted by a task */
+static constexpr int32_t CHUNK_NUM_PER_THREAD = 4;          /* chunks in flight (or read at once) per thread, to balance the load */
+static constexpr int32_t DEFAULT_PRECISION = 7;
+
+/*** Global variable ***/
+
+/*** Function ***/
+struct Option {
+    std::string input_path;
+    std::string output_path;
+    BatchConverter::Setting setting;
+    bool is_trajectory_input;
+    bool is_trajectory_output;
+    int32_t thread_num;
+    size_t chunk_size;
+    bool is_header;
+    bool is_verbose;
+};
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "Usage: rotation_convert --from TYPE --to TYPE[,TYPE...] [options]\n"
+        "Convert rotations (one per record) from a representation into other representations.\n"
+        "\n"
+        "TYPE: matrix, rotation_vector, axis_angle, quaternion, euler_mobile[:ORDER], euler_fixed[:ORDER]\n"
+        "      ORDER: XYZ (default), XZY, YXZ, YZX, ZXY, ZYX\n"
+        "\n"
+        "Options:\n"
+        "  --input FILE             input file ('-' for stdin, default)\n"
+        "  --output FILE            output file ('-' for stdout, default)\n"
+        "  --input-format FORMAT    csv (default), binary (float32 records) or trajectory\n"
+        "  --output-format FORMAT   csv (default), binary (float32 records) or trajectory\n"
+        "                           trajectory: file of trajectory_file.h (not stdin / stdout). --from is read from the file,\n"
+        "                           and --to must be one representation. Timestamps are kept from trajectory to trajectory\n"
+        "  --threads N              number of threads (0 = hardware threads, default)\n"
+        "  --chunk-size BYTES       bytes of input converted by a task (default %zu)\n"
+        "  --precision N            digits after the decimal point of CSV output (0 - 9, default %d)\n"
+        "  --degree                 angles are in degree (default radian. Not for trajectory files)\n"
+        "  --no-normalize           don't normalize input rotation matrices\n"
+        "  --header                 write the header line to CSV output\n"
+        "  --verbose                print the throughput (and the statistics of the pipeline stages) to stderr\n",
+        DEFAULT_CHUNK_SIZE, DEFAULT_PRECISION);
+}
+
+/* A trajectory file is converted as binary records */
+static void ParseFormat(const std::string& name, BatchConverter::FORMAT& format, bool& is_trajectory)
+{
+    if (name == "csv") {
+        format = BatchConverter::FORMAT::CSV;
+        is_trajectory = false;
+    } else if (name == "binary" || name == "trajectory") {
+        format = BatchConverter::FORMAT::BINARY;
+        is_trajectory = (name == "trajectory");
+    } else {
+        throw std::invalid_argument("Unknown format: " + name);
+    }
+}
+
+static int64_t ParseInteger(const std::string& text, int64_t min_value, int64_t max_value)
+{
+    char* end = nullptr;
+    const long long value = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < min_value || value > max_value) {
+        throw std::invalid_argument("Invalid number: " + text);
+    }
+    return value;
+}
+
+/* Return false if help is requested. Throw std::invalid_argument for invalid arguments */
+static bool ParseArguments(int argc, char* argv[], Option& option)
+{
+    option.input_path = "-";
+    option.output_path = "-";
+    option.setting.input = { REPRESENTATION_TYPE::ROTATION_MATRIX, RotationMatrix::EULER_ORDER::XYZ };
+    option.setting.input_format = BatchConverter::FORMAT::CSV;
+    option.setting.output_format = BatchConverter::FORMAT::CSV;
+    option.setting.is_normalize_rotation_matrix = true;
+    option.setting.is_degree = false;
+    option.setting.precision = DEFAULT_PRECISION;
+    option.is_trajectory_input = false;
+    option.is_trajectory_output = false;
+    option.thread_num = 0;
+    option.chunk_size = DEFAULT_CHUNK_SIZE;
+    option.is_header = false;
+    option.is_verbose = false;
+
+    bool has_input = false;
+    for (int32_t i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const auto GetValue = [&]() {
+            if (i + 1 >= argc) throw std::invalid_argument("No value for " + arg);
+            return std::string(argv[++i]);
+        };
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (arg == "--from") {
+            option.setting.input = Converter::ParseRepresentation(GetValue());
+            has_input = true;
+        } else if (arg == "--to") {
+            const std::string list = GetValue();
+            for (size_t first = 0; first <= list.size(); ) {
+                const size_t comma = std::min(list.find(',', first), list.size());
+                option.setting.output_list.push_back(Converter::ParseRepresentation(list.substr(first, comma - first)));
+                first = comma + 1;
+            }
+        } else if (arg == "--input") {
+            option.input_path = GetValue();
+        } else if (arg == "--output") {
+            option.output_path = GetValue();
+        } else if (arg == "--input-format") {
+            ParseFormat(GetValue(), option.setting.input_format, option.is_trajectory_input);
+        } else if (arg == "--output-format") {
+            ParseFormat(GetValue(), option.setting.output_format, option.is_trajectory_output);
+        } else if (arg == "--threads") {
+            option.thread_num = static_cast<int32_t>(ParseInteger(GetValue(), 0, 1024));
+        } else if (arg == "--chunk-size") {
+            option.chunk_size = static_cast<size_t>(ParseInteger(GetValue(), 1024, 1024 * 1024 * 1024));
+        } else if (arg == "--precision") {
+            option.setting.precision = static_cast<int32_t>(ParseInteger(GetValue(), 0, 9));
+        } else if (arg == "--degree") {
+            option.setting.is_degree = true;
+        } else if (arg == "--no-normalize") {
+            option.setting.is_normalize_rotation_matrix = false;
+        } else if (arg == "--header") {
+            option.is_header = true;
+        } else if (arg == "--verbose") {
+            option.is_verbose = true;
+        } else {
+            throw std::invalid_argument("Unknown argument: " + arg);
+        }
+    }
+    if (!has_input && !option.is_trajectory_input) throw std::invalid_argument("--from is not specified");
+    if (option.setting.output_list.empty()) throw std::invalid_argument("--to is not specified");
+    if (option.is_trajectory_input && option.input_path == "-") throw std::invalid_argument("Trajectory input must be a file");
+    if (option.is_trajectory_output && option.output_path == "-") throw std::invalid_argument("Trajectory output must be a file");
+    if (option.is_trajectory_output && option.setting.output_list.size() != 1) throw std::invalid_argument("Trajectory output must be one representation");
+    if ((option.is_trajectory_input || option.is_trajectory_output) && option.setting.is_degree) throw std::invalid_argument("Angles of trajectory files are radian (--degree can't be used)");
+    return true;
+}
+
+static FILE* OpenFile(const std::string& path, bool is_input)
+{
+    if (path == "-") {
+        FILE* fp = is_input ? stdin : stdout;
+#ifdef _WIN32
+        _setmode(_fileno(fp), _O_BINARY);
+#endif
+        return fp;
+    }
+    FILE* fp = fopen(path.c_str(), is_input ? "rb" : "wb");
+    if (!fp) throw std::runtime_error("Failed to open " + path);
+    return fp;
+}
+
+/* A file (or stdout), or a trajectory file */
+struct Output {
+    FILE* fp;
+    std::unique_ptr<TrajectoryWriter> trajectory_writer;
+    std::vector<float> record_list;
+};
+
+static void OpenOutput(const Option& option, bool has_timestamp, Output& output)
+{
+    if (option.is_trajectory_output) {
+        output.trajectory_writer.reset(new TrajectoryWriter(option.output_path, option.setting.output_list[0], has_timestamp));
+    } else {
+        output.fp = OpenFile(option.output_path, false);
+    }
+}
+
+static void Write(const char* data, size_t size, FILE* fp)
+{
+    if (size > 0 && fwrite(data, 1, size, fp) != size) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+/* data is binary records for a trajectory file. timestamp_list is used only if the trajectory file has timestamps */
+static void Write(const std::string& data, const int64_t* timestamp_list, Output& output)
+{
+    if (output.trajectory_writer) {
+        output.record_list.resize(data.size() / sizeof(float));
+        std::memcpy(output.record_list.data(), data.data(), output.record_list.size() * sizeof(float));
+        output.trajectory_writer->AppendRecords(output.record_list.data(), output.record_list.size() / output.trajectory_writer->GetComponentNum(), timestamp_list);
+    } else {
+        Write(data.data(), data.size(), output.fp);
+    }
+}
+
+/* Read what is available (up to size) like read(2), so that slow input (e.g. a sensor stream on a pipe) is converted as it arrives.
+ * Return 0 at the end of the input */
+static size_t Read(char* buffer, size_t size, FILE* fp)
+{
+#ifdef _WIN32
+    const int read_byte = _read(_fileno(fp), buffer, static_cast<unsigned int>(std::min<size_t>(size, INT32_MAX)));
+#else
+    ssize_t read_byte;
+    do {
+        read_byte = read(fileno(fp), buffer, size);
+    } while (read_byte < 0 && errno == EINTR);
+#endif
+    if (read_byte < 0) throw std::runtime_error("Failed to read input");
+    return static_cast<size_t>(read_byte);
+}
+
+static void WriteHeader(const Option& option, const BatchConverter& converter, Output& output)
+{
+    if (option.is_header && option.setting.output_format == BatchConverter::FORMAT::CSV) {
+        const std::string header = converter.GetHeader();
+        Write(header.data(), header.size(), output.fp);
+    }
+}
+
+static void CloseOutput(Output& output)
+{
+    if (output.trajectory_writer) {
+        output.trajectory_writer->Commit();
+    } else if (fflush(output.fp) != 0) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+static void PrintStageStatistics(const char* name, const ConversionPipeline::StageStatistics& statistics)
+{
+    fprintf(stderr, "  %-9s: %6lld chunks, %8.1f MB, busy %.3f sec, wait %.3f sec\n",
+        name, static_cast<long long>(statistics.chunk_num), statistics.byte_num * 1e-6, statistics.busy_time, statistics.wait_time);
+}
+
+/* Read, convert (by the threads) and write chunks in a pipeline, and write the results in order. Return the number of rotations */
+static int64_t Run(const Option& option, FILE* input_fp, Output& output)
+{
+    const BatchConverter converter(option.setting);
+    ConversionPipeline::Setting pipeline_setting;
+    pipeline_setting.worker_num = MatrixThreadPool::GetInstance().GetThreadNum();
+    pipeline_setting.chunk_size = option.chunk_size;
+    pipeline_setting.chunk_num = pipeline_setting.worker_num * CHUNK_NUM_PER_THREAD;
+    WriteHeader(option, converter, output);
+
+    ConversionPipeline pipeline(converter, pipeline_setting);
+    const int64_t record_num = pipeline.Run(
+        [input_fp](char* buffer, size_t size) {
+            return Read(buffer, size, input_fp);
+        },
+        [&output](const std::string& data, int64_t) {
+            /* Flushed per chunk, so that the output of slow input isn't held in the buffer */
+            Write(data, nullptr, output);
+            if (output.fp && fflush(output.fp) != 0) throw std::runtime_error("Failed to write output");
+        });
+
+    if (option.is_verbose) {
+        /* The stage with the least wait time is the bottleneck */
+        const ConversionPipeline::Statistics statistics = pipeline.GetStatistics();
+        PrintStageStatistics("reader", statistics.reader);
+        PrintStageStatistics("converter", statistics.converter);
+        PrintStageStatistics("writer", statistics.writer);
+        fprintf(stderr, "  max queue depth: input %d, output %d (of %d chunks)\n",
+            statistics.max_input_queue_depth, statistics.max_output_queue_depth, pipeline_setting.chunk_num);
+    }
+    return record_num;
+}
+
+/* Convert the blocks of a mapped trajectory file in parallel without parsing nor copy, and write the results in order */
+static int64_t RunTrajectory(const Option& option, const TrajectoryReader& reader, Output& output)
+{
+    BatchConverter::Setting setting = option.setting;
+    setting.input = reader.GetRepresentation();
+    const BatchConverter converter(setting);
+    MatrixThreadPool& thread_pool = MatrixThreadPool::GetInstance();
+    const int64_t block_num_per_round = static_cast<int64_t>(thread_pool.GetThreadNum()) * CHUNK_NUM_PER_THREAD;
+    WriteHeader(option, converter, output);
+
+    std::vector<std::string> output_list;
+    for (int64_t first_block = 0; first_block < reader.GetBlockNum(); first_block += block_num_per_round) {
+        const int32_t block_num = static_cast<int32_t>(std::min(block_num_per_round, reader.GetBlockNum() - first_block));
+        output_list.resize(block_num);
+        thread_pool.ParallelFor(0, block_num, [&](int32_t begin, int32_t end) {
+            for (int32_t i = begin; i < end; i++) {
+                output_list[i].clear();
+                converter.ConvertPlanes(reader.GetBlockPlanes(first_block + i), reader.GetBlockCapacity(), reader.GetBlockRecordNum(first_block + i), output_list[i]);
+            }
+        });
+        for (int32_t i = 0; i < block_num; i++) {
+            Write(output_list[i], reader.GetBlockTimestamps(first_block + i), output);
+        }
+    }
+    return reader.GetCount();
+}
+
+int main(int argc, char *argv[])
+{
+    Option option;
+    try {
+        if (!ParseArguments(argc, argv, option)) {
+            PrintUsage();
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Error: %s\n\n", e.what());
+        PrintUsage();
+        return 1;
+    }
+
+    FILE* input_fp = nullptr;
+    Output output = {};
+    int32_t ret = 0;
+    try {
+        MatrixThreadPool::GetInstance().SetThreadNum(option.thread_num);
+        const auto time_start = std::chrono::steady_clock::now();
+        int64_t record_num = 0;
+        if (option.is_trajectory_input) {
+            const TrajectoryReader reader(option.input_path);
+            OpenOutput(option, reader.HasTimestamp(), output);
+            record_num = RunTrajectory(option, reader, output);
+        } else {
+            input_fp = OpenFile(option.input_path, true);
+            OpenOutput(option, false, output);
+            record_num = Run(option, input_fp, output);
+        }
+        CloseOutput(output);
+        const double time_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+        if (option.is_verbose) {
+            fprintf(stderr, "%lld rotations in %.3f sec (%.1f M rotations/sec, %d threads)\n",
+                static_cast<long long>(record_num), time_elapsed, record_num / std::max(time_elapsed, 1e-9) * 1e-6, MatrixThreadPool::GetInstance().GetThreadNum());
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Error: %s\n", e.what());
+        ret = 1;
+    }
+    if (input_fp && input_fp != stdin) fclose(input_fp);
+    if (output.fp && output.fp != stdout && fclose(output.fp) != 0) ret = 1;
+    return ret;
+}
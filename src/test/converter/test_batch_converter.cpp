@@ -0,0 +1,190 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "float_text.h"
+#include "converter.h"
+#include "batch_converter.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestBatchConverter : public testing::Test
+{
+protected:
+    TestBatchConverter() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestBatchConverter() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static BatchConverter::Setting CreateSetting(const char* input, const std::vector<const char*>& output_list)
+{
+    BatchConverter::Setting setting;
+    setting.input = Converter::ParseRepresentation(input);
+    for (const char* output : output_list) setting.output_list.push_back(Converter::ParseRepresentation(output));
+    setting.input_format = BatchConverter::FORMAT::CSV;
+    setting.output_format = BatchConverter::FORMAT::CSV;
+    setting.is_normalize_rotation_matrix = true;
+    setting.is_degree = false;
+    setting.precision = 4;
+    return setting;
+}
+
+static std::string Convert(const BatchConverter& converter, const std::string& input)
+{
+    std::string output;
+    converter.ConvertChunk(input.data(), input.size(), output);
+    return output;
+}
+
+TEST_F(TestBatchConverter, Csv)
+{
+    const BatchConverter converter(CreateSetting("axis_angle", { "quaternion", "rotation_vector" }));
+    EXPECT_EQ(converter.GetHeader(), "qx,qy,qz,qw,vx,vy,vz\n");
+
+    /* Header, comments, empty lines, spaces, CR and no new line at the end */
+    const std::string input =
+        "ax,ay,az,angle\n"
+        "# comment\n"
+        "\n"
+        "0,0,1,0\r\n"
+        "  1, 0, 0, 3\n"
+        "0 1 0 1.5707963\t\n"
+        "0,0,1,-1.5707963,";
+    std::string output;
+    EXPECT_EQ(converter.ConvertChunk(input.data(), input.size(), output, true), 4);
+    EXPECT_EQ(output,
+        "0.0000,0.0000,0.0000,1.0000,0.0000,0.0000,0.0000\n"
+        "0.9975,0.0000,0.0000,0.0707,3.0000,0.0000,0.0000\n"
+        "0.0000,0.7071,0.0000,0.7071,0.0000,1.5708,0.0000\n"
+        "0.0000,0.0000,-0.7071,0.7071,0.0000,0.0000,-1.5708\n");
+
+    /* Invalid records */
+    EXPECT_THROW(Convert(converter, "0,0,1\n"), std::runtime_error);
+    EXPECT_THROW(Convert(converter, "0,0,1,0,5\n"), std::runtime_error);
+    EXPECT_THROW(Convert(converter, "0,0,1,x\n"), std::runtime_error);
+    EXPECT_THROW(Convert(converter, "0,0,1,0.5.5\n"), std::runtime_error);
+
+    /* A header is only at the first line of the input. A word anywhere else is an invalid value */
+    EXPECT_THROW(converter.ConvertChunk(input.data(), input.size(), output), std::runtime_error);
+    const std::string input_corrupt = "ax,ay,az,angle\n0,0,1,0\nx0.5,0,0,1\n";
+    EXPECT_THROW(converter.ConvertChunk(input_corrupt.data(), input_corrupt.size(), output, true), std::runtime_error);
+    const std::string input_comment_first = "# comment\nax,ay,az,angle\n0,0,1,0\n";
+    EXPECT_THROW(converter.ConvertChunk(input_comment_first.data(), input_comment_first.size(), output, true), std::runtime_error);
+}
+
+TEST_F(TestBatchConverter, Degree)
+{
+    BatchConverter::Setting setting = CreateSetting("euler_mobile:ZYX", { "euler_fixed:XYZ", "axis_angle" });
+    setting.is_degree = true;
+    setting.precision = 2;
+    const BatchConverter converter(setting);
+    /* Mobile ZYX is the same rotation as fixed XYZ */
+    EXPECT_EQ(Convert(converter, "10,20,30\n").substr(0, 18), "10.00,20.00,30.00,");
+    EXPECT_EQ(Convert(converter, "90,0,0\n"), "90.00,0.00,0.00,1.00,0.00,0.00,90.00\n");
+}
+
+TEST_F(TestBatchConverter, Binary)
+{
+    BatchConverter::Setting setting = CreateSetting("quaternion", { "matrix" });
+    setting.input_format = BatchConverter::FORMAT::BINARY;
+    setting.output_format = BatchConverter::FORMAT::BINARY;
+    const BatchConverter converter(setting);
+    EXPECT_EQ(converter.GetInputRecordSize(), 16u);
+    EXPECT_EQ(converter.GetOutputRecordSize(), 36u);
+
+    static constexpr int32_t NUM = 5000;    /* more than a block */
+    std::vector<float> input(NUM * 4);
+    for (int32_t i = 0; i < NUM; i++) {
+        const float angle = 0.001f * i;
+        input[i * 4 + 0] = 0.0f;
+        input[i * 4 + 1] = 0.0f;
+        input[i * 4 + 2] = std::sin(angle / 2);
+        input[i * 4 + 3] = std::cos(angle / 2);
+    }
+    std::string output;
+    EXPECT_EQ(converter.ConvertChunk(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(float), output), NUM);
+    ASSERT_EQ(output.size(), NUM * 36u);
+    for (int32_t i = 0; i < NUM; i += 99) {
+        float mat3_rot[9];
+        std::memcpy(mat3_rot, output.data() + i * 36, sizeof(mat3_rot));
+        const float angle = 0.001f * i;
+        EXPECT_NEAR(mat3_rot[0], std::cos(angle), 1e-5f);
+        EXPECT_NEAR(mat3_rot[1], -std::sin(angle), 1e-5f);
+        EXPECT_NEAR(mat3_rot[3], std::sin(angle), 1e-5f);
+        EXPECT_NEAR(mat3_rot[8], 1.0f, 1e-5f);
+    }
+
+    EXPECT_EQ(converter.FindChunkEnd(nullptr, 100), 96u);
+    EXPECT_THROW(converter.ConvertChunk(reinterpret_cast<const char*>(input.data()), 20, output), std::runtime_error);
+}
+
+TEST_F(TestBatchConverter, Chunk)
+{
+    const BatchConverter converter(CreateSetting("rotation_vector", { "quaternion" }));
+    std::string input;
+    char line[128];
+    for (int32_t i = 0; i < 10000; i++) {
+        snprintf(line, sizeof(line), "%.6f,%.6f,%.6f\n", sin(i * 0.1), cos(i * 0.2), 0.001 * i);
+        input += line;
+    }
+    EXPECT_EQ(converter.FindChunkEnd(input.data(), 10), 0u);
+
+    /* The result is the same however the input is split */
+    std::string expected;
+    EXPECT_EQ(converter.ConvertChunk(input.data(), input.size(), expected), 10000);
+    std::string output;
+    int64_t record_num = 0;
+    for (size_t first = 0; first < input.size(); ) {
+        const size_t size = std::min<size_t>(1000, input.size() - first);
+        const size_t end = first + converter.FindChunkEnd(&input[first], size);
+        ASSERT_GT(end, first);
+        record_num += converter.ConvertChunk(&input[first], end - first, output);
+        first = end;
+    }
+    EXPECT_EQ(record_num, 10000);
+    EXPECT_EQ(output, expected);
+
+    EXPECT_THROW(BatchConverter(CreateSetting("rotation_vector", {})), std::invalid_argument);
+}
+
+}
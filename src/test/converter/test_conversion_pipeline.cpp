@@ -0,0 +1,254 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "converter.h"
+#include "batch_converter.h"
+#include "conversion_pipeline.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestConversionPipeline : public testing::Test
+{
+protected:
+    TestConversionPipeline() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestConversionPipeline() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static BatchConverter::Setting CreateSetting()
+{
+    BatchConverter::Setting setting;
+    setting.input = Converter::ParseRepresentation("rotation_vector");
+    setting.output_list = { Converter::ParseRepresentation("quaternion"), Converter::ParseRepresentation("euler_fixed:ZYX") };
+    setting.input_format = BatchConverter::FORMAT::CSV;
+    setting.output_format = BatchConverter::FORMAT::CSV;
+    setting.is_normalize_rotation_matrix = true;
+    setting.is_degree = false;
+    setting.precision = 6;
+    return setting;
+}
+
+static std::string CreateInput(int32_t num)
+{
+    std::string input;
+    char line[128];
+    for (int32_t i = 0; i < num; i++) {
+        snprintf(line, sizeof(line), "%.6f,%.6f,%.6f\n", std::sin(i * 0.1), std::cos(i * 0.2), 0.001 * i);
+        input += line;
+    }
+    return input;
+}
+
+/* Read the input in pieces of random sizes, like a pipe */
+static ConversionPipeline::ReadFunc CreateReadFunc(const std::string& input, size_t& position)
+{
+    return [&input, &position](char* buffer, size_t size) {
+        const size_t read_byte = std::min({ size, input.size() - position, static_cast<size_t>(rand() % 5000 + 1) });
+        std::memcpy(buffer, input.data() + position, read_byte);
+        position += read_byte;
+        return read_byte;
+    };
+}
+
+TEST_F(TestConversionPipeline, Order)
+{
+    const BatchConverter converter(CreateSetting());
+    const std::string input = CreateInput(20000);
+    std::string expected;
+    converter.ConvertChunk(input.data(), input.size(), expected);
+
+    for (int32_t worker_num : { 1, 3 }) {
+        for (int32_t chunk_num : { 1, 2, 8 }) {
+            for (size_t chunk_size : { 1024, 65536 }) {
+                const ConversionPipeline::Setting setting = { worker_num, chunk_size, chunk_num };
+                ConversionPipeline pipeline(converter, setting);
+                size_t position = 0;
+                std::string output;
+                int64_t written_record_num = 0;
+                const int64_t record_num = pipeline.Run(CreateReadFunc(input, position), [&](const std::string& data, int64_t num) {
+                    output += data;
+                    written_record_num += num;
+                });
+                EXPECT_EQ(record_num, 20000);
+                EXPECT_EQ(written_record_num, 20000);
+                EXPECT_EQ(output, expected) << worker_num << ", " << chunk_num << ", " << chunk_size;
+
+                const ConversionPipeline::Statistics statistics = pipeline.GetStatistics();
+                EXPECT_EQ(statistics.reader.byte_num, static_cast<int64_t>(input.size()));
+                EXPECT_EQ(statistics.reader.chunk_num, statistics.writer.chunk_num);
+                EXPECT_EQ(statistics.converter.chunk_num, statistics.writer.chunk_num);
+                EXPECT_EQ(statistics.converter.record_num, 20000);
+                EXPECT_EQ(statistics.writer.byte_num, static_cast<int64_t>(expected.size()));
+                EXPECT_EQ(statistics.input_queue_depth, 0);
+                EXPECT_EQ(statistics.output_queue_depth, 0);
+                EXPECT_LE(statistics.max_input_queue_depth, chunk_num);
+                EXPECT_LE(statistics.max_output_queue_depth, chunk_num);
+                EXPECT_GT(statistics.converter.busy_time, 0.0);
+            }
+        }
+    }
+}
+
+TEST_F(TestConversionPipeline, LongRecord)
+{
+    /* A header, records longer than a chunk, and no new line at the end */
+    const BatchConverter converter(CreateSetting());
+    std::string input = "vx,vy,vz\n0.1," + std::string(3000, '0') + "0.2,0.3\n0.4,0.5,0.6";
+    const ConversionPipeline::Setting setting = { 2, 1024, 4 };
+    ConversionPipeline pipeline(converter, setting);
+    size_t position = 0;
+    std::string output;
+    EXPECT_EQ(pipeline.Run(CreateReadFunc(input, position), [&](const std::string& data, int64_t) { output += data; }), 2);
+    std::string expected;
+    converter.ConvertChunk(input.data(), input.size(), expected, true);
+    EXPECT_EQ(output, expected);
+}
+
+TEST_F(TestConversionPipeline, Stream)
+{
+    /* A record is converted and written as soon as it arrives, without waiting for a full chunk */
+    const BatchConverter converter(CreateSetting());
+    const ConversionPipeline::Setting setting = { 2, 1024 * 1024, 8 };
+    ConversionPipeline pipeline(converter, setting);
+    const std::string record_list[] = { "0.1,0.2,0.3\n", "0.4,0.5,0.6\n" };
+    std::atomic<int64_t> written_record_num(0);
+    bool is_written_before_next = false;
+    int32_t read_num = 0;
+    const int64_t record_num = pipeline.Run([&](char* buffer, size_t size) -> size_t {
+        if (read_num == 1) {
+            /* The input blocks until the first record is written (or time out) */
+            const auto time_start = std::chrono::steady_clock::now();
+            while (written_record_num.load() < 1 && std::chrono::steady_clock::now() - time_start < std::chrono::seconds(5)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            is_written_before_next = (written_record_num.load() == 1);
+        }
+        if (read_num >= 2) return 0;
+        const std::string& record = record_list[read_num++];
+        std::memcpy(buffer, record.data(), std::min(size, record.size()));
+        return record.size();
+    }, [&](const std::string&, int64_t num) {
+        written_record_num += num;
+    });
+    EXPECT_EQ(record_num, 2);
+    EXPECT_TRUE(is_written_before_next);
+    EXPECT_EQ(pipeline.GetStatistics().writer.chunk_num, 2);
+}
+
+TEST_F(TestConversionPipeline, Idle)
+{
+    /* Threads waiting for a slow input sleep */
+    const BatchConverter converter(CreateSetting());
+    const ConversionPipeline::Setting setting = { 4, 1024, 16 };
+    ConversionPipeline pipeline(converter, setting);
+    const std::string input = "0.1,0.2,0.3\n";
+    int32_t read_num = 0;
+    const std::clock_t cpu_time_start = std::clock();
+    const int64_t record_num = pipeline.Run([&](char* buffer, size_t size) -> size_t {
+        if (read_num++ > 0) return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::memcpy(buffer, input.data(), std::min(size, input.size()));
+        return input.size();
+    }, [](const std::string&, int64_t) {});
+    const double cpu_time = static_cast<double>(std::clock() - cpu_time_start) / CLOCKS_PER_SEC;
+    EXPECT_EQ(record_num, 1);
+    const ConversionPipeline::Statistics statistics = pipeline.GetStatistics();
+    EXPECT_GT(statistics.converter.wait_time, 0.4 * setting.worker_num);
+#ifndef _WIN32
+    /* clock is CPU time of the process (not on Windows) */
+    EXPECT_LT(cpu_time, 0.2);
+#endif
+    (void)cpu_time;
+}
+
+TEST_F(TestConversionPipeline, Error)
+{
+    const BatchConverter converter(CreateSetting());
+    const ConversionPipeline::Setting setting = { 2, 1024, 4 };
+
+    /* Invalid record in the middle */
+    std::string input = CreateInput(10000);
+    input.insert(input.size() / 2, "1,2\n");
+    {
+        ConversionPipeline pipeline(converter, setting);
+        size_t position = 0;
+        EXPECT_THROW(pipeline.Run(CreateReadFunc(input, position), [](const std::string&, int64_t) {}), std::runtime_error);
+        EXPECT_THROW(pipeline.Run(CreateReadFunc(input, position), [](const std::string&, int64_t) {}), std::logic_error);
+    }
+
+    /* A word is a header only at the first line */
+    input = CreateInput(10000);
+    input.insert(input.size() / 2, "x0.5,0,0\n");
+    {
+        ConversionPipeline pipeline(converter, setting);
+        size_t position = 0;
+        EXPECT_THROW(pipeline.Run(CreateReadFunc(input, position), [](const std::string&, int64_t) {}), std::runtime_error);
+    }
+
+    /* Error in the writer */
+    {
+        ConversionPipeline pipeline(converter, setting);
+        size_t position = 0;
+        int32_t write_num = 0;
+        EXPECT_THROW(pipeline.Run(CreateReadFunc(input, position), [&](const std::string&, int64_t) {
+            if (++write_num == 3) throw std::runtime_error("write");
+        }), std::runtime_error);
+        EXPECT_EQ(write_num, 3);
+    }
+
+    /* Error in the reader */
+    {
+        ConversionPipeline pipeline(converter, setting);
+        EXPECT_THROW(pipeline.Run([](char*, size_t) -> size_t { throw std::runtime_error("read"); }, [](const std::string&, int64_t) {}), std::runtime_error);
+    }
+
+    const ConversionPipeline::Setting invalid_setting = { 0, 1024, 4 };
+    EXPECT_THROW(ConversionPipeline(converter, invalid_setting), std::invalid_argument);
+}
+
+}
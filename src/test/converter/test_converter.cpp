@@ -0,0 +1,151 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "rotation_matrix.h"
+#include "container.h"
+#include "converter.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestConverter : public testing::Test
+{
+protected:
+    TestConverter() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestConverter() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static float RandomFloat(float min_value, float max_value)
+{
+    return min_value + (max_value - min_value) * static_cast<float>(rand()) / RAND_MAX;
+}
+
+TEST_F(TestConverter, Representation)
+{
+    Converter::Representation representation = Converter::ParseRepresentation("quaternion");
+    EXPECT_EQ(representation.type, REPRESENTATION_TYPE::QUATERNION);
+    representation = Converter::ParseRepresentation("euler_mobile");
+    EXPECT_EQ(representation.type, REPRESENTATION_TYPE::EULER_MOBILE);
+    EXPECT_EQ(representation.order, RotationMatrix::EULER_ORDER::XYZ);
+    representation = Converter::ParseRepresentation("euler_fixed:ZYX");
+    EXPECT_EQ(representation.type, REPRESENTATION_TYPE::EULER_FIXED);
+    EXPECT_EQ(representation.order, RotationMatrix::EULER_ORDER::ZYX);
+    EXPECT_EQ(Converter::GetRepresentationName(representation), "euler_fixed:ZYX");
+    EXPECT_EQ(Converter::GetRepresentationName(Converter::ParseRepresentation("axis_angle")), "axis_angle");
+
+    EXPECT_THROW(Converter::ParseRepresentation("quaternions"), std::invalid_argument);
+    EXPECT_THROW(Converter::ParseRepresentation("euler_mobile:XXY"), std::invalid_argument);
+    EXPECT_THROW(Converter::ParseRepresentation("quaternion:XYZ"), std::invalid_argument);
+
+    EXPECT_EQ(Converter::GetComponentNum(REPRESENTATION_TYPE::ROTATION_MATRIX), 9);
+    EXPECT_EQ(Converter::GetComponentNum(REPRESENTATION_TYPE::AXIS_ANGLE), 4);
+    EXPECT_STREQ(Converter::GetComponentName(REPRESENTATION_TYPE::QUATERNION, 3), "qw");
+}
+
+TEST_F(TestConverter, ConvertAll)
+{
+    InputContainer input_container;
+    OutputContainer output_container;
+    input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::EULER_MOBILE);
+    input_container.mobile_euler_order = static_cast<int32_t>(RotationMatrix::EULER_ORDER::ZYX);
+    input_container.mobile_euler_angle[0] = 0.1f;
+    input_container.mobile_euler_angle[1] = -0.2f;
+    input_container.mobile_euler_angle[2] = 0.3f;
+    input_container.MarkChanged(REPRESENTATION_TYPE::EULER_MOBILE);
+    Converter::ConvertAll(input_container, output_container, true);
+    const Matrix expected = RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::ZYX, 0.1f, -0.2f, 0.3f);
+    for (int32_t i = 0; i < 9; i++) {
+        EXPECT_FLOAT_EQ(output_container.GetRotationMatrix()[i], expected[i]);
+    }
+    const Matrix& euler = output_container.GetMobileEulerAngle(static_cast<int32_t>(RotationMatrix::EULER_ORDER::ZYX));
+    EXPECT_NEAR(euler[0], 0.1f, 1e-5f);
+    EXPECT_NEAR(euler[1], -0.2f, 1e-5f);
+    EXPECT_NEAR(euler[2], 0.3f, 1e-5f);
+
+    /* Not converted again until the selected representation is changed */
+    input_container.mobile_euler_angle[0] = 0.5f;
+    Converter::ConvertAll(input_container, output_container, true);
+    EXPECT_FLOAT_EQ(output_container.GetRotationMatrix()[0], expected[0]);
+    input_container.MarkChanged(REPRESENTATION_TYPE::EULER_MOBILE);
+    Converter::ConvertAll(input_container, output_container, true);
+    EXPECT_NEAR(output_container.GetMobileEulerAngle(static_cast<int32_t>(RotationMatrix::EULER_ORDER::ZYX))[0], 0.5f, 1e-5f);
+}
+
+TEST_F(TestConverter, Batch)
+{
+    static constexpr int32_t NUM = 1000;
+    std::vector<float> quaternion(NUM * 4);
+    for (int32_t i = 0; i < NUM; i++) {
+        float q[4];
+        float norm = 0.0f;
+        for (int32_t c = 0; c < 4; c++) {
+            q[c] = RandomFloat(-1.0f, 1.0f);
+            norm += q[c] * q[c];
+        }
+        for (int32_t c = 0; c < 4; c++) quaternion[c * NUM + i] = q[c] / std::sqrt(norm);
+    }
+    std::vector<float> mat3_rot(NUM * 9);
+    Converter::ConvertToRotationMatrices(Converter::ParseRepresentation("quaternion"), quaternion.data(), NUM, true, mat3_rot.data());
+    for (int32_t i = 0; i < NUM; i++) {
+        const Matrix expected = RotationMatrix::ConvertQuaternion2RotationMatrix(quaternion[0 * NUM + i], quaternion[1 * NUM + i], quaternion[2 * NUM + i], quaternion[3 * NUM + i]);
+        for (int32_t k = 0; k < 9; k++) {
+            EXPECT_NEAR(mat3_rot[k * NUM + i], expected[k], 1e-6f);
+        }
+    }
+
+    /* Every representation goes back to the same rotation matrix */
+    const char* name_list[] = { "matrix", "rotation_vector", "axis_angle", "quaternion", "euler_mobile:YZX", "euler_fixed:ZXY" };
+    for (const char* name : name_list) {
+        const Converter::Representation representation = Converter::ParseRepresentation(name);
+        std::vector<float> planes(NUM * Converter::GetComponentNum(representation.type));
+        std::vector<float> mat3_rot_converted(NUM * 9);
+        Converter::ConvertFromRotationMatrices(representation, mat3_rot.data(), NUM, planes.data());
+        Converter::ConvertToRotationMatrices(representation, planes.data(), NUM, false, mat3_rot_converted.data());
+        for (int32_t k = 0; k < NUM * 9; k++) {
+            EXPECT_NEAR(mat3_rot_converted[k], mat3_rot[k], 1e-4f) << name;
+        }
+    }
+}
+
+}
@@ -0,0 +1,135 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "float_text.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestFloatText : public testing::Test
+{
+protected:
+    TestFloatText() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestFloatText() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static float ParseText(const std::string& text, size_t* length = nullptr)
+{
+    float value = -999.0f;
+    const char* end = FloatText::Parse(text.data(), text.data() + text.size(), value);
+    if (length) *length = end - text.data();
+    return value;
+}
+
+static std::string FormatText(float value, int32_t precision)
+{
+    char buffer[FloatText::FORMAT_MAX_LENGTH];
+    char* end = FloatText::Format(value, precision, buffer);
+    return std::string(buffer, end - buffer);
+}
+
+TEST_F(TestFloatText, Parse)
+{
+    EXPECT_EQ(ParseText("0"), 0.0f);
+    EXPECT_EQ(ParseText("1"), 1.0f);
+    EXPECT_EQ(ParseText("-1.5"), -1.5f);
+    EXPECT_EQ(ParseText("+0.25"), 0.25f);
+    EXPECT_EQ(ParseText(".5"), 0.5f);
+    EXPECT_EQ(ParseText("3."), 3.0f);
+    EXPECT_EQ(ParseText("1e3"), 1000.0f);
+    EXPECT_EQ(ParseText("-2.5E-2"), -0.025f);
+    EXPECT_EQ(ParseText("0.1"), 0.1f);
+    EXPECT_EQ(ParseText("3.14159265358979"), 3.14159265358979f);
+    EXPECT_TRUE(std::signbit(ParseText("-0.0")));
+
+    /* Fall back to strtof */
+    EXPECT_EQ(ParseText("1e-30"), 1e-30f);
+    EXPECT_EQ(ParseText("0.123456789012345678901234"), 0.123456789012345678901234f);
+    EXPECT_TRUE(std::isinf(ParseText("inf")));
+    EXPECT_TRUE(std::isnan(ParseText("nan")));
+
+    /* The end of the number */
+    size_t length = 0;
+    EXPECT_EQ(ParseText("1.25,2", &length), 1.25f);
+    EXPECT_EQ(length, 4u);
+    EXPECT_EQ(ParseText("2e", &length), 2.0f);
+    EXPECT_EQ(length, 1u);
+    ParseText("abc", &length);
+    EXPECT_EQ(length, 0u);
+    ParseText("-", &length);
+    EXPECT_EQ(length, 0u);
+    ParseText(" 1", &length);
+    EXPECT_EQ(length, 0u);
+}
+
+TEST_F(TestFloatText, ParseRandom)
+{
+    /* Same as strtof for typical text of floats */
+    char text[64];
+    for (int32_t i = 0; i < 100000; i++) {
+        const double value = (static_cast<double>(rand()) / RAND_MAX - 0.5) * 20.0;
+        const int32_t length = snprintf(text, sizeof(text), (i % 2) ? "%.7f" : "%.9g", value);
+        float parsed = 0.0f;
+        FloatText::Parse(text, text + length, parsed);
+        EXPECT_EQ(parsed, std::strtof(text, nullptr)) << text;
+    }
+}
+
+TEST_F(TestFloatText, Format)
+{
+    EXPECT_EQ(FormatText(0.0f, 3), "0.000");
+    EXPECT_EQ(FormatText(1.0f, 0), "1");
+    EXPECT_EQ(FormatText(-1.5f, 2), "-1.50");
+    EXPECT_EQ(FormatText(0.125f, 7), "0.1250000");
+    EXPECT_EQ(FormatText(-0.00004f, 4), "0.0000");
+    EXPECT_EQ(FormatText(2.0f / 3.0f, 5), "0.66667");
+    EXPECT_EQ(FormatText(123456.75f, 1), "123456.8");
+    EXPECT_EQ(FormatText(1e10f, 3), "1e+10");
+    EXPECT_EQ(FormatText(-INFINITY, 3), "-inf");
+
+    /* Round trip */
+    for (int32_t i = 0; i < 100000; i++) {
+        const float value = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 20.0f;
+        const std::string text = FormatText(value, 9);
+        EXPECT_NEAR(ParseText(text), value, 1e-6f) << text;
+    }
+}
+
+}
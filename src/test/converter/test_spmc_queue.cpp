@@ -0,0 +1,131 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "spmc_queue.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestSpmcQueue : public testing::Test
+{
+protected:
+    TestSpmcQueue() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestSpmcQueue() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+TEST_F(TestSpmcQueue, Basic)
+{
+    SpmcQueue<int32_t> queue(5);
+    EXPECT_EQ(queue.GetCapacity(), 8u);
+    int32_t value = -1;
+    EXPECT_FALSE(queue.TryPop(value));
+
+    /* Full */
+    for (int32_t i = 0; i < 8; i++) EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_FALSE(queue.TryPush(8));
+    EXPECT_EQ(queue.GetSize(), 8u);
+
+    /* FIFO across the end of the ring */
+    for (int32_t i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    for (int32_t i = 8; i < 12; i++) EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_FALSE(queue.TryPush(12));
+    for (int32_t i = 4; i < 12; i++) {
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+    EXPECT_EQ(queue.GetSize(), 0u);
+
+    EXPECT_FALSE(queue.IsClosed());
+    queue.TryPush(100);
+    queue.Close();
+    EXPECT_TRUE(queue.IsClosed());
+    EXPECT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(value, 100);
+}
+
+TEST_F(TestSpmcQueue, MultipleConsumer)
+{
+    static constexpr int32_t NUM = 200000;
+    static constexpr int32_t CONSUMER_NUM = 4;
+    SpmcQueue<int32_t> queue(16);
+    std::vector<std::atomic<int32_t>> received(NUM);
+    for (auto& r : received) r.store(0);
+
+    std::vector<std::thread> consumer_list;
+    std::vector<int64_t> sum_list(CONSUMER_NUM, 0);
+    for (int32_t c = 0; c < CONSUMER_NUM; c++) {
+        consumer_list.emplace_back([&, c]() {
+            int32_t previous = -1;
+            for (;;) {
+                int32_t value;
+                if (!queue.TryPop(value)) {
+                    if (queue.IsClosed() && !queue.TryPop(value)) break;
+                    if (!queue.IsClosed()) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+                EXPECT_GT(value, previous);     /* each consumer gets values in the pushed order */
+                previous = value;
+                received[value]++;
+                sum_list[c] += value;
+            }
+        });
+    }
+    for (int32_t i = 0; i < NUM; i++) {
+        while (!queue.TryPush(i)) std::this_thread::yield();
+    }
+    queue.Close();
+    for (auto& consumer : consumer_list) consumer.join();
+
+    int64_t sum = 0;
+    for (int64_t s : sum_list) sum += s;
+    EXPECT_EQ(sum, static_cast<int64_t>(NUM) * (NUM - 1) / 2);
+    for (int32_t i = 0; i < NUM; i++) {
+        ASSERT_EQ(received[i].load(), 1) << i;
+    }
+}
+
+}
@@ -0,0 +1,283 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "converter.h"
+#include "batch_converter.h"
+#include "trajectory_file.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestTrajectoryFile : public testing::Test
+{
+protected:
+    TestTrajectoryFile() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestTrajectoryFile() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+        /* A file per test, so that tests can run in parallel (each test is a process with gtest_discover_tests) */
+        const std::string test_name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        m_file_name = "test_trajectory_" + test_name + ".rtj";
+        m_file_name_copy = "test_trajectory_" + test_name + "_copy.rtj";
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+        std::remove(m_file_name.c_str());
+        std::remove(m_file_name_copy.c_str());
+    }
+
+    std::string m_file_name;
+    std::string m_file_name_copy;
+};
+
+/* Quaternion of the i-th rotation around z axis */
+static void MakeRecord(int64_t i, float* record)
+{
+    const float angle = 0.001f * i;
+    record[0] = 0.0f;
+    record[1] = 0.0f;
+    record[2] = std::sin(angle / 2);
+    record[3] = std::cos(angle / 2);
+}
+
+static void WriteRecords(TrajectoryWriter& writer, int64_t first, int64_t num)
+{
+    for (int64_t i = first; i < first + num; i++) {
+        float record[4];
+        MakeRecord(i, record);
+        writer.Append(record, i * 10);
+    }
+}
+
+TEST_F(TestTrajectoryFile, WriteRead)
+{
+    static constexpr int64_t NUM = 10000;
+    {
+        TrajectoryWriter writer(m_file_name, Converter::ParseRepresentation("quaternion"), true, 1024);
+        WriteRecords(writer, 0, NUM);
+        EXPECT_EQ(writer.GetCount(), NUM);
+        EXPECT_EQ(writer.GetCommittedCount(), 0);
+        writer.Commit();
+        EXPECT_EQ(writer.GetCommittedCount(), NUM);
+    }
+
+    TrajectoryReader reader(m_file_name);
+    EXPECT_EQ(reader.GetRepresentation().type, REPRESENTATION_TYPE::QUATERNION);
+    EXPECT_EQ(reader.GetComponentNum(), 4);
+    EXPECT_TRUE(reader.HasTimestamp());
+    EXPECT_EQ(reader.GetCount(), NUM);
+    EXPECT_EQ(reader.GetBlockCapacity(), 1024);
+    EXPECT_EQ(reader.GetBlockNum(), 10);
+    EXPECT_EQ(reader.GetBlockRecordNum(9), NUM - 9 * 1024);
+    for (int64_t block = 0; block < reader.GetBlockNum(); block++) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(reader.GetBlockPlanes(block)) % 64, 0u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(reader.GetBlockTimestamps(block)) % 64, 0u);
+    }
+
+    for (int64_t i = 0; i < NUM; i += 7) {
+        float expected[4];
+        float record[4];
+        MakeRecord(i, expected);
+        reader.GetRecord(i, record);
+        for (int32_t c = 0; c < 4; c++) {
+            EXPECT_EQ(record[c], expected[c]);
+            EXPECT_EQ(reader.GetValue(i, c), expected[c]);
+        }
+        EXPECT_EQ(reader.GetTimestamp(i), i * 10);
+    }
+
+    EXPECT_EQ(reader.FindIndex(-1), -1);
+    EXPECT_EQ(reader.FindIndex(0), 0);
+    EXPECT_EQ(reader.FindIndex(9), 0);
+    EXPECT_EQ(reader.FindIndex(10240), 1024);
+    EXPECT_EQ(reader.FindIndex(10239), 1023);
+    EXPECT_EQ(reader.FindIndex(55555), 5555);
+    EXPECT_EQ(reader.FindIndex(NUM * 100), NUM - 1);
+}
+
+TEST_F(TestTrajectoryFile, BatchConversion)
+{
+    static constexpr int64_t NUM = 3000;
+    {
+        TrajectoryWriter writer(m_file_name, Converter::ParseRepresentation("quaternion"), false, 1024);
+        WriteRecords(writer, 0, NUM);
+    }
+    TrajectoryReader reader(m_file_name);
+    EXPECT_FALSE(reader.HasTimestamp());
+    EXPECT_EQ(reader.GetBlockTimestamps(0), nullptr);
+    EXPECT_EQ(reader.FindIndex(0), -1);
+
+    /* Blocks are converted in place */
+    std::vector<float> mat3_rot(reader.GetBlockCapacity() * 9);
+    for (int64_t block = 0; block < reader.GetBlockNum(); block++) {
+        const int32_t num = reader.GetBlockRecordNum(block);
+        Converter::ConvertToRotationMatrices(reader.GetRepresentation(), reader.GetBlockPlanes(block), reader.GetBlockCapacity(), num, false, mat3_rot.data());
+        for (int32_t i = 0; i < num; i += 13) {
+            const float angle = 0.001f * (block * reader.GetBlockCapacity() + i);
+            EXPECT_NEAR(mat3_rot[0 * num + i], std::cos(angle), 1e-5f);
+            EXPECT_NEAR(mat3_rot[3 * num + i], std::sin(angle), 1e-5f);
+            EXPECT_NEAR(mat3_rot[8 * num + i], 1.0f, 1e-5f);
+        }
+    }
+
+    /* Same as converting the records read from a binary file */
+    std::vector<float> record_list(NUM * 4);
+    for (int64_t i = 0; i < NUM; i++) reader.GetRecord(i, &record_list[i * 4]);
+    for (bool is_degree : { false, true }) {
+        BatchConverter::Setting setting;
+        setting.input = reader.GetRepresentation();
+        setting.output_list = { Converter::ParseRepresentation("euler_mobile:ZYX") };
+        setting.input_format = BatchConverter::FORMAT::BINARY;
+        setting.output_format = BatchConverter::FORMAT::CSV;
+        setting.is_normalize_rotation_matrix = true;
+        setting.is_degree = is_degree;
+        setting.precision = 5;
+        const BatchConverter converter(setting);
+        std::string output;
+        for (int64_t block = 0; block < reader.GetBlockNum(); block++) {
+            converter.ConvertPlanes(reader.GetBlockPlanes(block), reader.GetBlockCapacity(), reader.GetBlockRecordNum(block), output);
+        }
+        std::string expected;
+        converter.ConvertChunk(reinterpret_cast<const char*>(record_list.data()), record_list.size() * sizeof(float), expected);
+        EXPECT_EQ(output, expected);
+    }
+    EXPECT_EQ(reader.GetValue(NUM - 1, 3), record_list.back());     /* not modified by degree conversion */
+}
+
+TEST_F(TestTrajectoryFile, Append)
+{
+    {
+        TrajectoryWriter writer(m_file_name, Converter::ParseRepresentation("quaternion"), true, 64);
+        WriteRecords(writer, 0, 100);
+    }
+    {
+        TrajectoryWriter writer(m_file_name);
+        EXPECT_EQ(writer.GetCount(), 100);
+        EXPECT_EQ(writer.GetComponentNum(), 4);
+        float record[4];
+        MakeRecord(0, record);
+        EXPECT_THROW(writer.Append(record, 0), std::invalid_argument);      /* timestamp goes back */
+
+        /* All or nothing: the records before an invalid timestamp are not appended either */
+        float record_list[3 * 4];
+        for (int32_t i = 0; i < 3; i++) MakeRecord(100 + i, &record_list[i * 4]);
+        const int64_t timestamp_back[3] = { 1000, 1010, 1005 };
+        EXPECT_THROW(writer.AppendRecords(record_list, 3, timestamp_back), std::invalid_argument);
+        const int64_t timestamp_before_last[3] = { 980, 1000, 1010 };
+        EXPECT_THROW(writer.AppendRecords(record_list, 3, timestamp_before_last), std::invalid_argument);
+        EXPECT_EQ(writer.GetCount(), 100);
+        WriteRecords(writer, 100, 60);
+    }
+    {
+        TrajectoryWriter writer(m_file_name);
+        WriteRecords(writer, 160, 32);
+    }
+
+    TrajectoryReader reader(m_file_name);
+    EXPECT_EQ(reader.GetCount(), 192);
+    for (int64_t i = 0; i < 192; i++) {
+        float expected[4];
+        MakeRecord(i, expected);
+        EXPECT_EQ(reader.GetValue(i, 2), expected[2]);
+        EXPECT_EQ(reader.GetTimestamp(i), i * 10);
+    }
+    EXPECT_EQ(reader.FindIndex(1605), 160);
+}
+
+TEST_F(TestTrajectoryFile, CrashConsistency)
+{
+    TrajectoryWriter writer(m_file_name, Converter::ParseRepresentation("quaternion"), true, 64);
+    WriteRecords(writer, 0, 100);
+    writer.Commit();
+    WriteRecords(writer, 100, 1000);    /* blocks are written, but not committed */
+
+    /* The file at this moment (as if the process crashed) has only the committed records */
+    {
+        std::ifstream ifs(m_file_name, std::ios::binary);
+        std::ofstream ofs(m_file_name_copy, std::ios::binary);
+        ofs << ifs.rdbuf();
+    }
+    {
+        TrajectoryReader reader(m_file_name_copy);
+        EXPECT_EQ(reader.GetCount(), 100);
+        EXPECT_EQ(reader.GetTimestamp(99), 990);
+    }
+
+    /* Appending to it discards the records which are not committed */
+    {
+        TrajectoryWriter writer_after_crash(m_file_name_copy);
+        EXPECT_EQ(writer_after_crash.GetCount(), 100);
+        WriteRecords(writer_after_crash, 100, 10);
+    }
+    TrajectoryReader reader(m_file_name_copy);
+    EXPECT_EQ(reader.GetCount(), 110);
+    EXPECT_EQ(reader.GetTimestamp(109), 1090);
+}
+
+TEST_F(TestTrajectoryFile, Invalid)
+{
+    EXPECT_THROW(TrajectoryReader("not_exist.rtj"), std::runtime_error);
+    EXPECT_THROW(TrajectoryWriter(m_file_name, Converter::ParseRepresentation("quaternion"), false, 100), std::invalid_argument);
+
+    {
+        std::ofstream ofs(m_file_name, std::ios::binary);
+        ofs << std::string(256, 'x');
+    }
+    EXPECT_THROW(TrajectoryReader{ m_file_name }, std::runtime_error);
+    EXPECT_THROW(TrajectoryWriter{ m_file_name }, std::runtime_error);
+
+    /* Truncated */
+    {
+        TrajectoryWriter writer(m_file_name, Converter::ParseRepresentation("rotation_vector"), false, 64);
+        const float record[3] = { 0.1f, 0.2f, 0.3f };
+        for (int32_t i = 0; i < 100; i++) writer.Append(record);
+    }
+    std::string data;
+    {
+        std::ifstream ifs(m_file_name, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream ofs(m_file_name, std::ios::binary);
+        ofs << data.substr(0, data.size() - 100);
+    }
+    EXPECT_THROW(TrajectoryReader{ m_file_name }, std::runtime_error);
+}
+
+}
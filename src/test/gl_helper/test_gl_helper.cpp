@@ -84,9 +84,9 @@ TEST_F(TestGlHelper, Shape)
 #if 0
     EXPECT_NO_THROW(
     std::unique_ptr<Shape> cube0 = std::make_unique<ShapeSolid>(ObjectData::CubeTriangleVertex);
-    cube0->Draw(Matrix::Identity(4), Matrix::Identity(4));
+    cube0->Draw(Mat4ColMajor::Identity(), Matrix::Identity(4));
     std::unique_ptr<Shape> cube2 = std::make_unique<ShapeSolidIndex>(ObjectData::CubeWireVertex, ObjectData::CubeWireIndex);
-    cube2->Draw(Matrix::Identity(4), Matrix::Identity(4));
+    cube2->Draw(Mat4ColMajor::Identity(), Matrix::Identity(4));
     );
 #endif
 }
@@ -161,6 +161,194 @@ TEST_F(TestMatrix, Inverse)
     EXPECT_THROW(mat3.Inverse(), std::out_of_range);
 }
 
+TEST_F(TestMatrix, InverseGeneral)
+{
+    /* a zero on the diagonal doesn't mean singular */
+    Matrix mat1(2, 2, { 0, 2, 4, 0 });
+    Matrix mat = mat1.Inverse();
+    EXPECT_FLOAT_EQ(0, mat(0, 0));
+    EXPECT_FLOAT_EQ(0.25, mat(0, 1));
+    EXPECT_FLOAT_EQ(0.5, mat(1, 0));
+    EXPECT_FLOAT_EQ(0, mat(1, 1));
+
+    /* closed form (3, 4) and LU (5 or more) */
+    for (int32_t n : { 1, 3, 4, 5, 8 }) {
+        Matrix mat_a(n, n);
+        for (int32_t y = 0; y < n; y++) {
+            for (int32_t x = 0; x < n; x++) {
+                mat_a(y, x) = static_cast<float>((y * 7 + x * 3) % 5) - 2.0f + ((x == (y + 1) % n) ? 5.0f : 0.0f);
+            }
+            mat_a(y, y) = 0;
+        }
+        if (n == 1) mat_a(0, 0) = 4;
+        Matrix mat_i = mat_a * mat_a.Inverse();
+        for (int32_t y = 0; y < n; y++) {
+            for (int32_t x = 0; x < n; x++) {
+                EXPECT_NEAR((x == y) ? 1.0f : 0.0f, mat_i(y, x), 1e-5f);
+            }
+        }
+    }
+
+    /* singular */
+    Matrix mat3(3, 3, { 1, 2, 3, 2, 4, 6, 1, 0, 1 });
+    EXPECT_THROW(mat3.Inverse(), std::out_of_range);
+    Matrix mat6(6, 6);
+    EXPECT_THROW(mat6.Inverse(), std::out_of_range);
+}
+
+TEST_F(TestMatrix, Storage)
+{
+    for (int32_t size : { 1, 3, 4, 5 }) {
+        Matrix mat1(size, size);
+        for (int32_t i = 0; i < size * size; i++) mat1[i] = static_cast<float>(i);
+        const bool is_inline = (size * size <= static_cast<int32_t>(MatrixStorage::INLINE_SIZE));
+        const char* begin = reinterpret_cast<const char*>(&mat1);
+        const char* data = reinterpret_cast<const char*>(mat1.Data());
+        EXPECT_EQ(is_inline, (data >= begin) && (data < begin + sizeof(mat1)));
+
+        /* copy */
+        Matrix mat2 = mat1;
+        Matrix mat3(1, 1);
+        mat3 = mat1;
+        EXPECT_NE(mat1.Data(), mat2.Data());
+        EXPECT_NE(mat1.Data(), mat3.Data());
+        for (int32_t i = 0; i < size * size; i++) {
+            EXPECT_EQ(mat1[i], mat2[i]);
+            EXPECT_EQ(mat1[i], mat3[i]);
+        }
+        mat2[0] = -1;
+        EXPECT_EQ(0, mat1[0]);
+
+        /* move */
+        const float* data_before_move = mat1.Data();
+        Matrix mat4 = std::move(mat1);
+        EXPECT_EQ(is_inline, data_before_move != mat4.Data());
+        Matrix mat5(2, 2);
+        mat5 = std::move(mat4);
+        EXPECT_EQ(size, mat5.Rows());
+        for (int32_t i = 0; i < size * size; i++) {
+            EXPECT_EQ(static_cast<float>(i), mat5[i]);
+        }
+        EXPECT_THROW(mat5[size * size], std::out_of_range);
+    }
+
+    /* shape changes between inline and heap */
+    Matrix mat_small(4, 4, { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 });
+    Matrix mat_large = Matrix::Identity(6);
+    Matrix mat = mat_small;
+    mat = mat_large * 2.0f;
+    EXPECT_EQ(2, mat(5, 5));
+    mat = mat_small * 3.0f;
+    EXPECT_EQ(16 * sizeof(float), (mat.Rows() * mat.Cols()) * sizeof(float));
+    EXPECT_EQ(3, mat(3, 3));
+    EXPECT_THROW(mat[16], std::out_of_range);
+}
+
+TEST_F(TestMatrix, CompoundAssignment)
+{
+    Matrix mat1(2, 2, { 1, 2, 3, 4 });
+    Matrix mat2(2, 2, { 5, 6, 7, 8 });
+    Matrix mat = mat1;
+    mat += mat2;
+    EXPECT_EQ(6, mat(0, 0));
+    EXPECT_EQ(12, mat(1, 1));
+    mat -= mat1 * 2.0f;
+    EXPECT_EQ(4, mat(0, 0));
+    EXPECT_EQ(4, mat(1, 1));
+    mat *= 0.5f;
+    EXPECT_EQ(2, mat(0, 0));
+    EXPECT_EQ(2, mat(1, 1));
+    mat = mat1;
+    mat *= mat2;
+    EXPECT_EQ(19, mat(0, 0));
+    EXPECT_EQ(22, mat(0, 1));
+    EXPECT_EQ(43, mat(1, 0));
+    EXPECT_EQ(50, mat(1, 1));
+    mat += mat * mat1;      /* the product refers the destination */
+    EXPECT_EQ(19 + 19 + 66, mat(0, 0));
+
+    Matrix mat3(2, 3);
+    EXPECT_THROW(mat += mat3, std::out_of_range);
+    EXPECT_THROW(mat *= mat3.Transpose(), std::out_of_range);
+}
+
+TEST_F(TestMatrix, IntoFunctions)
+{
+    Matrix mat1(2, 3, { 1, 2, 3, 4, 5, 6 });
+    Matrix mat2(3, 2, { 1, 2, 3, 4, 5, 6 });
+    Matrix mat(2, 2);
+    const float* data = mat.Data();
+    MultiplyInto(mat, mat1, mat2);
+    EXPECT_EQ(data, mat.Data());    /* the buffer is reused */
+    EXPECT_EQ(22, mat(0, 0));
+    EXPECT_EQ(28, mat(0, 1));
+    EXPECT_EQ(49, mat(1, 0));
+    EXPECT_EQ(64, mat(1, 1));
+    MultiplyInto(mat, mat, mat);
+    EXPECT_EQ(22 * 22 + 28 * 49, mat(0, 0));
+
+    Matrix mat_t;
+    TransposeInto(mat_t, mat1);
+    EXPECT_EQ(3, mat_t.Rows());
+    EXPECT_EQ(2, mat_t.Cols());
+    EXPECT_EQ(4, mat_t(0, 1));
+    TransposeInto(mat1, mat1);
+    EXPECT_EQ(3, mat1.Rows());
+    EXPECT_EQ(4, mat1(0, 1));
+    Matrix mat_square(3, 3, { 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    TransposeInto(mat_square, mat_square);
+    EXPECT_EQ(4, mat_square(0, 1));
+    EXPECT_EQ(2, mat_square(1, 0));
+    EXPECT_EQ(6, mat_square(2, 1));
+
+    Matrix mat4(2, 2, { 1, 2, 3, 4 });
+    Matrix mat_inv(2, 2);
+    InverseInto(mat_inv, mat4);
+    EXPECT_FLOAT_EQ(-2, mat_inv(0, 0));
+    EXPECT_FLOAT_EQ(-0.5, mat_inv(1, 1));
+    InverseInto(mat4, mat4);
+    EXPECT_FLOAT_EQ(1.5, mat4(1, 0));
+    EXPECT_THROW(InverseInto(mat_inv, mat_t), std::out_of_range);
+}
+
+TEST_F(TestMatrix, Expression)
+{
+    Matrix mat1(2, 3, { 1, 2, 3, 4, 5, 6 });
+    Matrix mat2(2, 3, { 7, 8, 9, 10, 11, 12 });
+    Matrix mat3(3, 2, { 1, 2, 3, 4, 5, 6 });
+    Matrix mat4(2, 2, { 1, 0, 0, 2 });
+
+    Matrix mat = mat1 * 2 + mat2 - mat1;
+    EXPECT_EQ(8, mat[0]);
+    EXPECT_EQ(18, mat[5]);
+
+    /* product chain and product used in a coefficient-wise expression */
+    mat = mat4 * mat1 * mat3;
+    EXPECT_EQ(22, mat[0]);
+    EXPECT_EQ(128, mat[3]);
+    mat = mat1 * mat3 + mat4 * 3;
+    EXPECT_EQ(25, mat[0]);
+    EXPECT_EQ(70, mat[3]);
+    mat = (mat1 + mat2) * mat3;
+    EXPECT_EQ(22 + 76, mat[0]);
+
+    /* the destination is used in the expression */
+    Matrix mat_alias(2, 2, { 1, 2, 3, 4 });
+    mat_alias = mat_alias * mat_alias;
+    EXPECT_EQ(7, mat_alias[0]);
+    EXPECT_EQ(10, mat_alias[1]);
+    EXPECT_EQ(15, mat_alias[2]);
+    EXPECT_EQ(22, mat_alias[3]);
+    mat_alias = mat_alias + mat_alias;
+    EXPECT_EQ(14, mat_alias[0]);
+
+    Matrix mat_eval = (mat1 + mat2).eval();
+    EXPECT_EQ(8, mat_eval[0]);
+
+    EXPECT_THROW(mat = mat1 + mat3, std::out_of_range);
+    EXPECT_THROW(mat = mat1 * mat2, std::out_of_range);
+}
+
 TEST_F(TestMatrix, isc)
 {
     Matrix mat1(2, 3, { 1, 2, 3, 4, 5, 6 });
@@ -0,0 +1,104 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "matrix_col_major.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestMatrixColMajor : public testing::Test
+{
+protected:
+    TestMatrixColMajor() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestMatrixColMajor() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+TEST_F(TestMatrixColMajor, BasicTest)
+{
+    EXPECT_TRUE(true);
+}
+
+TEST_F(TestMatrixColMajor, Creation)
+{
+    Mat4 mat({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+    Mat4ColMajor mat_col_major(mat);
+    EXPECT_FLOAT_EQ(1, mat_col_major.Data()[0]);
+    EXPECT_FLOAT_EQ(5, mat_col_major.Data()[1]);
+    EXPECT_FLOAT_EQ(2, mat_col_major.Data()[4]);
+    EXPECT_FLOAT_EQ(16, mat_col_major.Data()[15]);
+    EXPECT_FLOAT_EQ(2, mat_col_major(0, 1));
+    EXPECT_FLOAT_EQ(5, mat_col_major(1, 0));
+    EXPECT_THROW(mat_col_major(4, 0), std::out_of_range);
+
+    Mat4 mat_row_major = static_cast<Mat4>(mat_col_major);
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_FLOAT_EQ(mat[i], mat_row_major[i]);
+    }
+
+    Mat4ColMajor identity = Mat4ColMajor::Identity();
+    for (int32_t row = 0; row < 4; row++) {
+        for (int32_t col = 0; col < 4; col++) {
+            EXPECT_FLOAT_EQ(row == col ? 1.0f : 0.0f, identity(row, col));
+        }
+    }
+}
+
+TEST_F(TestMatrixColMajor, Multiply)
+{
+    Mat4 mat0({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+    Mat4 mat1({ 2, 0, 1, 3, -1, 4, 0, 2, 5, 1, -2, 0, 3, 3, 1, -1 });
+    Mat4 expected = mat0 * mat1;
+
+    Mat4ColMajor result = Mat4ColMajor(mat0) * Mat4ColMajor(mat1);
+    Mat4ColMajor result_mixed = Mat4ColMajor(mat0) * mat1;
+    Mat4ColMajor result_dynamic = Mat4ColMajor(mat0) * static_cast<Matrix>(mat1);
+    for (int32_t row = 0; row < 4; row++) {
+        for (int32_t col = 0; col < 4; col++) {
+            EXPECT_FLOAT_EQ(expected(row, col), result(row, col));
+            EXPECT_FLOAT_EQ(expected(row, col), result_mixed(row, col));
+            EXPECT_FLOAT_EQ(expected(row, col), result_dynamic(row, col));
+        }
+    }
+
+    EXPECT_THROW(Mat4ColMajor(mat0) * Matrix(3, 3), std::out_of_range);
+}
+
+}
@@ -0,0 +1,180 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestMatrixFixed : public testing::Test
+{
+protected:
+    TestMatrixFixed() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestMatrixFixed() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+TEST_F(TestMatrixFixed, BasicTest)
+{
+    EXPECT_TRUE(true);
+}
+
+TEST_F(TestMatrixFixed, Creation)
+{
+    MatrixFixed<2, 3> mat1;
+    EXPECT_EQ(0, mat1[0]);
+    EXPECT_EQ(0, mat1(0, 0));
+    mat1[0] = 55;
+    mat1(1, 1) = 66;
+    EXPECT_EQ(55, mat1[0]);
+    EXPECT_EQ(66, mat1(1, 1));
+    EXPECT_THROW(mat1[6], std::out_of_range);
+    EXPECT_THROW(mat1(2, 3), std::out_of_range);
+    EXPECT_THROW(mat1(1, 3), std::out_of_range);
+    EXPECT_THROW(mat1(2, 2), std::out_of_range);
+
+    MatrixFixed<2, 3> mat2({ 1, 2, 3, 4, 5, 6 });
+    EXPECT_EQ(3, mat2[2]);
+    EXPECT_EQ(3, mat2(0, 2));
+    EXPECT_EQ(5, mat2(1, 1));
+
+    MatrixFixed<2, 3> mat3(mat2.Data());
+    for (int32_t i = 0; i < 6; i++) {
+        EXPECT_EQ(mat2[i], mat3[i]);
+    }
+
+    Mat3 I = Mat3::Identity();
+    EXPECT_EQ(1, I(0, 0));
+    EXPECT_EQ(0, I(0, 1));
+    EXPECT_EQ(1, I(1, 1));
+    EXPECT_EQ(1, I(2, 2));
+    EXPECT_THROW(I(3, 3), std::out_of_range);
+    EXPECT_EQ(sizeof(float) * 9, sizeof(Mat3));
+}
+
+TEST_F(TestMatrixFixed, Conversion)
+{
+    Matrix mat(2, 3, { 1, 2, 3, 4, 5, 6 });
+    MatrixFixed<2, 3> mat_fixed(mat);
+    for (int32_t i = 0; i < 6; i++) {
+        EXPECT_EQ(mat[i], mat_fixed[i]);
+    }
+    EXPECT_THROW(Mat3 mat3(mat), std::out_of_range);
+
+    Matrix mat_reverted = static_cast<Matrix>(mat_fixed);
+    EXPECT_EQ(2, mat_reverted.Rows());
+    EXPECT_EQ(3, mat_reverted.Cols());
+    for (int32_t i = 0; i < 6; i++) {
+        EXPECT_EQ(mat[i], mat_reverted[i]);
+    }
+}
+
+TEST_F(TestMatrixFixed, Arithmetic)
+{
+    MatrixFixed<2, 3> mat1({ 1, 2, 3, 4, 5, 6 });
+    MatrixFixed<2, 3> mat2({ 7, 8, 9, 10, 11, 12 });
+    EXPECT_EQ(8, (mat1 + mat2)[0]);
+    EXPECT_EQ(18, (mat1 + mat2)[5]);
+    EXPECT_EQ(-6, (mat1 - mat2)[0]);
+    EXPECT_EQ(-6, (mat1 - mat2)[5]);
+    EXPECT_EQ(3, (mat1 * 3)[0]);
+    EXPECT_EQ(18, (mat1 * 3)[5]);
+
+    MatrixFixed<3, 2> mat3({ 1, 2, 3, 4, 5, 6 });
+    MatrixFixed<2, 2> mat = mat1 * mat3;
+    EXPECT_EQ(22, mat[0]);
+    EXPECT_EQ(64, mat[3]);
+
+    MatrixFixed<3, 2> mat_t = mat1.Transpose();
+    EXPECT_EQ(1, mat_t[0]);
+    EXPECT_EQ(4, mat_t[1]);
+}
+
+TEST_F(TestMatrixFixed, SameAsMatrix)
+{
+    Matrix mat_a(4, 4, { 2, 1, 0, 3, 1, 3, 1, 0, 0, 1, 4, 1, 3, 0, 1, 5 });
+    Matrix mat_b(4, 1, { 1, -2, 3, 1 });
+    Mat4 mat_a_fixed(mat_a);
+    Vec4 mat_b_fixed(mat_b);
+
+    Matrix mat_ab = mat_a * mat_b;
+    Vec4 mat_ab_fixed = mat_a_fixed * mat_b_fixed;
+    for (int32_t i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(mat_ab[i], mat_ab_fixed[i]);
+    }
+
+    Matrix mat_inv = mat_a.Inverse();
+    Mat4 mat_inv_fixed = mat_a_fixed.Inverse();
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_FLOAT_EQ(mat_inv[i], mat_inv_fixed[i]);
+    }
+
+    Mat4 mat_zero;
+    EXPECT_THROW(mat_zero.Inverse(), std::out_of_range);
+    EXPECT_NO_THROW(mat_a_fixed.Print());
+}
+
+
+TEST_F(TestMatrixFixed, CompoundAssignment)
+{
+    Mat3 mat_a({ 2, 1, 0, 1, 3, 1, 0, 1, 4 });
+    Mat3 mat_b = Mat3::Identity();
+    Mat3 mat = mat_a;
+    mat += mat_b;
+    EXPECT_EQ(3, mat(0, 0));
+    mat -= mat_b;
+    mat *= 2.0f;
+    EXPECT_EQ(4, mat(0, 0));
+    mat *= mat_a;
+    Mat3 mat_ref = mat_a * 2.0f * mat_a;
+    Mat3 mat_into;
+    MultiplyInto(mat_into, mat_a * 2.0f, mat_a);
+    Mat3 mat_inv;
+    InverseInto(mat_inv, mat_a);
+    Mat3 mat_t;
+    TransposeInto(mat_t, mat_a);
+    for (int32_t i = 0; i < 9; i++) {
+        EXPECT_FLOAT_EQ(mat_ref[i], mat[i]);
+        EXPECT_FLOAT_EQ(mat_ref[i], mat_into[i]);
+        EXPECT_FLOAT_EQ(mat_a.Inverse()[i], mat_inv[i]);
+        EXPECT_FLOAT_EQ(mat_a.Transpose()[i], mat_t[i]);
+    }
+}
+
+}
@@ -0,0 +1,124 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_gemm.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestMatrixGemm : public testing::Test
+{
+protected:
+    TestMatrixGemm() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestMatrixGemm() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static std::vector<float> CreateRandom(int32_t size, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(size);
+    for (auto& v : data) v = dist(engine);
+    return data;
+}
+
+TEST_F(TestMatrixGemm, BasicTest)
+{
+    EXPECT_TRUE(true);
+    printf("kernel: %s\n", MatrixGemm::GetKernelName());
+}
+
+TEST_F(TestMatrixGemm, Multiply)
+{
+    auto test = [](int32_t m, int32_t n, int32_t k) {
+        std::vector<float> a = CreateRandom(m * k, 1);
+        std::vector<float> b = CreateRandom(k * n, 2);
+        std::vector<float> c(m * n);
+        MatrixGemm::Multiply(a.data(), b.data(), c.data(), m, n, k);
+        for (int32_t row = 0; row < m; row++) {
+            for (int32_t col = 0; col < n; col++) {
+                double expected = 0;
+                for (int32_t i = 0; i < k; i++) expected += static_cast<double>(a[row * k + i]) * b[i * n + col];
+                ASSERT_NEAR(expected, c[row * n + col], 1e-4 * k) << m << "x" << n << "x" << k;
+            }
+        }
+    };
+
+    test(1, 1, 1);
+    test(3, 3, 3);
+    test(4, 4, 4);
+    test(5, 17, 3);
+    test(6, 16, 8);
+    test(33, 65, 31);
+    test(100, 37, 300);     /* k > KC */
+    test(200, 50, 20);      /* m > MC */
+}
+
+TEST_F(TestMatrixGemm, MatrixOperator)
+{
+    const int32_t size = 70;
+    EXPECT_TRUE(MatrixGemm::IsLargeSize(size, size, size));
+    EXPECT_FALSE(MatrixGemm::IsLargeSize(4, 4, 4));
+
+    Matrix mat1(size, size, CreateRandom(size * size, 3));
+    Matrix mat2(size, size, CreateRandom(size * size, 4));
+    Matrix mat = mat1 * mat2;
+    Matrix mat_chain = mat1 * mat2 * mat1;
+    Matrix mat_ref = mat * mat1;
+    for (int32_t row = 0; row < size; row++) {
+        for (int32_t col = 0; col < size; col++) {
+            float expected = 0;
+            for (int32_t i = 0; i < size; i++) expected += mat1(row, i) * mat2(i, col);
+            EXPECT_NEAR(expected, mat(row, col), 1e-4f);
+            EXPECT_NEAR(mat_ref(row, col), mat_chain(row, col), 1e-3f);
+        }
+    }
+
+    /* the destination is used in the expression */
+    mat = mat * mat1;
+    for (int32_t i = 0; i < size * size; i++) {
+        EXPECT_NEAR(mat_ref[i], mat[i], 1e-3f);
+    }
+}
+
+}
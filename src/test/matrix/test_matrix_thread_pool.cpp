@@ -0,0 +1,167 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_gemm.h"
+#include "matrix_thread_pool.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestMatrixThreadPool : public testing::Test
+{
+protected:
+    TestMatrixThreadPool() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestMatrixThreadPool() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+        MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+        m_thread_num = pool.GetThreadNum();
+        m_parallel_threshold = pool.GetParallelThreshold();
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+        MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+        pool.SetThreadNum(m_thread_num);
+        pool.SetParallelThreshold(m_parallel_threshold);
+    }
+
+    int32_t m_thread_num;
+    int64_t m_parallel_threshold;
+};
+
+static std::vector<float> CreateRandom(int32_t size, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(size);
+    for (auto& v : data) v = dist(engine);
+    return data;
+}
+
+TEST_F(TestMatrixThreadPool, ParallelFor)
+{
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    pool.SetThreadNum(4);
+    EXPECT_EQ(4, pool.GetThreadNum());
+
+    std::vector<std::atomic<int32_t>> count_list(1000);
+    for (auto& count : count_list) count = 0;
+    pool.ParallelFor(0, 1000, [&count_list](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) count_list[i]++;
+    });
+    for (const auto& count : count_list) EXPECT_EQ(1, count);
+
+    /* nested */
+    std::atomic<int32_t> sum(0);
+    pool.ParallelFor(0, 10, [&pool, &sum](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) {
+            pool.ParallelFor(0, 10, [&sum](int32_t b, int32_t e) { sum += e - b; });
+        }
+    });
+    EXPECT_EQ(100, sum);
+
+    /* empty range */
+    pool.ParallelFor(5, 5, [](int32_t, int32_t) { FAIL(); });
+
+    /* exception is re-thrown on the calling thread */
+    EXPECT_THROW(pool.ParallelFor(0, 100, [](int32_t begin, int32_t) { if (begin > 0) throw std::runtime_error("test"); }), std::runtime_error);
+
+    pool.SetThreadNum(1);
+    EXPECT_EQ(1, pool.GetThreadNum());
+    EXPECT_FALSE(pool.IsParallelSize(INT64_MAX));
+    sum = 0;
+    pool.ParallelFor(0, 10, [&sum](int32_t begin, int32_t end) { sum += end - begin; });
+    EXPECT_EQ(10, sum);
+
+    EXPECT_THROW(pool.SetThreadNum(-1), std::invalid_argument);
+}
+
+TEST_F(TestMatrixThreadPool, Threshold)
+{
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    pool.SetThreadNum(4);
+    EXPECT_FALSE(pool.IsParallelSize(4 * 4 * 4));
+    EXPECT_FALSE(pool.IsParallelSize(3 * 3 * 3));
+    pool.SetParallelThreshold(1000);
+    EXPECT_EQ(1000, pool.GetParallelThreshold());
+    EXPECT_FALSE(pool.IsParallelSize(999));
+    EXPECT_TRUE(pool.IsParallelSize(1000));
+}
+
+TEST_F(TestMatrixThreadPool, SameAsSingleThread)
+{
+    MatrixThreadPool& pool = MatrixThreadPool::GetInstance();
+    const int32_t size = 150;
+    Matrix mat1(size, size, CreateRandom(size * size, 1));
+    Matrix mat2(size, size, CreateRandom(size * size, 2));
+    for (int32_t i = 0; i < size; i++) mat1(i, i) += size;  /* diagonally dominant for a stable inverse */
+
+    pool.SetThreadNum(1);
+    const Matrix mat_product = mat1 * mat2;
+    const Matrix mat_inverse = mat1.Inverse();
+
+    for (int32_t thread_num : { 2, 3, 8 }) {
+        pool.SetThreadNum(thread_num);
+        pool.SetParallelThreshold(0);
+        const Matrix mat_product_mt = mat1 * mat2;
+        const Matrix mat_inverse_mt = mat1.Inverse();
+        for (int32_t i = 0; i < size * size; i++) {
+            EXPECT_FLOAT_EQ(mat_product[i], mat_product_mt[i]);
+            EXPECT_FLOAT_EQ(mat_inverse[i], mat_inverse_mt[i]);
+        }
+    }
+
+    /* odd shapes */
+    std::vector<float> a = CreateRandom(37 * 300, 3);
+    std::vector<float> b = CreateRandom(300 * 41, 4);
+    std::vector<float> c(37 * 41);
+    std::vector<float> c_mt(37 * 41);
+    pool.SetThreadNum(1);
+    MatrixGemm::Multiply(a.data(), b.data(), c.data(), 37, 41, 300);
+    pool.SetThreadNum(5);
+    MatrixGemm::Multiply(a.data(), b.data(), c_mt.data(), 37, 41, 300);
+    for (size_t i = 0; i < c.size(); i++) {
+        EXPECT_FLOAT_EQ(c[i], c_mt[i]);
+    }
+
+    /* a zero diagonal element throws on a worker as well as on a single thread */
+    Matrix mat_zero(size, size);
+    EXPECT_THROW(mat_zero.Inverse(), std::out_of_range);
+}
+
+}
@@ -0,0 +1,159 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestMatrixView : public testing::Test
+{
+protected:
+    TestMatrixView() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestMatrixView() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+TEST_F(TestMatrixView, BasicTest)
+{
+    EXPECT_TRUE(true);
+}
+
+TEST_F(TestMatrixView, Creation)
+{
+    Matrix mat(4, 4, { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+    ConstMatrixView block = static_cast<const Matrix&>(mat).Block(0, 0, 3, 3);
+    EXPECT_EQ(3, block.Rows());
+    EXPECT_EQ(3, block.Cols());
+    EXPECT_EQ(4, block.Stride());
+    EXPECT_EQ(mat.Data(), block.Data());
+    EXPECT_EQ(7, block(1, 2));
+    EXPECT_EQ(9, block(2, 0));
+
+    MatrixView translation = mat.Block(0, 3, 3, 1);
+    EXPECT_EQ(4, translation(0, 0));
+    EXPECT_EQ(12, translation(2, 0));
+    EXPECT_EQ(14, mat.Row(3)(0, 1));
+    EXPECT_EQ(7, mat.Col(2)(1, 0));
+    EXPECT_EQ(16, mat.View()(3, 3));
+
+    /* a view is copied into a Matrix with the view shape */
+    Matrix mat3 = block;
+    EXPECT_EQ(3, mat3.Rows());
+    EXPECT_EQ(11, mat3(2, 2));
+
+    EXPECT_THROW(mat.Block(2, 2, 3, 3), std::out_of_range);
+    EXPECT_THROW(mat.Block(-1, 0, 1, 1), std::out_of_range);
+    EXPECT_THROW(mat.Row(4), std::out_of_range);
+    EXPECT_THROW(mat.Col(-1), std::out_of_range);
+    EXPECT_THROW(block(3, 0), std::out_of_range);
+}
+
+TEST_F(TestMatrixView, Assignment)
+{
+    Matrix mat = Matrix::Identity(4);
+    Matrix mat3(3, 3, { 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    mat.Block(0, 0, 3, 3) = mat3;
+    mat.Block(0, 3, 3, 1) = Matrix(3, 1, { 10, 11, 12 });
+    EXPECT_EQ(5, mat(1, 1));
+    EXPECT_EQ(11, mat(1, 3));
+    EXPECT_EQ(1, mat(3, 3));
+    EXPECT_EQ(0, mat(3, 0));
+
+    /* write through a view */
+    MatrixView row = mat.Row(3);
+    row(0, 0) = -1;
+    EXPECT_EQ(-1, mat(3, 0));
+
+    /* overlapped source and destination */
+    mat.Block(1, 1, 3, 3) = mat.Block(0, 0, 3, 3);
+    EXPECT_EQ(1, mat(1, 1));
+    EXPECT_EQ(5, mat(2, 2));
+    EXPECT_EQ(3, mat(1, 3));
+
+    EXPECT_THROW(mat.Block(0, 0, 2, 2) = mat3, std::out_of_range);
+}
+
+TEST_F(TestMatrixView, Arithmetic)
+{
+    Matrix mat(4, 4, { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 });
+    Matrix mat3(3, 3, { 1, 0, 0, 0, 2, 0, 0, 0, 3 });
+    Matrix vec(3, 1, { 1, 1, 1 });
+
+    Matrix sum = mat.Block(0, 0, 3, 3) + mat3 * 2.0f;
+    EXPECT_EQ(3, sum(0, 0));
+    EXPECT_EQ(7, sum(1, 2));
+    EXPECT_EQ(17, sum(2, 2));
+
+    Matrix product = mat.Block(0, 0, 3, 3) * vec + mat.Block(0, 3, 3, 1);
+    EXPECT_EQ(6 + 4, product(0, 0));
+    EXPECT_EQ(18 + 8, product(1, 0));
+    EXPECT_EQ(30 + 12, product(2, 0));
+
+    Matrix row_product = mat.Row(0) * mat.Col(1);
+    EXPECT_EQ(2 + 12 + 30 + 56, row_product(0, 0));
+
+    /* the destination is referred by the view */
+    Matrix mat_copy = mat;
+    mat = mat.Block(1, 1, 3, 3) - mat3;
+    EXPECT_EQ(3, mat.Rows());
+    EXPECT_EQ(5, mat(0, 0));
+    EXPECT_EQ(mat_copy(3, 3) - 3, mat(2, 2));
+    EXPECT_THROW(mat_copy += mat_copy.Row(0), std::out_of_range);
+}
+
+TEST_F(TestMatrixView, FixedSize)
+{
+    Mat4 mat4 = Mat4::Identity();
+    Mat3 mat3({ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    mat4.Block(0, 0, 3, 3) = mat3;
+    mat4.Block(0, 3, 3, 1) = Matrix(3, 1, { 10, 11, 12 });
+    EXPECT_EQ(6, mat4(1, 2));
+    EXPECT_EQ(12, mat4(2, 3));
+
+    Mat3 mat3_from_view(mat4.Block(0, 0, 3, 3));
+    Vec3 translation(mat4.Block(0, 3, 3, 1));
+    for (int32_t i = 0; i < 9; i++) {
+        EXPECT_EQ(mat3[i], mat3_from_view[i]);
+    }
+    EXPECT_EQ(11, translation[1]);
+    EXPECT_THROW(Mat3 mat3_invalid(mat4.Block(0, 0, 2, 3)), std::out_of_range);
+}
+
+}
@@ -0,0 +1,249 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "fast_trig.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestFastTrig : public testing::Test
+{
+protected:
+    TestFastTrig() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestFastTrig() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+        RotationMatrix::SetTrigMode(RotationMatrix::TRIG_MODE::EXACT);
+    }
+};
+
+/* The budget for visualization and coarse filtering */
+static constexpr double MAX_FUNCTION_ERROR = 2e-6;
+static constexpr double MAX_ANGULAR_ERROR = 1e-5;
+
+struct ErrorStat
+{
+    double max = 0.0;
+    double sum = 0.0;
+    int64_t count = 0;
+
+    void Add(double error)
+    {
+        max = std::max(max, error);
+        sum += error;
+        count++;
+    }
+
+    void Print(const char* name) const
+    {
+        printf("%-28s max: %.3e, mean: %.3e (%lld samples)\n", name, max, sum / count, static_cast<long long>(count));
+    }
+};
+
+/* The angle of the rotation between a and b: |a - b|_F = 2 sqrt(2) sin(angle / 2) */
+static double AngularError(const Mat3& a, const Mat3& b)
+{
+    double d2 = 0.0;
+    for (int32_t i = 0; i < 9; i++) {
+        const double d = static_cast<double>(a[i]) - b[i];
+        d2 += d * d;
+    }
+    return 2.0 * std::asin(std::min(1.0, std::sqrt(d2) / (2.0 * std::sqrt(2.0))));
+}
+
+/* Rotations covering the rotation group: axes on a Fibonacci sphere times angles in [0, pi] (both ends included) */
+static std::vector<Vec4> CreateAxisAngles()
+{
+    static constexpr int32_t AXIS_NUM = 400;
+    static constexpr int32_t ANGLE_NUM = 97;
+    const double golden_angle = M_PI * (3.0 - std::sqrt(5.0));
+    std::vector<Vec4> axis_angles;
+    for (int32_t a = 0; a < AXIS_NUM; a++) {
+        const double z = 1.0 - 2.0 * (a + 0.5) / AXIS_NUM;
+        const double r = std::sqrt(1.0 - z * z);
+        const double phi = golden_angle * a;
+        for (int32_t i = 0; i < ANGLE_NUM; i++) {
+            const float rad = static_cast<float>(M_PI * i / (ANGLE_NUM - 1));
+            axis_angles.push_back(Vec4({ static_cast<float>(r * std::cos(phi)), static_cast<float>(r * std::sin(phi)), static_cast<float>(z), rad }));
+        }
+    }
+    return axis_angles;
+}
+
+TEST_F(TestFastTrig, Mode)
+{
+    EXPECT_EQ(RotationMatrix::GetTrigMode(), RotationMatrix::TRIG_MODE::EXACT);
+    RotationMatrix::SetTrigMode(RotationMatrix::TRIG_MODE::FAST);
+    EXPECT_EQ(RotationMatrix::GetTrigMode(), RotationMatrix::TRIG_MODE::FAST);
+    RotationMatrix::SetTrigMode(RotationMatrix::TRIG_MODE::EXACT);
+    EXPECT_EQ(RotationMatrix::GetTrigMode(), RotationMatrix::TRIG_MODE::EXACT);
+}
+
+TEST_F(TestFastTrig, Functions)
+{
+    static constexpr int32_t NUM = 1000000;
+    ErrorStat sin_error, cos_error, asin_error, acos_error, atan_error, atan2_error;
+    for (int32_t i = 0; i <= NUM; i++) {
+        const float angle = static_cast<float>(-100.0 + 200.0 * i / NUM);
+        float s, c;
+        FastTrig::SinCos(angle, s, c);
+        sin_error.Add(std::abs(s - std::sin(static_cast<double>(angle))));
+        cos_error.Add(std::abs(c - std::cos(static_cast<double>(angle))));
+
+        const float value = static_cast<float>(-1.0 + 2.0 * i / NUM);
+        asin_error.Add(std::abs(FastTrig::Asin(value) - std::asin(static_cast<double>(value))));
+        acos_error.Add(std::abs(FastTrig::Acos(value) - std::acos(static_cast<double>(value))));
+
+        const float t = static_cast<float>(std::tan(-M_PI / 2 + M_PI * (i + 0.5) / (NUM + 1)));
+        atan_error.Add(std::abs(FastTrig::Atan(t) - std::atan(static_cast<double>(t))));
+
+        const float y = static_cast<float>(std::sin(0.37 * i) * (i % 7));
+        const float x = static_cast<float>(std::cos(0.37 * i) * (i % 5));
+        atan2_error.Add(std::abs(FastTrig::Atan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x))));
+    }
+    sin_error.Print("sin");
+    cos_error.Print("cos");
+    asin_error.Print("asin");
+    acos_error.Print("acos");
+    atan_error.Print("atan");
+    atan2_error.Print("atan2");
+    EXPECT_LT(sin_error.max, MAX_FUNCTION_ERROR);
+    EXPECT_LT(cos_error.max, MAX_FUNCTION_ERROR);
+    EXPECT_LT(asin_error.max, MAX_FUNCTION_ERROR);
+    EXPECT_LT(acos_error.max, MAX_FUNCTION_ERROR);
+    EXPECT_LT(atan_error.max, MAX_FUNCTION_ERROR);
+    EXPECT_LT(atan2_error.max, MAX_FUNCTION_ERROR);
+
+    /* Quadrants and signed zeros as std::atan2 */
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(0.0f, 1.0f), 0.0f);
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(0.0f, -1.0f), static_cast<float>(M_PI));
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(-0.0f, -1.0f), static_cast<float>(-M_PI));
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(1.0f, 0.0f), static_cast<float>(M_PI / 2));
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(-1.0f, 0.0f), static_cast<float>(-M_PI / 2));
+    EXPECT_FLOAT_EQ(FastTrig::Atan2(0.0f, 0.0f), 0.0f);
+}
+
+/* Each conversion in the fast mode against the exact mode. Outputs which are not a matrix are compared as rotations (converted back exactly) */
+TEST_F(TestFastTrig, RotationGroup)
+{
+    using RotationMatrix::TRIG_MODE;
+    const std::vector<Vec4> axis_angles = CreateAxisAngles();
+    ErrorStat rotation_vector2matrix, axis_angle2matrix, euler2matrix, matrix2rotation_vector, matrix2axis_angle, matrix2euler, decompose_all_euler;
+    for (const Vec4& axis_angle : axis_angles) {
+        const float x = axis_angle[0], y = axis_angle[1], z = axis_angle[2], rad = axis_angle[3];
+        Mat3 exact, fast;
+
+        RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+        RotationMatrix::ConvertRotationVector2RotationMatrix(x * rad, y * rad, z * rad, exact);
+        RotationMatrix::SetTrigMode(TRIG_MODE::FAST);
+        RotationMatrix::ConvertRotationVector2RotationMatrix(x * rad, y * rad, z * rad, fast);
+        rotation_vector2matrix.Add(AngularError(exact, fast));
+
+        RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(x, y, z, rad, exact);
+        RotationMatrix::SetTrigMode(TRIG_MODE::FAST);
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(x, y, z, rad, fast);
+        axis_angle2matrix.Add(AngularError(exact, fast));
+
+        /* The sample rotation itself */
+        Mat3 mat3_rot;
+        RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(x, y, z, rad, mat3_rot);
+
+        RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+        const Vec3 vec3_exact = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot);
+        const Vec4 vec4_exact = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_rot);
+        Vec3 mobile_exact[6], fixed_exact[6];
+        RotationMatrix::DecomposeAllEuler(mat3_rot, mobile_exact, fixed_exact);
+        RotationMatrix::SetTrigMode(TRIG_MODE::FAST);
+        const Vec3 vec3_fast = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot);
+        const Vec4 vec4_fast = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_rot);
+        Vec3 mobile_fast[6], fixed_fast[6];
+        RotationMatrix::DecomposeAllEuler(mat3_rot, mobile_fast, fixed_fast);
+        Vec3 euler_fast[6];
+        for (int32_t order = 0; order < 6; order++) {
+            euler_fast[order] = RotationMatrix::ConvertRotationMatrix2EulerMobile(static_cast<RotationMatrix::EULER_ORDER>(order), mat3_rot);
+        }
+
+        RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+        Mat3 from_exact, from_fast;
+        RotationMatrix::ConvertRotationVector2RotationMatrix(vec3_exact[0], vec3_exact[1], vec3_exact[2], from_exact);
+        RotationMatrix::ConvertRotationVector2RotationMatrix(vec3_fast[0], vec3_fast[1], vec3_fast[2], from_fast);
+        matrix2rotation_vector.Add(AngularError(from_exact, from_fast));
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(vec4_exact[0], vec4_exact[1], vec4_exact[2], vec4_exact[3], from_exact);
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(vec4_fast[0], vec4_fast[1], vec4_fast[2], vec4_fast[3], from_fast);
+        matrix2axis_angle.Add(AngularError(from_exact, from_fast));
+        for (int32_t order = 0; order < 6; order++) {
+            const auto euler_order = static_cast<RotationMatrix::EULER_ORDER>(order);
+            const Vec3& e = mobile_exact[order];
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(euler_order, e[0], e[1], e[2], from_exact);
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(euler_order, euler_fast[order][0], euler_fast[order][1], euler_fast[order][2], from_fast);
+            matrix2euler.Add(AngularError(from_exact, from_fast));
+            const Vec3& f = mobile_fast[order];
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(euler_order, f[0], f[1], f[2], from_fast);
+            decompose_all_euler.Add(AngularError(from_exact, from_fast));
+
+            /* Build from the exact euler angles in the fast mode */
+            RotationMatrix::SetTrigMode(TRIG_MODE::FAST);
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(euler_order, e[0], e[1], e[2], from_fast);
+            RotationMatrix::SetTrigMode(TRIG_MODE::EXACT);
+            euler2matrix.Add(AngularError(from_exact, from_fast));
+        }
+    }
+
+    printf("angular error of the fast mode [rad]\n");
+    rotation_vector2matrix.Print("rotation vector -> matrix");
+    axis_angle2matrix.Print("axis angle -> matrix");
+    euler2matrix.Print("euler -> matrix");
+    matrix2rotation_vector.Print("matrix -> rotation vector");
+    matrix2axis_angle.Print("matrix -> axis angle");
+    matrix2euler.Print("matrix -> euler");
+    decompose_all_euler.Print("matrix -> euler (all)");
+    EXPECT_LT(rotation_vector2matrix.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(axis_angle2matrix.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(euler2matrix.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(matrix2rotation_vector.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(matrix2axis_angle.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(matrix2euler.max, MAX_ANGULAR_ERROR);
+    EXPECT_LT(decompose_all_euler.max, MAX_ANGULAR_ERROR);
+}
+
+}
@@ -70,6 +70,37 @@ TEST_F(TestProjectionMatrix, Create)
     );
 }
 
+TEST_F(TestProjectionMatrix, ColMajor)
+{
+    Mat4 mat;
+    Mat4ColMajor mat_col_major;
+    ProjectionMatrix::Orthogonal(-1.0f, 2.0f, -3.0f, 4.0f, 0.1f, 1000.0f, mat);
+    ProjectionMatrix::Orthogonal(-1.0f, 2.0f, -3.0f, 4.0f, 0.1f, 1000.0f, mat_col_major);
+    for (int32_t row = 0; row < 4; row++) {
+        for (int32_t col = 0; col < 4; col++) {
+            EXPECT_FLOAT_EQ(mat(row, col), mat_col_major.Data()[col * 4 + row]);
+        }
+    }
+
+    ProjectionMatrix::Frustum(-1.0f, 2.0f, -3.0f, 4.0f, 0.1f, 1000.0f, mat);
+    ProjectionMatrix::Frustum(-1.0f, 2.0f, -3.0f, 4.0f, 0.1f, 1000.0f, mat_col_major);
+    for (int32_t row = 0; row < 4; row++) {
+        for (int32_t col = 0; col < 4; col++) {
+            EXPECT_FLOAT_EQ(mat(row, col), mat_col_major.Data()[col * 4 + row]);
+        }
+    }
+
+    ProjectionMatrix::Perspective(0.1f, 0.2f, 1.0f, 1920.0f / 1080.0f, 0.1f, 1000.0f, mat);
+    ProjectionMatrix::Perspective(0.1f, 0.2f, 1.0f, 1920.0f / 1080.0f, 0.1f, 1000.0f, mat_col_major);
+    for (int32_t row = 0; row < 4; row++) {
+        for (int32_t col = 0; col < 4; col++) {
+            EXPECT_FLOAT_EQ(mat(row, col), mat_col_major.Data()[col * 4 + row]);
+        }
+    }
+    EXPECT_FLOAT_EQ(-1.0f, mat_col_major(3, 2));
+    EXPECT_FLOAT_EQ(0.1f, mat_col_major(0, 2));
+}
+
 // todo: Add more test cases
 
 }
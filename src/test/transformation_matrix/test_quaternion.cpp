@@ -0,0 +1,179 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "quaternion.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+static inline float Deg2Rad(float deg) { return static_cast<float>(deg * M_PI / 180.0); }
+
+class TestQuaternion : public testing::Test
+{
+protected:
+    TestQuaternion() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestQuaternion() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static void ExpectSameRotation(const Quaternion& q1, const Quaternion& q2)
+{
+    /* q and -q are the same rotation */
+    const float sign = (q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w) < 0 ? -1.0f : 1.0f;
+    EXPECT_NEAR(q1.x, sign * q2.x, 1e-5f);
+    EXPECT_NEAR(q1.y, sign * q2.y, 1e-5f);
+    EXPECT_NEAR(q1.z, sign * q2.z, 1e-5f);
+    EXPECT_NEAR(q1.w, sign * q2.w, 1e-5f);
+}
+
+TEST_F(TestQuaternion, BasicTest)
+{
+    Quaternion q;
+    EXPECT_FLOAT_EQ(q.x, 0.0f);
+    EXPECT_FLOAT_EQ(q.y, 0.0f);
+    EXPECT_FLOAT_EQ(q.z, 0.0f);
+    EXPECT_FLOAT_EQ(q.w, 1.0f);
+
+    q = Quaternion(1, 2, 3, 4);
+    Vec4 vec4 = q.ToVec4();
+    EXPECT_FLOAT_EQ(vec4[0], 1.0f);
+    EXPECT_FLOAT_EQ(vec4[3], 4.0f);
+    EXPECT_FLOAT_EQ(q.Norm(), std::sqrt(30.0f));
+
+    Quaternion q_conjugate = q.Conjugate();
+    EXPECT_FLOAT_EQ(q_conjugate.x, -1.0f);
+    EXPECT_FLOAT_EQ(q_conjugate.w, 4.0f);
+
+    Quaternion q_identity = q * q.Inverse();
+    ExpectSameRotation(q_identity, Quaternion::Identity());
+
+    Quaternion q_normalized = q.Normalize();
+    EXPECT_NEAR(q_normalized.Norm(), 1.0f, 1e-6f);
+
+    EXPECT_THROW(Quaternion(0, 0, 0, 0).Normalize(), std::out_of_range);
+    EXPECT_THROW(Quaternion(0, 0, 0, 0).Inverse(), std::out_of_range);
+}
+
+TEST_F(TestQuaternion, Multiply)
+{
+    const Quaternion q1 = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(40));
+    const Quaternion q2 = Quaternion::FromAxisAngle(-3, 1, 2, Deg2Rad(-70));
+    Mat3 mat1, mat2, mat;
+    q1.ToRotationMatrix(mat1);
+    q2.ToRotationMatrix(mat2);
+    (q1 * q2).ToRotationMatrix(mat);
+    const Mat3 expected = mat1 * mat2;
+    for (int32_t i = 0; i < 9; i++) EXPECT_NEAR(mat[i], expected[i], 1e-5f);
+
+    Quaternion q = q1;
+    q *= q2;
+    ExpectSameRotation(q, q1 * q2);
+}
+
+TEST_F(TestQuaternion, Rotate)
+{
+    const Quaternion q = Quaternion::FromAxisAngle(1, -2, 3, Deg2Rad(123));
+    Mat3 mat3_rot;
+    q.ToRotationMatrix(mat3_rot);
+    const Vec3 vec3({ 0.3f, -1.2f, 2.5f });
+    const Vec3 rotated = q.Rotate(vec3);
+    const Vec3 expected = mat3_rot * vec3;
+    for (int32_t i = 0; i < 3; i++) EXPECT_NEAR(rotated[i], expected[i], 1e-5f);
+
+    /* Rotating by q and then by its inverse gets back to the original vector */
+    const Vec3 reverted = q.Inverse().Rotate(rotated);
+    for (int32_t i = 0; i < 3; i++) EXPECT_NEAR(reverted[i], vec3[i], 1e-5f);
+}
+
+TEST_F(TestQuaternion, Conversion)
+{
+    const Quaternion q = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(40));
+    const Matrix mat_rot = RotationMatrix::ConvertAxisAngle2RotationMatrix(1, 2, 3, Deg2Rad(40));
+    ExpectSameRotation(q, Quaternion::FromRotationMatrix(mat_rot.View()));
+    ExpectSameRotation(q, Quaternion::FromRotationMatrix(Mat3(mat_rot)));
+    ExpectSameRotation(q, Quaternion(RotationMatrix::ConvertRotationMatrix2Quaternion(Mat3(mat_rot))));
+
+    const Vec4 axis_angle = q.ToAxisAngle();
+    const float d = std::sqrt(14.0f);
+    EXPECT_NEAR(axis_angle[0], 1 / d, 1e-5f);
+    EXPECT_NEAR(axis_angle[1], 2 / d, 1e-5f);
+    EXPECT_NEAR(axis_angle[2], 3 / d, 1e-5f);
+    EXPECT_NEAR(axis_angle[3], Deg2Rad(40), 1e-5f);
+
+    /* -q is the same rotation */
+    const Vec4 axis_angle_negative = Quaternion(-q.x, -q.y, -q.z, -q.w).ToAxisAngle();
+    for (int32_t i = 0; i < 4; i++) EXPECT_NEAR(axis_angle_negative[i], axis_angle[i], 1e-5f);
+
+    const Vec3 rotation_vector = q.ToRotationVector();
+    ExpectSameRotation(q, Quaternion::FromRotationVector(rotation_vector[0], rotation_vector[1], rotation_vector[2]));
+
+    const Vec4 axis_angle_zero = Quaternion::Identity().ToAxisAngle();
+    for (int32_t i = 0; i < 4; i++) EXPECT_FLOAT_EQ(axis_angle_zero[i], 0.0f);
+    ExpectSameRotation(Quaternion::FromRotationVector(0, 0, 0), Quaternion::Identity());
+}
+
+TEST_F(TestQuaternion, Euler)
+{
+    const float x = Deg2Rad(10), y = Deg2Rad(-20), z = Deg2Rad(30);
+    for (int32_t i = 0; i < 6; i++) {
+        const auto order = static_cast<RotationMatrix::EULER_ORDER>(i);
+        Mat3 mat3_rot;
+        RotationMatrix::ConvertEulerMobile2RotationMatrix(order, x, y, z, mat3_rot);
+        const Quaternion q_mobile = Quaternion::FromEulerMobile(order, x, y, z);
+        ExpectSameRotation(q_mobile, Quaternion::FromRotationMatrix(mat3_rot));
+        const Vec3 mobile = q_mobile.ToEulerMobile(order);
+        EXPECT_NEAR(mobile[0], x, 1e-5f);
+        EXPECT_NEAR(mobile[1], y, 1e-5f);
+        EXPECT_NEAR(mobile[2], z, 1e-5f);
+
+        RotationMatrix::ConvertEulerFixed2RotationMatrix(order, x, y, z, mat3_rot);
+        const Quaternion q_fixed = Quaternion::FromEulerFixed(order, x, y, z);
+        ExpectSameRotation(q_fixed, Quaternion::FromRotationMatrix(mat3_rot));
+        const Vec3 fixed = q_fixed.ToEulerFixed(order);
+        EXPECT_NEAR(fixed[0], x, 1e-5f);
+        EXPECT_NEAR(fixed[1], y, 1e-5f);
+        EXPECT_NEAR(fixed[2], z, 1e-5f);
+    }
+}
+
+}
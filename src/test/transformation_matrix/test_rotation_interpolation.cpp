@@ -0,0 +1,207 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix_fixed.h"
+#include "quaternion.h"
+#include "rotation_interpolation.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+static inline float Deg2Rad(float deg) { return static_cast<float>(deg * M_PI / 180.0); }
+
+class TestRotationInterpolation : public testing::Test
+{
+protected:
+    TestRotationInterpolation() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestRotationInterpolation() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+/* Rotation angle between two orientations. atan2 is used because acos is not accurate for a small angle */
+static float GetAngle(const Quaternion& q0, const Quaternion& q1)
+{
+    const double a[4] = { q0.x, q0.y, q0.z, q0.w };
+    const double b[4] = { q1.x, q1.y, q1.z, q1.w };
+    const double sign = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0 ? -1.0 : 1.0;
+    double diff = 0, sum = 0;
+    for (int32_t i = 0; i < 4; i++) {
+        diff += (a[i] - sign * b[i]) * (a[i] - sign * b[i]);
+        sum += (a[i] + sign * b[i]) * (a[i] + sign * b[i]);
+    }
+    return static_cast<float>(4 * std::atan2(std::sqrt(diff), std::sqrt(sum)));
+}
+
+static void ExpectSameQuaternion(const Quaternion& q0, const Quaternion& q1, float tolerance)
+{
+    EXPECT_NEAR(q0.x, q1.x, tolerance);
+    EXPECT_NEAR(q0.y, q1.y, tolerance);
+    EXPECT_NEAR(q0.z, q1.z, tolerance);
+    EXPECT_NEAR(q0.w, q1.w, tolerance);
+}
+
+TEST_F(TestRotationInterpolation, Slerp)
+{
+    const Quaternion q0 = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(20));
+    const Quaternion q1 = Quaternion::FromAxisAngle(-2, 1, 0.5f, Deg2Rad(130));
+    const float angle = GetAngle(q0, q1);
+    ExpectSameQuaternion(RotationInterpolation::Slerp(q0, q1, 0.0f), q0, 1e-6f);
+    ExpectSameQuaternion(RotationInterpolation::Slerp(q0, q1, 1.0f), q1, 1e-6f);
+    for (float t = 0.0f; t <= 1.0f; t += 0.125f) {
+        /* constant angular velocity */
+        const Quaternion q = RotationInterpolation::Slerp(q0, q1, t);
+        EXPECT_NEAR(q.Norm(), 1.0f, 1e-6f);
+        EXPECT_NEAR(GetAngle(q0, q), t * angle, 1e-3f);
+        EXPECT_NEAR(GetAngle(q, q1), (1 - t) * angle, 1e-3f);
+
+        /* -q1 is the same rotation, and the result is the same by the shortest path */
+        ExpectSameQuaternion(RotationInterpolation::Slerp(q0, Quaternion(-q1.x, -q1.y, -q1.z, -q1.w), t), q, 1e-6f);
+    }
+
+    /* Very small angle */
+    const Quaternion q_close = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(20) + 1e-7f);
+    ExpectSameQuaternion(RotationInterpolation::Slerp(q0, q_close, 0.5f), q0, 1e-6f);
+}
+
+TEST_F(TestRotationInterpolation, Nlerp)
+{
+    const Quaternion q0 = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(20));
+    for (float deg = 10.0f; deg <= 180.0f; deg += 10.0f) {
+        const Quaternion q1 = Quaternion::FromAxisAngle(-2, 1, 0.5f, Deg2Rad(deg));
+        const float error_bound = RotationInterpolation::NlerpErrorBound(q0, q1);
+        for (float t = 0.0f; t <= 1.0f; t += 0.0625f) {
+            const Quaternion q_nlerp = RotationInterpolation::Nlerp(q0, q1, t);
+            const Quaternion q_slerp = RotationInterpolation::Slerp(q0, q1, t);
+            EXPECT_NEAR(q_nlerp.Norm(), 1.0f, 1e-6f);
+            EXPECT_LE(GetAngle(q_nlerp, q_slerp), error_bound + 1e-5f);
+
+            /* Slerp is used if the error bound is too large */
+            const Quaternion q = RotationInterpolation::Nlerp(q0, q1, t, error_bound * 0.5f);
+            ExpectSameQuaternion(q, q_slerp, 1e-6f);
+            const Quaternion q_allowed = RotationInterpolation::Nlerp(q0, q1, t, error_bound * 2.0f);
+            ExpectSameQuaternion(q_allowed, q_nlerp, 1e-6f);
+        }
+    }
+}
+
+TEST_F(TestRotationInterpolation, Squad)
+{
+    const Quaternion q1 = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(20));
+    const Quaternion q2 = Quaternion::FromAxisAngle(-2, 1, 0.5f, Deg2Rad(60));
+    ExpectSameQuaternion(RotationInterpolation::Squad(q1, q2, q1, q2, 0.3f), RotationInterpolation::Slerp(q1, q2, 0.3f), 1e-6f);
+
+    /* Keyframes rotating at constant speed around an axis don't need any correction */
+    std::vector<Quaternion> keyframe;
+    for (int32_t i = 0; i < 4; i++) keyframe.push_back(Quaternion::FromAxisAngle(0, 0, 1, Deg2Rad(30.0f * i)));
+    const Quaternion s1 = RotationInterpolation::SquadControlPoint(keyframe[0], keyframe[1], keyframe[2]);
+    const Quaternion s2 = RotationInterpolation::SquadControlPoint(keyframe[1], keyframe[2], keyframe[3]);
+    ExpectSameQuaternion(s1, keyframe[1], 1e-6f);
+    ExpectSameQuaternion(s2, keyframe[2], 1e-6f);
+    ExpectSameQuaternion(RotationInterpolation::Squad(keyframe[1], keyframe[2], s1, s2, 0.5f), Quaternion::FromAxisAngle(0, 0, 1, Deg2Rad(45)), 1e-6f);
+
+    /* Go through the keyframes */
+    const Quaternion q0 = Quaternion::FromAxisAngle(0, 1, 0, Deg2Rad(-30));
+    const Quaternion q3 = Quaternion::FromAxisAngle(1, 0, 0, Deg2Rad(90));
+    const Quaternion c1 = RotationInterpolation::SquadControlPoint(q0, q1, q2);
+    const Quaternion c2 = RotationInterpolation::SquadControlPoint(q1, q2, q3);
+    EXPECT_NEAR(GetAngle(RotationInterpolation::Squad(q1, q2, c1, c2, 0.0f), q1), 0.0f, 1e-3f);
+    EXPECT_NEAR(GetAngle(RotationInterpolation::Squad(q1, q2, c1, c2, 1.0f), q2), 0.0f, 1e-3f);
+}
+
+TEST_F(TestRotationInterpolation, Batch)
+{
+    /* Not a multiple of the block size, to test the remainder */
+    static constexpr int32_t NUM = 300;
+    const std::vector<float> t = { 0.0f, 0.1f, 0.5f, 0.77f, 1.0f };
+    const int32_t num_t = static_cast<int32_t>(t.size());
+    std::vector<Quaternion> q0_list, q1_list, s0_list, s1_list;
+    for (int32_t i = 0; i < NUM; i++) {
+        q0_list.push_back(Quaternion::FromAxisAngle(std::sin(0.1f * i), std::cos(0.3f * i), 0.5f, Deg2Rad(static_cast<float>(i % 360))));
+        /* include the pairs on the opposite side, far away, and very close */
+        const float deg = (i % 3 == 0) ? 1e-4f : static_cast<float>((i * 7) % 360);
+        q1_list.push_back(q0_list[i] * Quaternion::FromAxisAngle(1, std::sin(0.7f * i), 0.2f, Deg2Rad(deg)));
+        s0_list.push_back(q0_list[i] * Quaternion::FromAxisAngle(0, 1, 0, Deg2Rad(5)));
+        s1_list.push_back(q1_list[i] * Quaternion::FromAxisAngle(1, 0, 0, Deg2Rad(-5)));
+    }
+    const auto to_planes = [](const std::vector<Quaternion>& q_list) {
+        std::vector<float> planes(NUM * 4);
+        for (int32_t i = 0; i < NUM; i++) {
+            planes[0 * NUM + i] = q_list[i].x;
+            planes[1 * NUM + i] = q_list[i].y;
+            planes[2 * NUM + i] = q_list[i].z;
+            planes[3 * NUM + i] = q_list[i].w;
+        }
+        return planes;
+    };
+    const std::vector<float> quat0 = to_planes(q0_list);
+    const std::vector<float> quat1 = to_planes(q1_list);
+    const std::vector<float> s0 = to_planes(s0_list);
+    const std::vector<float> s1 = to_planes(s1_list);
+    std::vector<float> quat(NUM * 4 * num_t);
+    const auto get_result = [&](int32_t j, int32_t i) {
+        const float* p = quat.data() + j * 4 * NUM;
+        return Quaternion(p[0 * NUM + i], p[1 * NUM + i], p[2 * NUM + i], p[3 * NUM + i]);
+    };
+
+    RotationInterpolation::Slerps(quat0.data(), quat1.data(), NUM, t.data(), num_t, quat.data());
+    for (int32_t j = 0; j < num_t; j++) {
+        for (int32_t i = 0; i < NUM; i++) {
+            ExpectSameQuaternion(get_result(j, i), RotationInterpolation::Slerp(q0_list[i], q1_list[i], t[j]), 1e-5f);
+        }
+    }
+
+    const float max_error_rad = Deg2Rad(0.1f);
+    RotationInterpolation::Nlerps(quat0.data(), quat1.data(), NUM, t.data(), num_t, max_error_rad, quat.data());
+    for (int32_t j = 0; j < num_t; j++) {
+        for (int32_t i = 0; i < NUM; i++) {
+            ExpectSameQuaternion(get_result(j, i), RotationInterpolation::Nlerp(q0_list[i], q1_list[i], t[j], max_error_rad), 1e-5f);
+        }
+    }
+
+    RotationInterpolation::Squads(quat0.data(), quat1.data(), s0.data(), s1.data(), NUM, t.data(), num_t, quat.data());
+    for (int32_t j = 0; j < num_t; j++) {
+        for (int32_t i = 0; i < NUM; i++) {
+            ExpectSameQuaternion(get_result(j, i), RotationInterpolation::Squad(q0_list[i], q1_list[i], s0_list[i], s1_list[i], t[j]), 1e-5f);
+        }
+    }
+}
+
+}
@@ -0,0 +1,129 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "rotation_kernel.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+class TestRotationKernel : public testing::Test
+{
+protected:
+    TestRotationKernel() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestRotationKernel() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+/* Not a multiple of any vector width, to test the tail */
+static constexpr int32_t NUM = 1001;
+
+TEST_F(TestRotationKernel, Trigonometric)
+{
+    std::vector<float> angle(NUM), value(NUM), y(NUM), x(NUM);
+    for (int32_t i = 0; i < NUM; i++) {
+        angle[i] = -100.0f + 200.0f * i / (NUM - 1);
+        value[i] = -1.0f + 2.0f * i / (NUM - 1);
+        y[i] = std::sin(0.37f * i) * (i % 7);
+        x[i] = std::cos(0.37f * i) * (i % 5);
+    }
+
+    for (const RotationKernel::Kernel* kernel : RotationKernel::GetSupported()) {
+        printf("kernel: %s\n", kernel->name);
+        std::vector<float> s(NUM), c(NUM), result(NUM);
+        kernel->sincos(angle.data(), NUM, s.data(), c.data());
+        for (int32_t i = 0; i < NUM; i++) {
+            EXPECT_NEAR(s[i], std::sin(angle[i]), 2e-6f) << kernel->name << ": " << angle[i];
+            EXPECT_NEAR(c[i], std::cos(angle[i]), 2e-6f) << kernel->name << ": " << angle[i];
+        }
+
+        kernel->asin(value.data(), NUM, result.data());
+        for (int32_t i = 0; i < NUM; i++) {
+            EXPECT_NEAR(result[i], std::asin(value[i]), 2e-6f) << kernel->name << ": " << value[i];
+        }
+
+        kernel->atan2(y.data(), x.data(), NUM, result.data());
+        for (int32_t i = 0; i < NUM; i++) {
+            EXPECT_NEAR(result[i], std::atan2(y[i], x[i]), 2e-6f) << kernel->name << ": " << y[i] << ", " << x[i];
+        }
+    }
+}
+
+TEST_F(TestRotationKernel, Quaternion)
+{
+    /* Include rotations near 180 degrees to go through every case of matrix_to_quaternion */
+    std::vector<float> x(NUM), y(NUM), z(NUM), w(NUM);
+    for (int32_t i = 0; i < NUM; i++) {
+        const float rad = static_cast<float>(2.0 * M_PI * i / (NUM - 1));
+        const float ax = std::sin(0.1f * i), ay = std::cos(0.3f * i), az = std::sin(0.7f * i + 1.0f);
+        const float norm = std::sqrt(ax * ax + ay * ay + az * az);
+        x[i] = ax / norm * std::sin(rad / 2);
+        y[i] = ay / norm * std::sin(rad / 2);
+        z[i] = az / norm * std::sin(rad / 2);
+        w[i] = std::cos(rad / 2);
+    }
+
+    for (const RotationKernel::Kernel* kernel : RotationKernel::GetSupported()) {
+        std::vector<float> mat3_rot(9 * NUM);
+        kernel->quaternion_to_matrix(x.data(), y.data(), z.data(), w.data(), NUM, mat3_rot.data(), NUM);
+        for (int32_t i = 0; i < NUM; i++) {
+            Mat3 expected;
+            RotationMatrix::ConvertQuaternion2RotationMatrix(x[i], y[i], z[i], w[i], expected);
+            for (int32_t k = 0; k < 9; k++) {
+                EXPECT_NEAR(mat3_rot[k * NUM + i], expected(k / 3, k % 3), 1e-5f) << kernel->name << ": " << i;
+            }
+        }
+
+        std::vector<float> qx(NUM), qy(NUM), qz(NUM), qw(NUM);
+        kernel->matrix_to_quaternion(mat3_rot.data(), NUM, NUM, qx.data(), qy.data(), qz.data(), qw.data());
+        for (int32_t i = 0; i < NUM; i++) {
+            /* q and -q are the same rotation */
+            const float sign = (qx[i] * x[i] + qy[i] * y[i] + qz[i] * z[i] + qw[i] * w[i]) < 0 ? -1.0f : 1.0f;
+            EXPECT_NEAR(sign * qx[i], x[i], 1e-5f) << kernel->name << ": " << i;
+            EXPECT_NEAR(sign * qy[i], y[i], 1e-5f) << kernel->name << ": " << i;
+            EXPECT_NEAR(sign * qz[i], z[i], 1e-5f) << kernel->name << ": " << i;
+            EXPECT_NEAR(sign * qw[i], w[i], 1e-5f) << kernel->name << ": " << i;
+        }
+    }
+}
+
+}
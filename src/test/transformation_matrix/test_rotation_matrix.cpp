@@ -20,11 +20,13 @@ limitations under the License.
 #include <cmath>
 #include <cstdlib>
 #include <stdexcept>
+#include <vector>
 
 /* GoogleTest */
 #include <gtest/gtest.h>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 #include "rotation_matrix.h"
 
 namespace {
@@ -135,6 +137,67 @@ TEST_F(TestRotationMatrix, NormalizeRotationMatrix)
 }
 
 
+TEST_F(TestRotationMatrix, NormalizeMethods)
+{
+    static const RotationMatrix::NORMALIZE_METHOD METHODS[3] = {
+        RotationMatrix::NORMALIZE_METHOD::QUATERNION, RotationMatrix::NORMALIZE_METHOD::GRAM_SCHMIDT, RotationMatrix::NORMALIZE_METHOD::POLAR };
+    const auto expect_rotation = [](const Mat3& mat3_rot) {
+        const Mat3 product = mat3_rot.Transpose() * mat3_rot;
+        const Mat3 identity = Mat3::Identity();
+        for (int32_t k = 0; k < 9; k++) EXPECT_NEAR(identity[k], product[k], 1e-5f);
+        const float det = mat3_rot(0, 0) * (mat3_rot(1, 1) * mat3_rot(2, 2) - mat3_rot(1, 2) * mat3_rot(2, 1))
+            - mat3_rot(0, 1) * (mat3_rot(1, 0) * mat3_rot(2, 2) - mat3_rot(1, 2) * mat3_rot(2, 0))
+            + mat3_rot(0, 2) * (mat3_rot(1, 0) * mat3_rot(2, 1) - mat3_rot(1, 1) * mat3_rot(2, 0));
+        EXPECT_NEAR(1.0f, det, 1e-5f);
+    };
+    const auto distance2 = [](const Mat3& a, const Mat3& b) {
+        float d = 0.0f;
+        for (int32_t k = 0; k < 9; k++) d += (a[k] - b[k]) * (a[k] - b[k]);
+        return d;
+    };
+
+    /* Drifted rotations */
+    static constexpr int32_t NUM = 300;
+    std::vector<float> mat3_drifted(NUM * 9);
+    for (int32_t i = 0; i < NUM; i++) {
+        Mat3 mat3_rot;
+        RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::XYZ, Deg2Rad(static_cast<float>(i % 170 - 85)), Deg2Rad(static_cast<float>((i * 7) % 360 - 180)), Deg2Rad(static_cast<float>((i * 13) % 360 - 180)), mat3_rot);
+        for (int32_t k = 0; k < 9; k++) mat3_drifted[k * NUM + i] = mat3_rot[k] + 0.01f * std::sin(static_cast<float>(i * 9 + k));
+    }
+    for (const auto method : METHODS) {
+        std::vector<float> mat3_normalized = mat3_drifted;
+        RotationMatrix::NormalizeRotationMatrices(mat3_normalized.data(), NUM, method);
+        for (int32_t i = 0; i < NUM; i++) {
+            Mat3 mat3_input;
+            for (int32_t k = 0; k < 9; k++) mat3_input[k] = mat3_drifted[k * NUM + i];
+            const Mat3 expected = RotationMatrix::NormalizeRotationMatrix(mat3_input, method);
+            expect_rotation(expected);
+            for (int32_t k = 0; k < 9; k++) {
+                EXPECT_NEAR(expected[k], mat3_normalized[k * NUM + i], 1e-5f);
+                EXPECT_NEAR(mat3_input[k], expected[k], 0.05f);
+            }
+            /* The polar decomposition gives the closest rotation */
+            if (method == RotationMatrix::NORMALIZE_METHOD::POLAR) {
+                for (const auto other : METHODS) {
+                    EXPECT_LE(distance2(mat3_input, expected), distance2(mat3_input, RotationMatrix::NormalizeRotationMatrix(mat3_input, other)) + 1e-6f);
+                }
+            }
+            /* Gram-Schmidt keeps the direction of the first column */
+            if (method == RotationMatrix::NORMALIZE_METHOD::GRAM_SCHMIDT) {
+                const float norm = std::sqrt(mat3_input[0] * mat3_input[0] + mat3_input[3] * mat3_input[3] + mat3_input[6] * mat3_input[6]);
+                for (int32_t row = 0; row < 3; row++) EXPECT_NEAR(mat3_input(row, 0) / norm, expected(row, 0), 1e-6f);
+            }
+        }
+    }
+
+    /* The rotation of R * S (S is symmetric positive definite) is R */
+    Mat3 mat3_rot;
+    RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::ZYX, 0.3f, -1.2f, 2.5f, mat3_rot);
+    const Mat3 mat3_stretch({ 1.5f, 0.2f, 0.0f, 0.2f, 0.7f, 0.1f, 0.0f, 0.1f, 1.1f });
+    const Mat3 mat3_polar = RotationMatrix::NormalizeRotationMatrix(mat3_rot * mat3_stretch, RotationMatrix::NORMALIZE_METHOD::POLAR);
+    for (int32_t k = 0; k < 9; k++) EXPECT_NEAR(mat3_rot[k], mat3_polar[k], 1e-5f);
+}
+
 TEST_F(TestRotationMatrix, RotationVector)
 {
     auto test = [](float x_deg, float y_deg, float z_deg) {
@@ -165,6 +228,68 @@ TEST_F(TestRotationMatrix, RotationVector)
     test(90, 90, 90);
 }
 
+TEST_F(TestRotationMatrix, ExpLog)
+{
+    /* Rotation vectors near 0 (series), in the middle and near pi */
+    std::vector<Vec3> vecs;
+    const float axes[][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.6f, -0.48f, 0.64f }, { -0.36f, 0.48f, -0.8f } };
+    const float rads[] = { 1e-8f, 1e-6f, 1e-4f, 1e-3f, 0.05f, 0.099f, 0.101f, 0.5f, 1.0f, 2.0f, 2.8f, 3.0f, 3.14f, 3.1415f, static_cast<float>(M_PI) - 1e-6f };
+    for (const auto& axis : axes) {
+        for (float rad : rads) vecs.push_back(Vec3({ axis[0] * rad, axis[1] * rad, axis[2] * rad }));
+    }
+
+    for (const Vec3& vec : vecs) {
+        /* Rodrigues' formula in double as the reference */
+        const double rad = std::sqrt(static_cast<double>(vec[0]) * vec[0] + static_cast<double>(vec[1]) * vec[1] + static_cast<double>(vec[2]) * vec[2]);
+        const double k[3] = { vec[0] / rad, vec[1] / rad, vec[2] / rad };
+        const double c = std::cos(rad), s = std::sin(rad), t = 1.0 - c;
+        const double expected[9] = {
+            t * k[0] * k[0] + c, t * k[0] * k[1] - k[2] * s, t * k[0] * k[2] + k[1] * s,
+            t * k[0] * k[1] + k[2] * s, t * k[1] * k[1] + c, t * k[1] * k[2] - k[0] * s,
+            t * k[0] * k[2] - k[1] * s, t * k[1] * k[2] + k[0] * s, t * k[2] * k[2] + c };
+        Mat3 mat3_rot;
+        RotationMatrix::ConvertRotationVector2RotationMatrix(vec[0], vec[1], vec[2], mat3_rot);
+        for (int32_t i = 0; i < 9; i++) EXPECT_NEAR(expected[i], mat3_rot[i], 1e-6);
+
+        /* relative error is kept for tiny angles */
+        const Vec3 vec_reverted = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot);
+        for (int32_t i = 0; i < 3; i++) EXPECT_NEAR(vec[i], vec_reverted[i], 1e-4f * rad + 1e-3f * static_cast<float>(rad > 3.0));
+    }
+
+    /* At exactly pi, v and -v are the same rotation. Both are accepted */
+    const Mat3 mat3_pi({ -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f });
+    const Vec3 vec_pi = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_pi);
+    EXPECT_NEAR(0.0f, vec_pi[0], 1e-6f);
+    EXPECT_NEAR(static_cast<float>(M_PI), std::abs(vec_pi[1]), 1e-6f);
+    EXPECT_NEAR(0.0f, vec_pi[2], 1e-6f);
+    const Vec4 axis_angle = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_pi);
+    EXPECT_NEAR(1.0f, std::abs(axis_angle[1]), 1e-6f);
+    EXPECT_NEAR(static_cast<float>(M_PI), axis_angle[3], 1e-6f);
+    const Vec4 axis_angle_identity = RotationMatrix::ConvertRotationMatrix2AxisAngle(Mat3::Identity());
+    for (int32_t i = 0; i < 4; i++) EXPECT_EQ(0.0f, axis_angle_identity[i]);
+
+    /* Batch versions give the same results */
+    const int32_t num = static_cast<int32_t>(vecs.size());
+    std::vector<float> in[3];
+    std::vector<float> out[3];
+    for (int32_t k = 0; k < 3; k++) {
+        in[k].resize(num);
+        out[k].resize(num);
+        for (int32_t i = 0; i < num; i++) in[k][i] = vecs[i][k];
+    }
+    std::vector<float> mat3_rot(num * 9);
+    RotationMatrix::ConvertRotationVectors2RotationMatrices(in[0].data(), in[1].data(), in[2].data(), num, mat3_rot.data());
+    RotationMatrix::ConvertRotationMatrices2RotationVectors(mat3_rot.data(), num, out[0].data(), out[1].data(), out[2].data());
+    for (int32_t i = 0; i < num; i++) {
+        Mat3 expected;
+        RotationMatrix::ConvertRotationVector2RotationMatrix(in[0][i], in[1][i], in[2][i], expected);
+        for (int32_t k = 0; k < 9; k++) EXPECT_NEAR(expected[k], mat3_rot[k * num + i], 1e-6f);
+        const Vec3 vec3 = RotationMatrix::ConvertRotationMatrix2RotationVector(expected);
+        const float rad = std::sqrt(vec3[0] * vec3[0] + vec3[1] * vec3[1] + vec3[2] * vec3[2]);
+        for (int32_t k = 0; k < 3; k++) EXPECT_NEAR(vec3[k], out[k][i], 1e-5f * rad);
+    }
+}
+
 TEST_F(TestRotationMatrix, AxisAngles)
 {
     auto test = [](float x, float y, float z, float rad) {
@@ -259,6 +384,34 @@ TEST_F(TestRotationMatrix, EulerFixed)
     test(10, 20, -30);
 }
 
+/* Compare with the product of rotations around each axis */
+TEST_F(TestRotationMatrix, EulerProduct)
+{
+    auto test = [](float x_deg, float y_deg, float z_deg) {
+        const Matrix rot[3] = { RotationMatrix::RotateX(Deg2Rad(x_deg)), RotationMatrix::RotateY(Deg2Rad(y_deg)), RotationMatrix::RotateZ(Deg2Rad(z_deg)) };
+        /* axes of mobile angles from left to right */
+        static constexpr int32_t AXES[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+        for (int32_t i = 0; i < 6; i++) {
+            const auto order = static_cast<RotationMatrix::EULER_ORDER>(i);
+            const Matrix expected_mobile = rot[AXES[i][0]] * rot[AXES[i][1]] * rot[AXES[i][2]];
+            const Matrix expected_fixed = rot[AXES[i][2]] * rot[AXES[i][1]] * rot[AXES[i][0]];
+            const Matrix mobile = RotationMatrix::ConvertEulerMobile2RotationMatrix(order, Deg2Rad(x_deg), Deg2Rad(y_deg), Deg2Rad(z_deg));
+            const Matrix fixed = RotationMatrix::ConvertEulerFixed2RotationMatrix(order, Deg2Rad(x_deg), Deg2Rad(y_deg), Deg2Rad(z_deg));
+            for (int32_t k = 0; k < 9; k++) {
+                EXPECT_NEAR(mobile[k], expected_mobile[k], 1e-6f) << i;
+                EXPECT_NEAR(fixed[k], expected_fixed[k], 1e-6f) << i;
+            }
+        }
+    };
+
+    test(0, 0, 0);
+    test(10, 20, 30);
+    test(-10, 20, 30);
+    test(10, -20, 30);
+    test(10, 20, -30);
+    test(170, -90, 45);
+}
+
 TEST_F(TestRotationMatrix, PolarCoordinate)
 {
     auto test = [](float x, float y, float z) {
@@ -276,4 +429,215 @@ TEST_F(TestRotationMatrix, PolarCoordinate)
     test(10, 20, -30);
 }
 
+TEST_F(TestRotationMatrix, FixedSize)
+{
+    auto expect_same = [](const Matrix& mat, const float* data, int32_t size) {
+        for (int32_t i = 0; i < size; i++) {
+            EXPECT_FLOAT_EQ(mat[i], data[i]);
+        }
+    };
+
+    Mat3 mat3_rot;
+    RotationMatrix::RotateX(Deg2Rad(30.0f), mat3_rot);
+    expect_same(RotationMatrix::RotateX(Deg2Rad(30.0f)), mat3_rot.Data(), 9);
+    RotationMatrix::ConvertQuaternion2RotationMatrix(1, 2, 3, 4, mat3_rot);
+    expect_same(RotationMatrix::ConvertQuaternion2RotationMatrix(1, 2, 3, 4), mat3_rot.Data(), 9);
+    RotationMatrix::ConvertRotationVector2RotationMatrix(0.1f, 0.2f, 0.3f, mat3_rot);
+    expect_same(RotationMatrix::ConvertRotationVector2RotationMatrix(0.1f, 0.2f, 0.3f), mat3_rot.Data(), 9);
+
+    for (int32_t i = 0; i < 6; i++) {
+        RotationMatrix::EULER_ORDER order = static_cast<RotationMatrix::EULER_ORDER>(i);
+        RotationMatrix::ConvertEulerMobile2RotationMatrix(order, 0.1f, 0.2f, 0.3f, mat3_rot);
+        Matrix mat_rot = RotationMatrix::ConvertEulerMobile2RotationMatrix(order, 0.1f, 0.2f, 0.3f);
+        expect_same(mat_rot, mat3_rot.Data(), 9);
+        expect_same(RotationMatrix::ConvertRotationMatrix2EulerMobile(order, mat_rot), RotationMatrix::ConvertRotationMatrix2EulerMobile(order, mat3_rot).Data(), 3);
+        RotationMatrix::ConvertEulerFixed2RotationMatrix(order, 0.1f, 0.2f, 0.3f, mat3_rot);
+        mat_rot = RotationMatrix::ConvertEulerFixed2RotationMatrix(order, 0.1f, 0.2f, 0.3f);
+        expect_same(mat_rot, mat3_rot.Data(), 9);
+        expect_same(RotationMatrix::ConvertRotationMatrix2EulerFixed(order, mat_rot), RotationMatrix::ConvertRotationMatrix2EulerFixed(order, mat3_rot).Data(), 3);
+    }
+
+    Matrix mat_rot = static_cast<Matrix>(mat3_rot);
+    expect_same(RotationMatrix::ConvertRotationMatrix2Quaternion(mat_rot), RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot).Data(), 4);
+    expect_same(RotationMatrix::ConvertRotationMatrix2AxisAngle(mat_rot), RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_rot).Data(), 4);
+    expect_same(RotationMatrix::ConvertRotationMatrix2RotationVector(mat_rot), RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot).Data(), 3);
+
+    EXPECT_THROW(RotationMatrix::ConvertRotationMatrix2Quaternion(Matrix(2, 2)), std::out_of_range);
+}
+
+
+TEST_F(TestRotationMatrix, View)
+{
+    Mat3 mat3_rot;
+    RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::ZXY, 0.1f, 0.2f, 0.3f, mat3_rot);
+    Matrix mat4 = Matrix::Identity(4);
+    mat4.Block(0, 0, 3, 3) = mat3_rot;
+    ConstMatrixView view = static_cast<const Matrix&>(mat4).Block(0, 0, 3, 3);
+
+    Vec4 quaternion = RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot);
+    Vec4 quaternion_view = RotationMatrix::ConvertRotationMatrix2Quaternion(view);
+    Vec4 axis_angle = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat3_rot);
+    Vec4 axis_angle_view = RotationMatrix::ConvertRotationMatrix2AxisAngle(mat4.Block(0, 0, 3, 3));
+    for (int32_t i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(quaternion[i], quaternion_view[i]);
+        EXPECT_FLOAT_EQ(axis_angle[i], axis_angle_view[i]);
+    }
+    Vec3 rotation_vector = RotationMatrix::ConvertRotationMatrix2RotationVector(mat3_rot);
+    Vec3 rotation_vector_view = RotationMatrix::ConvertRotationMatrix2RotationVector(view);
+    Vec3 euler = RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER::ZXY, view);
+    Vec3 euler_fixed = RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER::YXZ, view);
+    EXPECT_FLOAT_EQ(0.1f, euler[0]);
+    EXPECT_FLOAT_EQ(0.2f, euler[1]);
+    EXPECT_FLOAT_EQ(0.3f, euler[2]);
+    for (int32_t i = 0; i < 3; i++) {
+        EXPECT_FLOAT_EQ(rotation_vector[i], rotation_vector_view[i]);
+        EXPECT_FLOAT_EQ(euler[i], euler_fixed[i]);
+    }
+    Mat3 mat3_normalized = RotationMatrix::NormalizeRotationMatrix(view);
+    for (int32_t i = 0; i < 9; i++) {
+        EXPECT_NEAR(mat3_rot[i], mat3_normalized[i], 1e-6f);
+    }
+
+    EXPECT_THROW(RotationMatrix::ConvertRotationMatrix2Quaternion(mat4.Block(0, 0, 3, 2)), std::out_of_range);
+}
+
+
+TEST_F(TestRotationMatrix, Batch)
+{
+    /* Not a multiple of the block size, to test the remainder */
+    static constexpr int32_t NUM = 300;
+    std::vector<float> in[4];
+    for (auto& v : in) v.resize(NUM);
+    for (int32_t i = 0; i < NUM; i++) {
+        in[0][i] = Deg2Rad(static_cast<float>(i % 170 - 85));
+        in[1][i] = Deg2Rad(static_cast<float>((i * 7) % 170 - 85));
+        in[2][i] = Deg2Rad(static_cast<float>((i * 13) % 170 - 85));
+        in[3][i] = Deg2Rad(static_cast<float>((i * 3) % 170 + 5));
+    }
+    in[0][0] = in[1][0] = in[2][0] = 0.0f;    /* zero rotation vector and zero axis */
+    std::vector<float> mat3_rot(NUM * 9);
+    std::vector<float> out[4];
+    for (auto& v : out) v.resize(NUM);
+    Mat3 expected;
+    const auto expect_same_mat = [&](int32_t i) {
+        for (int32_t k = 0; k < 9; k++) {
+            EXPECT_NEAR(expected[k], mat3_rot[k * NUM + i], 1e-5f);
+        }
+    };
+
+    RotationMatrix::ConvertRotationVectors2RotationMatrices(in[0].data(), in[1].data(), in[2].data(), NUM, mat3_rot.data());
+    RotationMatrix::ConvertRotationMatrices2RotationVectors(mat3_rot.data(), NUM, out[0].data(), out[1].data(), out[2].data());
+    for (int32_t i = 0; i < NUM; i++) {
+        RotationMatrix::ConvertRotationVector2RotationMatrix(in[0][i], in[1][i], in[2][i], expected);
+        expect_same_mat(i);
+        const Vec3 vec3 = RotationMatrix::ConvertRotationMatrix2RotationVector(expected);
+        for (int32_t k = 0; k < 3; k++) EXPECT_NEAR(vec3[k], out[k][i], 1e-4f);
+    }
+
+    RotationMatrix::ConvertAxisAngles2RotationMatrices(in[0].data(), in[1].data(), in[2].data(), in[3].data(), NUM, mat3_rot.data());
+    RotationMatrix::ConvertRotationMatrices2AxisAngles(mat3_rot.data(), NUM, out[0].data(), out[1].data(), out[2].data(), out[3].data());
+    for (int32_t i = 0; i < NUM; i++) {
+        RotationMatrix::ConvertAxisAngle2RotationMatrix(in[0][i], in[1][i], in[2][i], in[3][i], expected);
+        expect_same_mat(i);
+        const Vec4 vec4 = RotationMatrix::ConvertRotationMatrix2AxisAngle(expected);
+        for (int32_t k = 0; k < 4; k++) EXPECT_NEAR(vec4[k], out[k][i], 1e-3f);
+    }
+
+    in[3][0] = 1.0f;
+    RotationMatrix::ConvertQuaternions2RotationMatrices(in[0].data(), in[1].data(), in[2].data(), in[3].data(), NUM, mat3_rot.data());
+    RotationMatrix::ConvertRotationMatrices2Quaternions(mat3_rot.data(), NUM, out[0].data(), out[1].data(), out[2].data(), out[3].data());
+    for (int32_t i = 0; i < NUM; i++) {
+        RotationMatrix::ConvertQuaternion2RotationMatrix(in[0][i], in[1][i], in[2][i], in[3][i], expected);
+        expect_same_mat(i);
+        const Vec4 vec4 = RotationMatrix::ConvertRotationMatrix2Quaternion(expected);
+        for (int32_t k = 0; k < 4; k++) EXPECT_NEAR(vec4[k], out[k][i], 1e-4f);
+    }
+
+    for (int32_t order_index = 0; order_index < 6; order_index++) {
+        const auto order = static_cast<RotationMatrix::EULER_ORDER>(order_index);
+        RotationMatrix::ConvertEulerMobiles2RotationMatrices(order, in[0].data(), in[1].data(), in[2].data(), NUM, mat3_rot.data());
+        RotationMatrix::ConvertRotationMatrices2EulerMobiles(order, mat3_rot.data(), NUM, out[0].data(), out[1].data(), out[2].data());
+        for (int32_t i = 0; i < NUM; i++) {
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(order, in[0][i], in[1][i], in[2][i], expected);
+            expect_same_mat(i);
+            for (int32_t k = 0; k < 3; k++) EXPECT_NEAR(in[k][i], out[k][i], 1e-3f);
+        }
+
+        RotationMatrix::ConvertEulerFixeds2RotationMatrices(order, in[0].data(), in[1].data(), in[2].data(), NUM, mat3_rot.data());
+        RotationMatrix::ConvertRotationMatrices2EulerFixeds(order, mat3_rot.data(), NUM, out[0].data(), out[1].data(), out[2].data());
+        for (int32_t i = 0; i < NUM; i++) {
+            RotationMatrix::ConvertEulerFixed2RotationMatrix(order, in[0][i], in[1][i], in[2][i], expected);
+            expect_same_mat(i);
+            for (int32_t k = 0; k < 3; k++) EXPECT_NEAR(in[k][i], out[k][i], 1e-3f);
+        }
+    }
+}
+
+TEST_F(TestRotationMatrix, DecomposeAllEuler)
+{
+    /* Include gimbal lock of every order */
+    static constexpr float ANGLES_DEG[][3] = {
+        { 0, 0, 0 }, { 10, 20, 30 }, { -170, 60, 120 }, { 90, 20, 30 }, { 10, 90, 30 }, { 10, 20, 90 }, { -90, 40, -50 }, { 40, -90, 50 }, { 40, 50, -90 },
+    };
+    std::vector<Mat3> mat3_list;
+    for (const auto& angle : ANGLES_DEG) {
+        for (int32_t order_index = 0; order_index < 6; order_index++) {
+            Mat3 mat3_rot;
+            RotationMatrix::ConvertEulerMobile2RotationMatrix(static_cast<RotationMatrix::EULER_ORDER>(order_index), Deg2Rad(angle[0]), Deg2Rad(angle[1]), Deg2Rad(angle[2]), mat3_rot);
+            mat3_list.push_back(mat3_rot);
+        }
+    }
+    /* Almost gimbal lock: asin of a value between ALMOST_ONE and 1 must not be clamped */
+    for (const Mat3& mat3_gimbal_lock : std::vector<Mat3>(mat3_list)) {
+        Mat3 mat3_rot = mat3_gimbal_lock;
+        bool is_gimbal_lock = false;
+        for (int32_t k = 0; k < 9; k++) {
+            if (std::abs(mat3_rot[k]) > 0.9999f) {
+                mat3_rot[k] = std::copysign(0.99999994f, mat3_rot[k]);
+                is_gimbal_lock = true;
+            }
+        }
+        if (is_gimbal_lock) mat3_list.push_back(mat3_rot);
+    }
+    const int32_t num = static_cast<int32_t>(mat3_list.size());
+
+    std::vector<float> mat3_planes(num * 9);
+    for (int32_t i = 0; i < num; i++) {
+        for (int32_t k = 0; k < 9; k++) mat3_planes[k * num + i] = mat3_list[i][k];
+    }
+    std::vector<float> mobile_planes(num * 18);
+    std::vector<float> fixed_planes(num * 18);
+    RotationMatrix::DecomposeAllEulers(mat3_planes.data(), num, mobile_planes.data(), fixed_planes.data());
+    std::vector<float> mobile_order_planes(num * 18);
+    for (int32_t order_index = 0; order_index < 6; order_index++) {
+        float* planes = mobile_order_planes.data() + order_index * 3 * num;
+        RotationMatrix::ConvertRotationMatrices2EulerMobiles(static_cast<RotationMatrix::EULER_ORDER>(order_index), mat3_planes.data(), num, planes, planes + num, planes + 2 * num);
+    }
+
+    for (int32_t i = 0; i < num; i++) {
+        Vec3 mobile[6], fixed[6];
+        RotationMatrix::DecomposeAllEuler(mat3_list[i], mobile, fixed);
+        for (int32_t order_index = 0; order_index < 6; order_index++) {
+            const auto order = static_cast<RotationMatrix::EULER_ORDER>(order_index);
+            const Vec3 expected_mobile = RotationMatrix::ConvertRotationMatrix2EulerMobile(order, mat3_list[i]);
+            const Vec3 expected_fixed = RotationMatrix::ConvertRotationMatrix2EulerFixed(order, mat3_list[i]);
+            for (int32_t k = 0; k < 3; k++) {
+                EXPECT_NEAR(mobile[order_index][k], expected_mobile[k], 1e-6f) << i << ", " << order_index;
+                EXPECT_NEAR(fixed[order_index][k], expected_fixed[k], 1e-6f) << i << ", " << order_index;
+                EXPECT_NEAR(mobile_planes[(order_index * 3 + k) * num + i], expected_mobile[k], 1e-5f) << i << ", " << order_index;
+                EXPECT_NEAR(fixed_planes[(order_index * 3 + k) * num + i], expected_fixed[k], 1e-5f) << i << ", " << order_index;
+                EXPECT_NEAR(mobile_order_planes[(order_index * 3 + k) * num + i], expected_mobile[k], 1e-5f) << i << ", " << order_index;
+            }
+        }
+    }
+
+    Matrix mat_rot = RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER::XYZ, 0.1f, 0.2f, 0.3f);
+    Vec3 mobile[6], fixed[6];
+    RotationMatrix::DecomposeAllEuler(mat_rot.View(), mobile, fixed);
+    EXPECT_NEAR(mobile[0][0], 0.1f, 1e-6f);
+    EXPECT_NEAR(mobile[0][1], 0.2f, 1e-6f);
+    EXPECT_NEAR(mobile[0][2], 0.3f, 1e-6f);
+    EXPECT_THROW(RotationMatrix::DecomposeAllEuler(Matrix(3, 4).View(), mobile, fixed), std::out_of_range);
+}
+
 }
@@ -0,0 +1,190 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+/* for general */
+#include <cstdint>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+/* GoogleTest */
+#include <gtest/gtest.h>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "quaternion.h"
+#include "rotation_mean.h"
+
+namespace {
+#if 0
+}    // indent guard
+#endif
+
+static inline float Deg2Rad(float deg) { return static_cast<float>(deg * M_PI / 180.0); }
+
+class TestRotationMean : public testing::Test
+{
+protected:
+    TestRotationMean() {
+        // You can do set-up work for each test here.
+    }
+
+    ~TestRotationMean() override {
+        // You can do clean-up work that doesn't throw exceptions here.
+    }
+
+    void SetUp() override {
+        // Code here will be called immediately after the constructor (right before each test).
+    }
+
+    void TearDown() override {
+        // Code here will be called immediately after each test (right before the destructor).
+    }
+};
+
+static void ExpectSameRotation(const Quaternion& q1, const Quaternion& q2, float tolerance)
+{
+    /* q and -q are the same rotation */
+    const float sign = (q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w) < 0 ? -1.0f : 1.0f;
+    EXPECT_NEAR(q1.x, sign * q2.x, tolerance);
+    EXPECT_NEAR(q1.y, sign * q2.y, tolerance);
+    EXPECT_NEAR(q1.z, sign * q2.z, tolerance);
+    EXPECT_NEAR(q1.w, sign * q2.w, tolerance);
+}
+
+/* Rotations symmetrically spread around center */
+static std::vector<Quaternion> CreateAround(const Quaternion& center, int32_t num)
+{
+    std::vector<Quaternion> q_list;
+    for (int32_t i = 0; i < num; i++) {
+        const float rad = Deg2Rad(static_cast<float>(10 + i % 20));
+        const float ax = std::sin(0.3f * i), ay = std::cos(0.7f * i), az = std::sin(1.1f * i + 0.5f);
+        q_list.push_back(center * Quaternion::FromAxisAngle(ax, ay, az, rad));
+        q_list.push_back(center * Quaternion::FromAxisAngle(ax, ay, az, -rad));
+    }
+    return q_list;
+}
+
+TEST_F(TestRotationMean, BasicTest)
+{
+    RotationMean mean;
+    EXPECT_EQ(mean.GetCount(), 0);
+    ExpectSameRotation(mean.GetMean(), Quaternion::Identity(), 1e-6f);
+
+    const Quaternion center = Quaternion::FromAxisAngle(1, 2, 3, Deg2Rad(70));
+    const std::vector<Quaternion> q_list = CreateAround(center, 50);
+    for (size_t i = 0; i < q_list.size(); i++) {
+        /* The sign of each quaternion doesn't matter */
+        const Quaternion& q = q_list[i];
+        mean.Add((i % 3 == 0) ? Quaternion(-q.x, -q.y, -q.z, -q.w) : q);
+    }
+    EXPECT_EQ(mean.GetCount(), 100);
+    EXPECT_DOUBLE_EQ(mean.GetWeightSum(), 100.0);
+    const Quaternion q_mean = mean.GetMean();
+    EXPECT_GE(q_mean.w, 0.0f);
+    ExpectSameRotation(q_mean, center, 1e-5f);
+
+    Mat3 mat3_mean, mat3_center;
+    mean.GetMean(mat3_mean);
+    center.ToRotationMatrix(mat3_center);
+    for (int32_t i = 0; i < 9; i++) EXPECT_NEAR(mat3_mean[i], mat3_center[i], 1e-5f);
+
+    mean.Reset();
+    EXPECT_EQ(mean.GetCount(), 0);
+    EXPECT_THROW(mean.Add(Quaternion(0, 0, 0, 0)), std::out_of_range);
+    EXPECT_THROW(mean.Add(Matrix(3, 4).View()), std::out_of_range);
+}
+
+TEST_F(TestRotationMean, Weight)
+{
+    const Quaternion q0 = Quaternion::FromAxisAngle(0, 0, 1, Deg2Rad(0));
+    const Quaternion q1 = Quaternion::FromAxisAngle(0, 0, 1, Deg2Rad(60));
+    RotationMean mean;
+    mean.Add(q0, 1.0f);
+    mean.Add(q1, 1.0f);
+    ExpectSameRotation(mean.GetMean(), Quaternion::FromAxisAngle(0, 0, 1, Deg2Rad(30)), 1e-5f);
+
+    mean.Reset();
+    mean.Add(q0, 0.0f);
+    mean.Add(q1, 2.0f);
+    ExpectSameRotation(mean.GetMean(), q1, 1e-5f);
+    EXPECT_DOUBLE_EQ(mean.GetWeightSum(), 2.0);
+}
+
+TEST_F(TestRotationMean, RotationMatrix)
+{
+    /* Matrices and quaternions are accumulated in the same way */
+    const std::vector<Quaternion> q_list = CreateAround(Quaternion::FromAxisAngle(-1, 0.5f, 2, Deg2Rad(150)), 30);
+    RotationMean mean_q, mean_mat, mean_view;
+    for (size_t i = 0; i < q_list.size(); i++) {
+        const float weight = 1.0f + static_cast<float>(i % 4);
+        Mat3 mat3_rot;
+        q_list[i].ToRotationMatrix(mat3_rot);
+        mean_q.Add(q_list[i], weight);
+        mean_mat.Add(mat3_rot, weight);
+        mean_view.Add(static_cast<Matrix>(mat3_rot).View(), weight);
+    }
+    ExpectSameRotation(mean_mat.GetMean(), mean_q.GetMean(), 1e-5f);
+    ExpectSameRotation(mean_view.GetMean(), mean_q.GetMean(), 1e-5f);
+}
+
+TEST_F(TestRotationMean, BatchAndMerge)
+{
+    const std::vector<Quaternion> q_list = CreateAround(Quaternion::FromAxisAngle(3, -1, 0.2f, Deg2Rad(-100)), 150);
+    const int32_t num = static_cast<int32_t>(q_list.size());
+    std::vector<float> quat(num * 4);
+    std::vector<float> mat3_rot(num * 9);
+    std::vector<float> weight(num);
+    RotationMean mean;
+    for (int32_t i = 0; i < num; i++) {
+        quat[0 * num + i] = q_list[i].x;
+        quat[1 * num + i] = q_list[i].y;
+        quat[2 * num + i] = q_list[i].z;
+        quat[3 * num + i] = q_list[i].w;
+        Mat3 mat;
+        q_list[i].ToRotationMatrix(mat);
+        for (int32_t k = 0; k < 9; k++) mat3_rot[k * num + i] = mat[k];
+        weight[i] = 0.5f + static_cast<float>(i % 3);
+        mean.Add(q_list[i], weight[i]);
+    }
+
+    RotationMean mean_quaternions, mean_matrices;
+    mean_quaternions.AddQuaternions(quat.data(), num, weight.data());
+    mean_matrices.AddRotationMatrices(mat3_rot.data(), num, weight.data());
+    EXPECT_EQ(mean_quaternions.GetCount(), num);
+    EXPECT_NEAR(mean_quaternions.GetWeightSum(), mean.GetWeightSum(), 1e-6);
+    ExpectSameRotation(mean_quaternions.GetMean(), mean.GetMean(), 1e-6f);
+    ExpectSameRotation(mean_matrices.GetMean(), mean.GetMean(), 1e-5f);
+
+    /* Accumulate in two parts (e.g. by two threads) and merge */
+    const int32_t half = num / 2;
+    RotationMean mean_first, mean_second;
+    for (int32_t i = 0; i < half; i++) mean_first.Add(q_list[i], weight[i]);
+    for (int32_t i = half; i < num; i++) mean_second.Add(q_list[i], weight[i]);
+    mean_first.Merge(mean_second);
+    EXPECT_EQ(mean_first.GetCount(), num);
+    ExpectSameRotation(mean_first.GetMean(), mean.GetMean(), 1e-6f);
+
+    /* No weight */
+    RotationMean mean_no_weight;
+    mean_no_weight.AddQuaternions(quat.data(), num);
+    EXPECT_DOUBLE_EQ(mean_no_weight.GetWeightSum(), static_cast<double>(num));
+}
+
+}
@@ -25,6 +25,7 @@ limitations under the License.
 #include <gtest/gtest.h>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 #include "transformation_matrix.h"
 
 namespace {
@@ -168,5 +169,74 @@ TEST_F(TestTransformationMatrix, LookAt)
     // todo
 }
 
+TEST_F(TestTransformationMatrix, Inverse)
+{
+    Matrix mat_rot = TransformationMatrix::RotateAxisAngle(0.1f, 0.2f, 0.5f, Deg2Rad(30.0f));
+    Matrix mat_rigid = TransformationMatrix::Translate(1.0f, -2.0f, 3.0f) * mat_rot;
+    Matrix mat_affine = mat_rigid * TransformationMatrix::Scale(2.0f, 3.0f, 0.5f);
+
+    Matrix mat_rigid_inv = mat_rigid.Inverse();
+    Matrix mat_rigid_inv_hint = mat_rigid.Inverse(MATRIX_STRUCTURE::RIGID);
+    Matrix mat_rigid_inv_affine = mat_rigid.Inverse(MATRIX_STRUCTURE::AFFINE);
+    Matrix mat_affine_inv = mat_affine.Inverse();
+    Matrix mat_affine_inv_hint = mat_affine.Inverse(MATRIX_STRUCTURE::AFFINE);
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_NEAR(mat_rigid_inv[i], mat_rigid_inv_hint[i], 1e-5f);
+        EXPECT_NEAR(mat_rigid_inv[i], mat_rigid_inv_affine[i], 1e-5f);
+        EXPECT_NEAR(mat_affine_inv[i], mat_affine_inv_hint[i], 1e-5f);
+    }
+
+    /* Upper-left block larger than 3x3 */
+    Matrix mat6_affine(6, 6);
+    for (int32_t row = 0; row < 6; row++) {
+        for (int32_t col = 0; col < 6; col++) {
+            mat6_affine(row, col) = (row == 5) ? (col == 5 ? 1.0f : 0.0f) : ((row == col) ? 4.0f : 0.0f) + 0.1f * (row * 6 + col % 4);
+        }
+    }
+    Matrix mat6_affine_inv = mat6_affine.Inverse();
+    Matrix mat6_affine_inv_hint = mat6_affine.Inverse(MATRIX_STRUCTURE::AFFINE);
+    for (int32_t i = 0; i < 36; i++) {
+        EXPECT_NEAR(mat6_affine_inv[i], mat6_affine_inv_hint[i], 1e-5f);
+    }
+
+    Matrix mat3_rot = TransformationMatrix::Shrink4to3(mat_rot);
+    Matrix mat3_rot_inv = mat3_rot.Inverse();
+    Matrix mat3_rot_inv_hint = mat3_rot.Inverse(MATRIX_STRUCTURE::ROTATION);
+    for (int32_t i = 0; i < 9; i++) {
+        EXPECT_NEAR(mat3_rot_inv[i], mat3_rot_inv_hint[i], 1e-5f);
+    }
+
+    Mat4 mat_rigid_fixed(mat_rigid);
+    Mat4 mat_rigid_fixed_inv = mat_rigid_fixed.Inverse(MATRIX_STRUCTURE::RIGID);
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_FLOAT_EQ(mat_rigid_inv_hint[i], mat_rigid_fixed_inv[i]);
+    }
+}
+
+TEST_F(TestTransformationMatrix, FixedSize)
+{
+    Vec4 vec_object({ 0, 20, 10, 1 });
+    Mat4 mat_tx, mat_rot, mat_lookat;
+    TransformationMatrix::Translate(1.0f, -2.0f, 3.0f, mat_tx);
+    TransformationMatrix::RotateZ(Deg2Rad(30.0f), mat_rot);
+    Vec4 vec_transformed = mat_tx * mat_rot * vec_object;
+    Matrix mat_transformed = TransformationMatrix::Translate(1.0f, -2.0f, 3.0f) * TransformationMatrix::RotateZ(Deg2Rad(30.0f)) * static_cast<Matrix>(vec_object);
+    for (int32_t i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(mat_transformed[i], vec_transformed[i]);
+    }
+
+    TransformationMatrix::LookAt({ 0.1f, 0.2f, 0.3f }, { 0.4f, 0.5f, 0.6f }, { 0.0f, 1.0f, 0.0f }, mat_lookat);
+    Matrix mat_lookat_dynamic = TransformationMatrix::LookAt({ 0.1f, 0.2f, 0.3f }, { 0.4f, 0.5f, 0.6f }, { 0.0f, 1.0f, 0.0f });
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_FLOAT_EQ(mat_lookat_dynamic[i], mat_lookat[i]);
+    }
+
+    Mat3 mat3 = TransformationMatrix::Shrink4to3(mat_rot);
+    Mat4 mat4 = TransformationMatrix::Expand3to4(mat3);
+    for (int32_t i = 0; i < 16; i++) {
+        EXPECT_FLOAT_EQ(mat_rot[i], mat4[i]);
+    }
+}
+
 }
 
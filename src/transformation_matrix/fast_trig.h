@@ -0,0 +1,124 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef FAST_TRIG_H
+#define FAST_TRIG_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+/*
+ * Approximate trigonometric functions with minimax polynomials of lower degree than libm (and the SIMD kernels).
+ * The absolute error is below 2e-6 (rad for the inverse functions) instead of a few ulp. sin/cos is accurate for |angle| < 8192.
+ * They have no branch and no libm call except sqrt, so that a loop calling them is vectorized by the compiler
+ * (with -fno-math-errno for Asin / Acos).
+ * The coefficients are fitted by the Remez algorithm on the reduced ranges:
+ *   sin: [0, pi/4] (degree 5, error 9.4e-7), cos: [0, pi/4] (degree 6, error 3.2e-8)
+ *   asin: [0, 0.5] (degree 7, error 5.9e-7. 2x for |value| > 0.5), atan: [0, 1] (degree 13, error 3.4e-7)
+ */
+namespace FastTrig
+{
+    static constexpr float PI = 3.14159265358979f;
+    static constexpr float PI_2 = 1.57079632679490f;
+
+    /* sin and cos at once. The angle is reduced to r in [-pi/4, pi/4] and the quadrant j (angle = j * pi/2 + r) */
+    inline void SinCos(float angle, float& s, float& c)
+    {
+        /* Round to nearest by the magic number 1.5 * 2^23 (valid for |angle * 2/pi| < 2^22) */
+        static constexpr float ROUND_MAGIC = 12582912.0f;
+        const float j = (angle * (2.0f / PI) + ROUND_MAGIC) - ROUND_MAGIC;
+        const int32_t quadrant = static_cast<int32_t>(j);
+        /* Cody-Waite reduction: pi/2 is split into 3 parts, so that j * part is exact */
+        const float r = ((angle - j * 1.5703125f) - j * 4.837512969970703125e-4f) - j * 7.54978995489188216e-8f;
+        const float z = r * r;
+        const float s_r = r + r * z * (-0.166628338f + z * 0.00815299234f);
+        const float c_r = 1.0f + z * (-0.499998948f + z * (0.0416562946f + z * -0.00135978231f));
+        /* quadrant 1, 3: swap sin and cos. quadrant 2, 3: negate sin. quadrant 1, 2: negate cos */
+        const float is_swap = static_cast<float>(quadrant & 1);
+        const float sign_s = 1.0f - static_cast<float>(quadrant & 2);
+        const float sign_c = 1.0f - static_cast<float>((quadrant + 1) & 2);
+        s = sign_s * (s_r + is_swap * (c_r - s_r));
+        c = sign_c * (c_r + is_swap * (s_r - c_r));
+    }
+
+    inline float Sin(float angle)
+    {
+        float s, c;
+        SinCos(angle, s, c);
+        return s;
+    }
+
+    inline float Cos(float angle)
+    {
+        float s, c;
+        SinCos(angle, s, c);
+        return c;
+    }
+
+    /* asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)) for |x| > 0.5. value must be in [-1, 1] */
+    inline float Asin(float value)
+    {
+        const float a = std::abs(value);
+        /* Blend by arithmetic instead of selects, which the compiler turns into branches around sqrt.
+         * z is the smaller one of a^2 and (1 - a) / 2 (exact), and t blended by adding is_big has an error of 1 ulp of a */
+        const float is_big = static_cast<float>(a > 0.5f);
+        const float z = std::min(a * a, 0.5f * (1.0f - a));
+        const float t = a + is_big * (std::sqrt(z) - a);
+        const float p = t + t * z * (0.166855622f + z * (0.0712770166f + z * 0.0657702974f));
+        const float angle = p + is_big * (PI_2 - 3.0f * p);
+        return std::copysign(angle, value);
+    }
+
+    inline float Acos(float value)
+    {
+        return PI_2 - Asin(value);
+    }
+
+    /* atan of t in [0, 1] */
+    inline float AtanUnit(float t)
+    {
+        const float z = t * t;
+        return t + t * z * (-0.333253950f + z * (0.198618566f + z * (-0.133988030f + z * (0.0821678233f + z * (-0.0355199357f + z * 0.00737402358f)))));
+    }
+
+    inline float Atan(float value)
+    {
+        const float a = std::abs(value);
+        /* atan(a) = pi/2 - atan(1 / a) for a > 1. 1 / 0 is inf, and min gives 0 */
+        const float is_big = static_cast<float>(a > 1.0f);
+        const float p = AtanUnit(std::min(a, 1.0f / a));
+        const float angle = p + is_big * (PI_2 - 2.0f * p);
+        return std::copysign(angle, value);
+    }
+
+    /* The same quadrants as std::atan2, including the signed zeros. atan2(0, 0) is 0 (or pi for x = -0) */
+    inline float Atan2(float y, float x)
+    {
+        const float ax = std::abs(x);
+        const float ay = std::abs(y);
+        const float mn = (ax < ay) ? ax : ay;
+        const float mx = (ax < ay) ? ay : ax;
+        const float t = mn / (mx + static_cast<float>(mx == 0.0f));
+        const float p = AtanUnit(t);
+        const float is_steep = static_cast<float>(ay > ax);
+        const float is_negative_x = static_cast<float>(std::copysign(1.0f, x) < 0.0f);
+        const float angle_first = p + is_steep * (PI_2 - 2.0f * p);
+        const float angle = angle_first + is_negative_x * (PI - 2.0f * angle_first);
+        return std::copysign(angle, y);
+    }
+}
+
+#endif
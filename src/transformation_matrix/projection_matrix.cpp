@@ -20,6 +20,8 @@ limitations under the License.
 #include <vector>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
+#include "matrix_col_major.h"
 #include "projection_matrix.h"
 
 /*** Macro ***/
@@ -27,56 +29,109 @@ limitations under the License.
 /*** Global variable ***/
 
 /*** Function ***/
-Matrix ProjectionMatrix::Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far)
+/* The builders write elements by (row, col), so the same code produces both row-major Mat4 and column-major Mat4ColMajor */
+template<typename MAT4>
+static void OrthogonalImpl(float left, float right, float bottom, float top, float z_near, float z_far, MAT4& mat)
 {
-    Matrix mat = Matrix::Identity(4);
+    mat = MAT4::Identity();
     const float dx = right - left;
     const float dy = top - bottom;
     const float dz = z_far - z_near;
     if (dx != 0.0f && dy != 0.0f && dz != 0.0f) {
-        mat[0] = 2.0f / dx;
-        mat[5] = 2.0f / dy;
-        mat[10] = -2.0f / dz;
-        mat[3] = -(right + left) / dx;
-        mat[7] = -(top + bottom) / dy;
-        mat[11] = -(z_far + z_near) / dz;
+        mat(0, 0) = 2.0f / dx;
+        mat(1, 1) = 2.0f / dy;
+        mat(2, 2) = -2.0f / dz;
+        mat(0, 3) = -(right + left) / dx;
+        mat(1, 3) = -(top + bottom) / dy;
+        mat(2, 3) = -(z_far + z_near) / dz;
     }
-    return mat;
 }
 
-Matrix ProjectionMatrix::Frustum(float left, float right, float bottom, float top, float z_near, float z_far)
+template<typename MAT4>
+static void FrustumImpl(float left, float right, float bottom, float top, float z_near, float z_far, MAT4& mat)
 {
-    Matrix mat = Matrix::Identity(4);
+    mat = MAT4::Identity();
     const float dx = right - left;
     const float dy = top - bottom;
     const float dz = z_far - z_near;
     if (dx != 0.0f && dy != 0.0f && dz != 0.0f)
     {
-        mat[0] = 2.0f * z_near / dx;
-        mat[5] = 2.0f * z_near / dy;
-        mat[2] = (right + left) / dx;
-        mat[6] = (top + bottom) / dy;
-        mat[10] = -(z_far + z_near) / dz;
-        mat[11] = -2.0f * z_far * z_near / dz;
-        mat[14] = -1.0f;
-        mat[15] = 0.0f;
+        mat(0, 0) = 2.0f * z_near / dx;
+        mat(1, 1) = 2.0f * z_near / dy;
+        mat(0, 2) = (right + left) / dx;
+        mat(1, 2) = (top + bottom) / dy;
+        mat(2, 2) = -(z_far + z_near) / dz;
+        mat(2, 3) = -2.0f * z_far * z_near / dz;
+        mat(3, 2) = -1.0f;
+        mat(3, 3) = 0.0f;
     }
-    return mat;
 }
-Matrix ProjectionMatrix::Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far)
+
+template<typename MAT4>
+static void PerspectiveImpl(float cx, float cy, float fovy, float aspect, float z_near, float z_far, MAT4& mat)
 {
-    Matrix mat = Matrix::Identity(4);
+    mat = MAT4::Identity();
     const float dz = z_far - z_near;
     if (dz != 0.0f) {
-        mat[5] = 1.0f / std::tan(fovy * 0.5f);
-        mat[0] = mat[5] / aspect;
-        mat[2] = cx;
-        mat[6] = cy;
-        mat[10] = -(z_far + z_near) / dz;
-        mat[11] = -2.0f * z_far * z_near / dz;
-        mat[14] = -1.0f;
-        mat[15] = 0.0f;
+        mat(1, 1) = 1.0f / std::tan(fovy * 0.5f);
+        mat(0, 0) = mat(1, 1) / aspect;
+        mat(0, 2) = cx;
+        mat(1, 2) = cy;
+        mat(2, 2) = -(z_far + z_near) / dz;
+        mat(2, 3) = -2.0f * z_far * z_near / dz;
+        mat(3, 2) = -1.0f;
+        mat(3, 3) = 0.0f;
     }
-    return mat;
 }
 
+void ProjectionMatrix::Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far, Mat4& mat)
+{
+    OrthogonalImpl(left, right, bottom, top, z_near, z_far, mat);
+}
+
+void ProjectionMatrix::Frustum(float left, float right, float bottom, float top, float z_near, float z_far, Mat4& mat)
+{
+    FrustumImpl(left, right, bottom, top, z_near, z_far, mat);
+}
+
+void ProjectionMatrix::Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far, Mat4& mat)
+{
+    PerspectiveImpl(cx, cy, fovy, aspect, z_near, z_far, mat);
+}
+
+void ProjectionMatrix::Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far, Mat4ColMajor& mat)
+{
+    OrthogonalImpl(left, right, bottom, top, z_near, z_far, mat);
+}
+
+void ProjectionMatrix::Frustum(float left, float right, float bottom, float top, float z_near, float z_far, Mat4ColMajor& mat)
+{
+    FrustumImpl(left, right, bottom, top, z_near, z_far, mat);
+}
+
+void ProjectionMatrix::Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far, Mat4ColMajor& mat)
+{
+    PerspectiveImpl(cx, cy, fovy, aspect, z_near, z_far, mat);
+}
+
+/* Functions for dynamic-size Matrix. These are just wrappers of the fixed-size version */
+Matrix ProjectionMatrix::Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far)
+{
+    Mat4 mat;
+    Orthogonal(left, right, bottom, top, z_near, z_far, mat);
+    return static_cast<Matrix>(mat);
+}
+
+Matrix ProjectionMatrix::Frustum(float left, float right, float bottom, float top, float z_near, float z_far)
+{
+    Mat4 mat;
+    Frustum(left, right, bottom, top, z_near, z_far, mat);
+    return static_cast<Matrix>(mat);
+}
+
+Matrix ProjectionMatrix::Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far)
+{
+    Mat4 mat;
+    Perspective(cx, cy, fovy, aspect, z_near, z_far, mat);
+    return static_cast<Matrix>(mat);
+}
@@ -21,12 +21,24 @@ limitations under the License.
 #include <vector>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
+#include "matrix_col_major.h"
 
 namespace ProjectionMatrix {
     /* All functions return 4x4 projection matrix*/
     Matrix Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far);
     Matrix Frustum(float left, float right, float bottom, float top, float z_near, float z_far);
     Matrix Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far);
+
+    /* Overloads using fixed-size matrix (no heap allocation). The result is written into mat4 */
+    void Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far, Mat4& mat4);
+    void Frustum(float left, float right, float bottom, float top, float z_near, float z_far, Mat4& mat4);
+    void Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far, Mat4& mat4);
+
+    /* Overloads producing column-major matrix, which can be uploaded to OpenGL without transpose */
+    void Orthogonal(float left, float right, float bottom, float top, float z_near, float z_far, Mat4ColMajor& mat4);
+    void Frustum(float left, float right, float bottom, float top, float z_near, float z_far, Mat4ColMajor& mat4);
+    void Perspective(float cx, float cy, float fovy, float aspect, float z_near, float z_far, Mat4ColMajor& mat4);
 }
 
 #endif
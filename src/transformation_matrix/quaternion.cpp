@@ -0,0 +1,123 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+#include "quaternion.h"
+
+/*** Function ***/
+Quaternion Quaternion::FromAxisAngle(float x, float y, float z, float rad)
+{
+    /* Normalize (same as ConvertAxisAngle2RotationMatrix) */
+    const float d = std::sqrt(x * x + y * y + z * z);
+    if (d <= 0.0f) return Quaternion::Identity();
+    const float s = std::sin(rad / 2) / d;
+    return Quaternion(x * s, y * s, z * s, std::cos(rad / 2));
+}
+
+Quaternion Quaternion::FromRotationVector(float x_rad, float y_rad, float z_rad)
+{
+    const float rad = std::sqrt(x_rad * x_rad + y_rad * y_rad + z_rad * z_rad);
+    return FromAxisAngle(x_rad, y_rad, z_rad, rad);
+}
+
+Quaternion Quaternion::FromRotationMatrix(const Mat3& mat3_rot)
+{
+    return Quaternion(RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot));
+}
+
+Quaternion Quaternion::FromRotationMatrix(const ConstMatrixView& mat3_rot)
+{
+    return Quaternion(RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot));
+}
+
+/* Rotation around each axis (0 = x, 1 = y, 2 = z) */
+static Quaternion RotateAxis(int32_t axis, float rad)
+{
+    Quaternion q(0.0f, 0.0f, 0.0f, std::cos(rad / 2));
+    const float s = std::sin(rad / 2);
+    if (axis == 0) q.x = s;
+    else if (axis == 1) q.y = s;
+    else q.z = s;
+    return q;
+}
+
+/* Axes of mobile euler angles from left to right in the product (e.g. XYZ = RotX * RotY * RotZ) */
+static const int32_t* GetMobileAxes(RotationMatrix::EULER_ORDER order)
+{
+    static constexpr int32_t AXES[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+    return AXES[static_cast<int32_t>(order)];
+}
+
+Quaternion Quaternion::FromEulerMobile(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+{
+    const float angle[3] = { x, y, z };
+    const int32_t* axes = GetMobileAxes(order);
+    return RotateAxis(axes[0], angle[axes[0]]) * RotateAxis(axes[1], angle[axes[1]]) * RotateAxis(axes[2], angle[axes[2]]);
+}
+
+/* Fixed angles are applied in the order, so the product is in the reversed order */
+Quaternion Quaternion::FromEulerFixed(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+{
+    const float angle[3] = { x, y, z };
+    const int32_t* axes = GetMobileAxes(order);
+    return RotateAxis(axes[2], angle[axes[2]]) * RotateAxis(axes[1], angle[axes[1]]) * RotateAxis(axes[0], angle[axes[0]]);
+}
+
+void Quaternion::ToRotationMatrix(Mat3& mat3_rot) const
+{
+    RotationMatrix::ConvertQuaternion2RotationMatrix(x, y, z, w, mat3_rot);
+}
+
+/* The angle is in [0, pi], and the result of no rotation is all 0, same as ConvertRotationMatrix2AxisAngle */
+Vec4 Quaternion::ToAxisAngle() const
+{
+    /* q and -q are the same rotation. Use the one with w >= 0 so that the angle is in [0, pi] */
+    const float sign = (w < 0.0f) ? -1.0f : 1.0f;
+    const float d = std::sqrt(x * x + y * y + z * z);
+    Vec4 vec4;
+    if (d > 0) {
+        vec4[0] = sign * x / d;
+        vec4[1] = sign * y / d;
+        vec4[2] = sign * z / d;
+        vec4[3] = 2 * std::atan2(d, sign * w);
+    }
+    return vec4;
+}
+
+Vec3 Quaternion::ToRotationVector() const
+{
+    const Vec4 vec4 = ToAxisAngle();
+    return Vec3({ vec4[0] * vec4[3], vec4[1] * vec4[3], vec4[2] * vec4[3] });
+}
+
+Vec3 Quaternion::ToEulerMobile(RotationMatrix::EULER_ORDER order) const
+{
+    Mat3 mat3_rot;
+    ToRotationMatrix(mat3_rot);
+    return RotationMatrix::ConvertRotationMatrix2EulerMobile(order, mat3_rot);
+}
+
+Vec3 Quaternion::ToEulerFixed(RotationMatrix::EULER_ORDER order) const
+{
+    Mat3 mat3_rot;
+    ToRotationMatrix(mat3_rot);
+    return RotationMatrix::ConvertRotationMatrix2EulerFixed(order, mat3_rot);
+}
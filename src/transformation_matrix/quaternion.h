@@ -0,0 +1,143 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "rotation_matrix.h"
+
+/*
+ * Quaternion (x, y, z, w) = (axis * sin(rad / 2), cos(rad / 2)), in the same order as ConvertRotationMatrix2Quaternion.
+ * q1 * q2 is the Hamilton product, which is the rotation q2 followed by q1 (the same as mat1 * mat2 of rotation matrices).
+ * Composition and vector rotation don't build any matrix, so chaining many rotations is cheap.
+ * Note: rotation functions expect a unit quaternion. Call Normalize() occasionally when many rotations are chained.
+ */
+class Quaternion
+{
+public:
+    Quaternion()
+        : x(0.0f), y(0.0f), z(0.0f), w(1.0f)
+    {
+        // do nothing
+    }
+
+    Quaternion(float x, float y, float z, float w)
+        : x(x), y(y), z(z), w(w)
+    {
+        // do nothing
+    }
+
+    explicit Quaternion(const Vec4& vec4)
+        : x(vec4[0]), y(vec4[1]), z(vec4[2]), w(vec4[3])
+    {
+        // do nothing
+    }
+
+    static Quaternion Identity()
+    {
+        return Quaternion();
+    }
+
+    Vec4 ToVec4() const
+    {
+        return Vec4({ x, y, z, w });
+    }
+
+    Quaternion operator*(const Quaternion& q) const
+    {
+        return Quaternion(
+            w * q.x + x * q.w + y * q.z - z * q.y,
+            w * q.y - x * q.z + y * q.w + z * q.x,
+            w * q.z + x * q.y - y * q.x + z * q.w,
+            w * q.w - x * q.x - y * q.y - z * q.z);
+    }
+
+    Quaternion& operator*=(const Quaternion& q)
+    {
+        *this = *this * q;
+        return *this;
+    }
+
+    float Norm() const
+    {
+        return std::sqrt(x * x + y * y + z * z + w * w);
+    }
+
+    Quaternion Conjugate() const
+    {
+        return Quaternion(-x, -y, -z, w);
+    }
+
+    /* Same as Conjugate() for a unit quaternion */
+    Quaternion Inverse() const
+    {
+        const float d = x * x + y * y + z * z + w * w;
+        if (d <= 0.0f) throw std::out_of_range("Invalid value");
+        return Quaternion(-x / d, -y / d, -z / d, w / d);
+    }
+
+    Quaternion Normalize() const
+    {
+        const float d = Norm();
+        if (d <= 0.0f) throw std::out_of_range("Invalid value");
+        return Quaternion(x / d, y / d, z / d, w / d);
+    }
+
+    /* v' = q * v * q^-1, using t = 2 * cross(q.xyz, v), v' = v + w * t + cross(q.xyz, t) (15 multiplications and 15 additions) */
+    void Rotate(float& vx, float& vy, float& vz) const
+    {
+        const float tx = 2 * (y * vz - z * vy);
+        const float ty = 2 * (z * vx - x * vz);
+        const float tz = 2 * (x * vy - y * vx);
+        vx += w * tx + (y * tz - z * ty);
+        vy += w * ty + (z * tx - x * tz);
+        vz += w * tz + (x * ty - y * tx);
+    }
+
+    Vec3 Rotate(const Vec3& vec3) const
+    {
+        Vec3 ret = vec3;
+        Rotate(ret[0], ret[1], ret[2]);
+        return ret;
+    }
+
+    /* Conversions from / to other representations. Angles are in radian */
+    static Quaternion FromAxisAngle(float x, float y, float z, float rad);
+    static Quaternion FromRotationVector(float x_rad, float y_rad, float z_rad);
+    static Quaternion FromRotationMatrix(const Mat3& mat3_rot);
+    static Quaternion FromRotationMatrix(const ConstMatrixView& mat3_rot);
+    static Quaternion FromEulerMobile(RotationMatrix::EULER_ORDER order, float x, float y, float z);
+    static Quaternion FromEulerFixed(RotationMatrix::EULER_ORDER order, float x, float y, float z);
+    void ToRotationMatrix(Mat3& mat3_rot) const;
+    Vec4 ToAxisAngle() const;
+    Vec3 ToRotationVector() const;
+    Vec3 ToEulerMobile(RotationMatrix::EULER_ORDER order) const;
+    Vec3 ToEulerFixed(RotationMatrix::EULER_ORDER order) const;
+
+public:
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+#endif
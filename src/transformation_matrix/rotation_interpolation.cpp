@@ -0,0 +1,307 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+#include "matrix_fixed.h"
+#include "quaternion.h"
+#include "rotation_kernel.h"
+#include "rotation_interpolation.h"
+
+/*** Macro ***/
+/* sin(omega) smaller than this is not used for division, and the linear weights are used instead */
+static constexpr float SMALL_SIN = 1e-6f;
+
+/*** Function ***/
+static float Dot(const Quaternion& q0, const Quaternion& q1)
+{
+    return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+}
+
+static Quaternion Negate(const Quaternion& q)
+{
+    return Quaternion(-q.x, -q.y, -q.z, -q.w);
+}
+
+/* Angle between unit quaternions as 4D vectors. 2 * atan2(|q1 - q0|, |q1 + q0|) is accurate even for a small angle, unlike acos(dot) */
+static float GetOmega(const Quaternion& q0, const Quaternion& q1)
+{
+    const Quaternion diff(q1.x - q0.x, q1.y - q0.y, q1.z - q0.z, q1.w - q0.w);
+    const Quaternion sum(q1.x + q0.x, q1.y + q0.y, q1.z + q0.z, q1.w + q0.w);
+    return 2 * std::atan2(diff.Norm(), sum.Norm());
+}
+
+/* The error of nlerp in rotation angle is 2 * omega^3 / 62 for a small omega, and is within omega^3 / 27 for omega <= pi / 2 (shortest path) */
+static float GetNlerpErrorBound(float omega)
+{
+    return omega * omega * omega / 27.0f;
+}
+
+static Quaternion Lerp(const Quaternion& q0, const Quaternion& q1, float w0, float w1)
+{
+    return Quaternion(w0 * q0.x + w1 * q1.x, w0 * q0.y + w1 * q1.y, w0 * q0.z + w1 * q1.z, w0 * q0.w + w1 * q1.w);
+}
+
+/* sin((1 - t) * omega) = cos(t * omega) * sin(omega) - cos(omega) * sin(t * omega), so that sin/cos of t * omega is the only one needed for each t */
+static Quaternion SlerpImpl(const Quaternion& q0, const Quaternion& q1_original, float t, bool is_shortest_path)
+{
+    const Quaternion q1 = (is_shortest_path && Dot(q0, q1_original) < 0) ? Negate(q1_original) : q1_original;
+    const float omega = GetOmega(q0, q1);
+    const float sin_omega = std::sin(omega);
+    if (sin_omega < SMALL_SIN) return Lerp(q0, q1, 1 - t, t);
+    const float w1 = std::sin(t * omega) / sin_omega;
+    const float w0 = std::cos(t * omega) - std::cos(omega) * w1;
+    return Lerp(q0, q1, w0, w1);
+}
+
+Quaternion RotationInterpolation::Slerp(const Quaternion& q0, const Quaternion& q1, float t)
+{
+    return SlerpImpl(q0, q1, t, true);
+}
+
+Quaternion RotationInterpolation::Nlerp(const Quaternion& q0, const Quaternion& q1, float t)
+{
+    const Quaternion q1_shortest = (Dot(q0, q1) < 0) ? Negate(q1) : q1;
+    return Lerp(q0, q1_shortest, 1 - t, t).Normalize();
+}
+
+Quaternion RotationInterpolation::Nlerp(const Quaternion& q0, const Quaternion& q1, float t, float max_error_rad)
+{
+    if (NlerpErrorBound(q0, q1) <= max_error_rad) return Nlerp(q0, q1, t);
+    return Slerp(q0, q1, t);
+}
+
+float RotationInterpolation::NlerpErrorBound(const Quaternion& q0, const Quaternion& q1)
+{
+    const Quaternion q1_shortest = (Dot(q0, q1) < 0) ? Negate(q1) : q1;
+    return GetNlerpErrorBound(GetOmega(q0, q1_shortest));
+}
+
+Quaternion RotationInterpolation::Squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, float t)
+{
+    /* No shortest path here. The signs are chosen by SquadControlPoint */
+    return SlerpImpl(SlerpImpl(q1, q2, t, false), SlerpImpl(s1, s2, t, false), 2 * t * (1 - t), false);
+}
+
+/* log of a unit quaternion (the vector part is axis * half angle) */
+static Vec3 Log(const Quaternion& q)
+{
+    const float d = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    if (d <= 0.0f) return Vec3();
+    const float k = std::atan2(d, q.w) / d;
+    return Vec3({ q.x * k, q.y * k, q.z * k });
+}
+
+static Quaternion Exp(const Vec3& vec3)
+{
+    const float d = std::sqrt(vec3[0] * vec3[0] + vec3[1] * vec3[1] + vec3[2] * vec3[2]);
+    if (d <= 0.0f) return Quaternion::Identity();
+    const float k = std::sin(d) / d;
+    return Quaternion(vec3[0] * k, vec3[1] * k, vec3[2] * k, std::cos(d));
+}
+
+/* s = q * exp(-(log(q^-1 * q_next) + log(q^-1 * q_prev)) / 4). The neighbours are taken on the same side as q */
+Quaternion RotationInterpolation::SquadControlPoint(const Quaternion& q_prev, const Quaternion& q, const Quaternion& q_next)
+{
+    const Quaternion q_inverse = q.Conjugate();
+    const Quaternion prev = (Dot(q, q_prev) < 0) ? Negate(q_prev) : q_prev;
+    const Quaternion next = (Dot(q, q_next) < 0) ? Negate(q_next) : q_next;
+    const Vec3 log_next = Log(q_inverse * next);
+    const Vec3 log_prev = Log(q_inverse * prev);
+    Vec3 vec3;
+    for (int32_t i = 0; i < 3; i++) vec3[i] = -(log_next[i] + log_prev[i]) / 4;
+    return q * Exp(vec3);
+}
+
+
+/*** Batch functions ***/
+/* Pairs are processed in blocks. The angle between each pair is calculated once, and used for all the parameters.
+ * Then each parameter needs one sin/cos by the SIMD kernel (RotationKernel) and branchless arithmetic which the compiler can vectorize */
+static constexpr int32_t BATCH_BLOCK_SIZE = 256;
+
+struct SlerpBlock {
+    int32_t count;
+    const float* q0[4];
+    float q1[4][BATCH_BLOCK_SIZE];  /* negated for the shortest path */
+    float omega[BATCH_BLOCK_SIZE];
+    float cos_omega[BATCH_BLOCK_SIZE];
+    float inv_sin_omega[BATCH_BLOCK_SIZE];
+    float is_linear[BATCH_BLOCK_SIZE];  /* 1 to use the linear weights, because the angle is small or nlerp is selected */
+    float is_nlerp[BATCH_BLOCK_SIZE];   /* 1 to normalize the result */
+    bool has_slerp;
+};
+
+/* max_error_rad < 0 means slerp only */
+static void PrepareSlerpBlock(const RotationKernel::Kernel& kernel, const float* const (&q0)[4], const float* const (&q1)[4], int32_t count,
+    bool is_shortest_path, float max_error_rad, SlerpBlock& block)
+{
+    float diff[BATCH_BLOCK_SIZE] = {};
+    float sum[BATCH_BLOCK_SIZE] = {};
+    float sin_omega[BATCH_BLOCK_SIZE];
+    block.count = count;
+    for (int32_t c = 0; c < 4; c++) block.q0[c] = q0[c];
+    for (int32_t i = 0; i < count; i++) {
+        const float dot = q0[0][i] * q1[0][i] + q0[1][i] * q1[1][i] + q0[2][i] * q1[2][i] + q0[3][i] * q1[3][i];
+        const float sign = (is_shortest_path && dot < 0) ? -1.0f : 1.0f;
+        float diff2 = 0.0f;
+        float sum2 = 0.0f;
+        for (int32_t c = 0; c < 4; c++) {
+            const float v = sign * q1[c][i];
+            block.q1[c][i] = v;
+            diff2 += (v - q0[c][i]) * (v - q0[c][i]);
+            sum2 += (v + q0[c][i]) * (v + q0[c][i]);
+        }
+        diff[i] = std::sqrt(diff2);
+        sum[i] = std::sqrt(sum2);
+    }
+    kernel.atan2(diff, sum, count, block.omega);
+    for (int32_t i = 0; i < count; i++) block.omega[i] *= 2;
+    kernel.sincos(block.omega, count, sin_omega, block.cos_omega);
+
+    int32_t slerp_num = 0;
+    for (int32_t i = 0; i < count; i++) {
+        const float omega = block.omega[i];
+        const float is_nlerp = (GetNlerpErrorBound(omega) <= max_error_rad) ? 1.0f : 0.0f;
+        block.is_nlerp[i] = is_nlerp;
+        block.is_linear[i] = (sin_omega[i] < SMALL_SIN) ? 1.0f : is_nlerp;
+        block.inv_sin_omega[i] = 1.0f / std::max(sin_omega[i], SMALL_SIN);
+        slerp_num += (block.is_linear[i] > 0) ? 0 : 1;
+    }
+    block.has_slerp = slerp_num > 0;
+}
+
+/* t has a parameter for each pair */
+static void EvaluateSlerpBlock(const RotationKernel::Kernel& kernel, const SlerpBlock& block, const float* t, float* const (&out)[4])
+{
+    const int32_t count = block.count;
+    float w0[BATCH_BLOCK_SIZE];
+    float w1[BATCH_BLOCK_SIZE];
+    if (block.has_slerp) {
+        float angle[BATCH_BLOCK_SIZE] = {};
+        float s[BATCH_BLOCK_SIZE];
+        float c[BATCH_BLOCK_SIZE];
+        for (int32_t i = 0; i < count; i++) angle[i] = t[i] * block.omega[i];
+        kernel.sincos(angle, count, s, c);
+        for (int32_t i = 0; i < count; i++) {
+            const float slerp_w1 = s[i] * block.inv_sin_omega[i];
+            const float slerp_w0 = c[i] - block.cos_omega[i] * slerp_w1;
+            const float is_linear = block.is_linear[i];
+            w0[i] = is_linear * (1 - t[i]) + (1 - is_linear) * slerp_w0;
+            w1[i] = is_linear * t[i] + (1 - is_linear) * slerp_w1;
+        }
+    } else {
+        for (int32_t i = 0; i < count; i++) {
+            w0[i] = 1 - t[i];
+            w1[i] = t[i];
+        }
+    }
+
+    float r[4][BATCH_BLOCK_SIZE];
+    for (int32_t c = 0; c < 4; c++) {
+        for (int32_t i = 0; i < count; i++) r[c][i] = w0[i] * block.q0[c][i] + w1[i] * block.q1[c][i];
+    }
+    float scale[BATCH_BLOCK_SIZE];
+    for (int32_t i = 0; i < count; i++) {
+        const float norm = std::sqrt(r[0][i] * r[0][i] + r[1][i] * r[1][i] + r[2][i] * r[2][i] + r[3][i] * r[3][i]);
+        const float is_nlerp = block.is_nlerp[i];
+        scale[i] = is_nlerp / norm + (1 - is_nlerp);
+    }
+    for (int32_t c = 0; c < 4; c++) {
+        for (int32_t i = 0; i < count; i++) out[c][i] = r[c][i] * scale[i];
+    }
+}
+
+static void GetPlanes(const float* quat, int32_t num, int32_t offset, const float* (&planes)[4])
+{
+    for (int32_t c = 0; c < 4; c++) planes[c] = quat + static_cast<size_t>(c) * num + offset;
+}
+
+static void GetPlanes(float* quat, int32_t num, int32_t offset, float* (&planes)[4])
+{
+    for (int32_t c = 0; c < 4; c++) planes[c] = quat + static_cast<size_t>(c) * num + offset;
+}
+
+static void Interpolate(const float* quat0, const float* quat1, int32_t num, const float* t, int32_t num_t, float max_error_rad, float* quat)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    SlerpBlock block;
+    float t_block[BATCH_BLOCK_SIZE];
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        const float* q0[4];
+        const float* q1[4];
+        GetPlanes(quat0, num, offset, q0);
+        GetPlanes(quat1, num, offset, q1);
+        PrepareSlerpBlock(kernel, q0, q1, count, true, max_error_rad, block);
+        for (int32_t j = 0; j < num_t; j++) {
+            std::fill(t_block, t_block + count, t[j]);
+            float* out[4];
+            GetPlanes(quat + static_cast<size_t>(j) * 4 * num, num, offset, out);
+            EvaluateSlerpBlock(kernel, block, t_block, out);
+        }
+    }
+}
+
+void RotationInterpolation::Slerps(const float* quat0, const float* quat1, int32_t num, const float* t, int32_t num_t, float* quat)
+{
+    Interpolate(quat0, quat1, num, t, num_t, -1.0f, quat);
+}
+
+void RotationInterpolation::Nlerps(const float* quat0, const float* quat1, int32_t num, const float* t, int32_t num_t, float max_error_rad, float* quat)
+{
+    Interpolate(quat0, quat1, num, t, num_t, max_error_rad, quat);
+}
+
+void RotationInterpolation::Squads(const float* quat1, const float* quat2, const float* s1, const float* s2, int32_t num, const float* t, int32_t num_t, float* quat)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    SlerpBlock block_q;
+    SlerpBlock block_s;
+    SlerpBlock block_squad;
+    float t_block[BATCH_BLOCK_SIZE];
+    float t_squad[BATCH_BLOCK_SIZE];
+    float slerp_q[4][BATCH_BLOCK_SIZE];
+    float slerp_s[4][BATCH_BLOCK_SIZE];
+    float* const slerp_q_out[4] = { slerp_q[0], slerp_q[1], slerp_q[2], slerp_q[3] };
+    float* const slerp_s_out[4] = { slerp_s[0], slerp_s[1], slerp_s[2], slerp_s[3] };
+    const float* const slerp_q_in[4] = { slerp_q[0], slerp_q[1], slerp_q[2], slerp_q[3] };
+    const float* const slerp_s_in[4] = { slerp_s[0], slerp_s[1], slerp_s[2], slerp_s[3] };
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        const float* q1[4];
+        const float* q2[4];
+        const float* p1[4];
+        const float* p2[4];
+        GetPlanes(quat1, num, offset, q1);
+        GetPlanes(quat2, num, offset, q2);
+        GetPlanes(s1, num, offset, p1);
+        GetPlanes(s2, num, offset, p2);
+        PrepareSlerpBlock(kernel, q1, q2, count, false, -1.0f, block_q);
+        PrepareSlerpBlock(kernel, p1, p2, count, false, -1.0f, block_s);
+        for (int32_t j = 0; j < num_t; j++) {
+            std::fill(t_block, t_block + count, t[j]);
+            std::fill(t_squad, t_squad + count, 2 * t[j] * (1 - t[j]));
+            EvaluateSlerpBlock(kernel, block_q, t_block, slerp_q_out);
+            EvaluateSlerpBlock(kernel, block_s, t_block, slerp_s_out);
+            PrepareSlerpBlock(kernel, slerp_q_in, slerp_s_in, count, false, -1.0f, block_squad);
+            float* out[4];
+            GetPlanes(quat + static_cast<size_t>(j) * 4 * num, num, offset, out);
+            EvaluateSlerpBlock(kernel, block_squad, t_squad, out);
+        }
+    }
+}
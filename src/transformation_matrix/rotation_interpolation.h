@@ -0,0 +1,52 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ROTATION_INTERPOLATION_H
+#define ROTATION_INTERPOLATION_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "quaternion.h"
+
+/*
+ * Interpolation between orientations. t = 0 is the first orientation and t = 1 is the second one.
+ * Slerp and Nlerp take the shortest path (q1 is negated if the angle to q0 is greater than 180 degrees).
+ * Squad is the smooth (C1) curve through keyframes, using control points calculated by SquadControlPoint.
+ */
+namespace RotationInterpolation
+{
+    Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+    Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+    /* Nlerp if its error in rotation angle from Slerp is within max_error_rad for any t, otherwise Slerp */
+    Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t, float max_error_rad);
+
+    /* The upper bound of the error in rotation angle between Nlerp and Slerp of q0 and q1 */
+    float NlerpErrorBound(const Quaternion& q0, const Quaternion& q1);
+
+    /* Interpolate between q1 and q2 using the control points s1 = SquadControlPoint(q0, q1, q2) and s2 = SquadControlPoint(q1, q2, q3) */
+    Quaternion Squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, float t);
+    Quaternion SquadControlPoint(const Quaternion& q_prev, const Quaternion& q, const Quaternion& q_next);
+
+    /* Batch functions which interpolate num pairs of quaternions at num_t parameters t[j] (no heap allocation)
+     * Quaternions are stored as 4 planes: component (0 = x, 1 = y, 2 = z, 3 = w) of the i-th quaternion is quat[component * num + i].
+     * The result has num_t sets of 4 planes: component of the i-th pair at t[j] is quat[(j * 4 + component) * num + i] */
+    void Slerps(const float* quat0, const float* quat1, int32_t num, const float* t, int32_t num_t, float* quat);
+    void Nlerps(const float* quat0, const float* quat1, int32_t num, const float* t, int32_t num_t, float max_error_rad, float* quat);
+    void Squads(const float* quat1, const float* quat2, const float* s1, const float* s2, int32_t num, const float* t, int32_t num_t, float* quat);
+}
+
+#endif
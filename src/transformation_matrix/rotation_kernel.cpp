@@ -0,0 +1,114 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "rotation_kernel.h"
+#include "rotation_kernel_simd.h"
+
+/*** Macro ***/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROTATION_KERNEL_DETECT_X86
+#endif
+
+/*** Global variable ***/
+
+/*** Function ***/
+namespace {
+/* One float at a time. Used when no SIMD instruction set is available (e.g. WebAssembly) */
+struct SimdScalar
+{
+    using Float = float;
+    using Mask = bool;
+    using Int = int32_t;
+    static constexpr int32_t WIDTH = 1;
+
+    static Float Load(const float* p) { return *p; }
+    static void Store(float* p, Float a) { *p = a; }
+    static Float Set1(float a) { return a; }
+    static Float Add(Float a, Float b) { return a + b; }
+    static Float Sub(Float a, Float b) { return a - b; }
+    static Float Mul(Float a, Float b) { return a * b; }
+    static Float Div(Float a, Float b) { return a / b; }
+    static Float Sqrt(Float a) { return std::sqrt(a); }
+    static Float MulAdd(Float a, Float b, Float c) { return a * b + c; }
+    static Float Min(Float a, Float b) { return (a < b) ? a : b; }
+    static Float Max(Float a, Float b) { return (a > b) ? a : b; }
+    static Float Abs(Float a) { return std::abs(a); }
+    static Float Neg(Float a) { return -a; }
+    static Float Xor(Float a, Float b)
+    {
+        uint32_t ua, ub;
+        std::memcpy(&ua, &a, sizeof(ua));
+        std::memcpy(&ub, &b, sizeof(ub));
+        ua ^= ub;
+        std::memcpy(&a, &ua, sizeof(ua));
+        return a;
+    }
+    static Float SignBit(Float a) { return std::signbit(a) ? -0.0f : 0.0f; }
+    static Mask CmpGt(Float a, Float b) { return a > b; }
+    static Mask SignMask(Float a) { return std::signbit(a); }
+    static Float Select(Mask m, Float a, Float b) { return m ? a : b; }
+    static Int RoundToInt(Float a) { return static_cast<Int>(std::lrint(a)); }
+    static Float IntToFloat(Int a) { return static_cast<Float>(a); }
+    static Int IntAdd(Int a, Int b) { return a + b; }
+    static Int IntSet1(int32_t a) { return a; }
+    static Mask TestBit(Int a, int32_t bit) { return (a & bit) != 0; }
+};
+}
+
+const RotationKernel::Kernel* RotationKernel::GetScalar()
+{
+    static const Kernel kernel = RotationKernelSimd::MakeKernel<SimdScalar>("scalar");
+    return &kernel;
+}
+
+#ifdef ROTATION_KERNEL_DETECT_X86
+static bool IsAvx2Supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+static bool IsAvx512Supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+#endif
+
+std::vector<const RotationKernel::Kernel*> RotationKernel::GetSupported()
+{
+    std::vector<const Kernel*> kernels = { GetScalar() };
+    /* SSE2 and NEON are always available when they are enabled at compile time */
+    if (GetSse2()) kernels.push_back(GetSse2());
+    if (GetNeon()) kernels.push_back(GetNeon());
+#ifdef ROTATION_KERNEL_DETECT_X86
+    /* Check the CPU first. The getters themselves are compiled for the instruction set */
+    if (IsAvx2Supported() && GetAvx2()) kernels.push_back(GetAvx2());
+    if (IsAvx512Supported() && GetAvx512()) kernels.push_back(GetAvx512());
+#endif
+    return kernels;
+}
+
+const RotationKernel::Kernel& RotationKernel::Get()
+{
+    static const Kernel& kernel = *GetSupported().back();
+    return kernel;
+}
@@ -0,0 +1,50 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ROTATION_KERNEL_H
+#define ROTATION_KERNEL_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/*
+ * Kernels for the batch conversion functions of RotationMatrix.
+ * Each kernel processes arrays with SIMD instructions (scalar, SSE2, AVX2, AVX-512 or NEON).
+ * The fastest kernel which runs on this CPU is selected at the first call of Get().
+ * 3x3 matrices are stored as 9 planes in the same way as RotationMatrix batch functions:
+ * element (row, col) of the i-th matrix is mat3_rot[(row * 3 + col) * num + i].
+ * asin, atan2 and sin/cos are polynomial approximations with an error of a few ulp (sin/cos is accurate for |angle| < 8192).
+ */
+namespace RotationKernel
+{
+    struct Kernel {
+        const char* name;
+        void (*sincos)(const float* angle, int32_t count, float* s, float* c);
+        void (*asin)(const float* value, int32_t count, float* angle);
+        void (*atan2)(const float* y, const float* x, int32_t count, float* angle);
+        /* count rotations are written to / read from the planes whose stride is num */
+        void (*quaternion_to_matrix)(const float* x, const float* y, const float* z, const float* w, int32_t count, float* mat3_rot, int32_t num);
+        void (*matrix_to_quaternion)(const float* mat3_rot, int32_t num, int32_t count, float* x, float* y, float* z, float* w);
+    };
+
+    /* The fastest kernel for this CPU */
+    const Kernel& Get();
+
+    /* All kernels which run on this CPU, from the slowest (scalar) to the fastest */
+    std::vector<const Kernel*> GetSupported();
+}
+
+#endif
@@ -0,0 +1,80 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "rotation_kernel.h"
+#include "rotation_kernel_simd.h"
+
+/*** Macro ***/
+/* This file is compiled with -mavx2 -mfma (see CMakeLists.txt) */
+#if defined(__AVX2__) && defined(__FMA__)
+#define ROTATION_KERNEL_USE_AVX2
+#endif
+
+/*** Function ***/
+#ifdef ROTATION_KERNEL_USE_AVX2
+#include <immintrin.h>
+
+namespace {
+struct SimdAvx2
+{
+    using Float = __m256;
+    using Mask = __m256;
+    using Int = __m256i;
+    static constexpr int32_t WIDTH = 8;
+
+    static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, Float a) { _mm256_storeu_ps(p, a); }
+    static Float Set1(float a) { return _mm256_set1_ps(a); }
+    static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+    static Float MulAdd(Float a, Float b, Float c) { return _mm256_fmadd_ps(a, b, c); }
+    static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Float Neg(Float a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static Float Xor(Float a, Float b) { return _mm256_xor_ps(a, b); }
+    static Float SignBit(Float a) { return _mm256_and_ps(a, _mm256_set1_ps(-0.0f)); }
+    static Mask CmpGt(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask SignMask(Float a) { return _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(a), 31)); }
+    static Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+    static Int RoundToInt(Float a) { return _mm256_cvtps_epi32(a); }
+    static Float IntToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+    static Int IntAdd(Int a, Int b) { return _mm256_add_epi32(a, b); }
+    static Int IntSet1(int32_t a) { return _mm256_set1_epi32(a); }
+    static Mask TestBit(Int a, int32_t bit)
+    {
+        const __m256i b = _mm256_set1_epi32(bit);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b));
+    }
+};
+}
+
+const RotationKernel::Kernel* RotationKernel::GetAvx2()
+{
+    static const Kernel kernel = RotationKernelSimd::MakeKernel<SimdAvx2>("avx2");
+    return &kernel;
+}
+#else
+const RotationKernel::Kernel* RotationKernel::GetAvx2()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,82 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "rotation_kernel.h"
+#include "rotation_kernel_simd.h"
+
+/*** Macro ***/
+/* This file is compiled with -mavx512f -mfma (see CMakeLists.txt). Only AVX-512F instructions are used */
+#if defined(__AVX512F__)
+#define ROTATION_KERNEL_USE_AVX512
+#endif
+
+/*** Function ***/
+#ifdef ROTATION_KERNEL_USE_AVX512
+/* GCC 12 warns about _mm512_undefined_ps() used inside the unmasked intrinsics. It is a false positive */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+
+namespace {
+struct SimdAvx512
+{
+    using Float = __m512;
+    using Mask = __mmask16;
+    using Int = __m512i;
+    static constexpr int32_t WIDTH = 16;
+
+    static Float Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, Float a) { _mm512_storeu_ps(p, a); }
+    static Float Set1(float a) { return _mm512_set1_ps(a); }
+    static Float Add(Float a, Float b) { return _mm512_add_ps(a, b); }
+    static Float Sub(Float a, Float b) { return _mm512_sub_ps(a, b); }
+    static Float Mul(Float a, Float b) { return _mm512_mul_ps(a, b); }
+    static Float Div(Float a, Float b) { return _mm512_div_ps(a, b); }
+    static Float Sqrt(Float a) { return _mm512_sqrt_ps(a); }
+    static Float MulAdd(Float a, Float b, Float c) { return _mm512_fmadd_ps(a, b, c); }
+    static Float Min(Float a, Float b) { return _mm512_min_ps(a, b); }
+    static Float Max(Float a, Float b) { return _mm512_max_ps(a, b); }
+    static Float Abs(Float a) { return _mm512_abs_ps(a); }
+    static Float Neg(Float a) { return Xor(a, _mm512_set1_ps(-0.0f)); }
+    /* float bitwise operations are AVX-512DQ, so use the integer ones */
+    static Float Xor(Float a, Float b) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b))); }
+    static Float SignBit(Float a) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(static_cast<int32_t>(0x80000000u)))); }
+    static Mask CmpGt(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Mask SignMask(Float a) { return _mm512_cmplt_epi32_mask(_mm512_castps_si512(a), _mm512_setzero_si512()); }
+    static Float Select(Mask m, Float a, Float b) { return _mm512_mask_blend_ps(m, b, a); }
+    static Int RoundToInt(Float a) { return _mm512_cvtps_epi32(a); }
+    static Float IntToFloat(Int a) { return _mm512_cvtepi32_ps(a); }
+    static Int IntAdd(Int a, Int b) { return _mm512_add_epi32(a, b); }
+    static Int IntSet1(int32_t a) { return _mm512_set1_epi32(a); }
+    static Mask TestBit(Int a, int32_t bit) { return _mm512_test_epi32_mask(a, _mm512_set1_epi32(bit)); }
+};
+}
+
+const RotationKernel::Kernel* RotationKernel::GetAvx512()
+{
+    static const Kernel kernel = RotationKernelSimd::MakeKernel<SimdAvx512>("avx512");
+    return &kernel;
+}
+#else
+const RotationKernel::Kernel* RotationKernel::GetAvx512()
+{
+    return nullptr;
+}
+#endif
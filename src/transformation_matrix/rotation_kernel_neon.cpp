@@ -0,0 +1,76 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "rotation_kernel.h"
+#include "rotation_kernel_simd.h"
+
+/*** Macro ***/
+/* NEON is always available on AArch64. (division, sqrt and rounding conversion are AArch64 only) */
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ROTATION_KERNEL_USE_NEON
+#endif
+
+/*** Function ***/
+#ifdef ROTATION_KERNEL_USE_NEON
+#include <arm_neon.h>
+
+namespace {
+struct SimdNeon
+{
+    using Float = float32x4_t;
+    using Mask = uint32x4_t;
+    using Int = int32x4_t;
+    static constexpr int32_t WIDTH = 4;
+
+    static Float Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, Float a) { vst1q_f32(p, a); }
+    static Float Set1(float a) { return vdupq_n_f32(a); }
+    static Float Add(Float a, Float b) { return vaddq_f32(a, b); }
+    static Float Sub(Float a, Float b) { return vsubq_f32(a, b); }
+    static Float Mul(Float a, Float b) { return vmulq_f32(a, b); }
+    static Float Div(Float a, Float b) { return vdivq_f32(a, b); }
+    static Float Sqrt(Float a) { return vsqrtq_f32(a); }
+    static Float MulAdd(Float a, Float b, Float c) { return vfmaq_f32(c, a, b); }
+    static Float Min(Float a, Float b) { return vminq_f32(a, b); }
+    static Float Max(Float a, Float b) { return vmaxq_f32(a, b); }
+    static Float Abs(Float a) { return vabsq_f32(a); }
+    static Float Neg(Float a) { return vnegq_f32(a); }
+    static Float Xor(Float a, Float b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static Float SignBit(Float a) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vdupq_n_u32(0x80000000u))); }
+    static Mask CmpGt(Float a, Float b) { return vcgtq_f32(a, b); }
+    static Mask SignMask(Float a) { return vcltq_s32(vreinterpretq_s32_f32(a), vdupq_n_s32(0)); }
+    static Float Select(Mask m, Float a, Float b) { return vbslq_f32(m, a, b); }
+    static Int RoundToInt(Float a) { return vcvtnq_s32_f32(a); }
+    static Float IntToFloat(Int a) { return vcvtq_f32_s32(a); }
+    static Int IntAdd(Int a, Int b) { return vaddq_s32(a, b); }
+    static Int IntSet1(int32_t a) { return vdupq_n_s32(a); }
+    static Mask TestBit(Int a, int32_t bit) { return vtstq_s32(a, vdupq_n_s32(bit)); }
+};
+}
+
+const RotationKernel::Kernel* RotationKernel::GetNeon()
+{
+    static const Kernel kernel = RotationKernelSimd::MakeKernel<SimdNeon>("neon");
+    return &kernel;
+}
+#else
+const RotationKernel::Kernel* RotationKernel::GetNeon()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,273 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ROTATION_KERNEL_SIMD_H
+#define ROTATION_KERNEL_SIMD_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "rotation_kernel.h"
+
+/*
+ * Kernel algorithms written once for all instruction sets.
+ * V is a set of SIMD operations defined in each rotation_kernel_*.cpp, which is compiled with its own target flags.
+ * V must be defined in an anonymous namespace, so that the instantiated code never leaks to other translation units.
+ * Don't call functions of the standard library here for the same reason.
+ *
+ * V provides:
+ *   types Float, Mask, Int, and WIDTH (number of floats in Float)
+ *   Load, Store, Set1, Add, Sub, Mul, Div, Sqrt, MulAdd (a * b + c), Min, Max, Abs, Neg, Xor, SignBit (only the sign bit)
+ *   CmpGt (Mask), SignMask (Mask of negative values including -0), Select (mask ? a : b)
+ *   RoundToInt, IntToFloat, IntAdd, IntSet1, TestBit (Mask of (int & bit) != 0)
+ */
+namespace RotationKernel
+{
+    /* Kernels for each instruction set, defined in rotation_kernel_*.cpp. nullptr if the target is not enabled at compile time.
+     * Don't call GetAvx2() / GetAvx512() on a CPU without the instruction set, because the function itself is compiled for it */
+    const Kernel* GetScalar();
+    const Kernel* GetSse2();
+    const Kernel* GetAvx2();
+    const Kernel* GetAvx512();
+    const Kernel* GetNeon();
+}
+
+namespace RotationKernelSimd
+{
+    static constexpr float PI = 3.14159265358979f;
+    static constexpr float PI_2 = 1.57079632679490f;
+    static constexpr float PI_4 = 0.785398163397448f;
+
+    /* Call block(in, out, i) for every V::WIDTH elements. in and out are arrays of pointers to the input / output arrays.
+     * The tail is processed through zero padded buffers */
+    template<typename V, int32_t IN_NUM, int32_t OUT_NUM, typename BLOCK>
+    void ForEachBlock(const float* const (&in)[IN_NUM], float* const (&out)[OUT_NUM], int32_t count, BLOCK block)
+    {
+        int32_t i = 0;
+        for (; i + V::WIDTH <= count; i += V::WIDTH) {
+            block(in, out, i);
+        }
+        const int32_t rest = count - i;
+        if (rest == 0) return;
+
+        float in_buffer[IN_NUM][V::WIDTH];
+        float out_buffer[OUT_NUM][V::WIDTH];
+        const float* in_tail[IN_NUM];
+        float* out_tail[OUT_NUM];
+        for (int32_t k = 0; k < IN_NUM; k++) {
+            for (int32_t j = 0; j < V::WIDTH; j++) in_buffer[k][j] = (j < rest) ? in[k][i + j] : 0.0f;
+            in_tail[k] = in_buffer[k];
+        }
+        for (int32_t k = 0; k < OUT_NUM; k++) out_tail[k] = out_buffer[k];
+        block(in_tail, out_tail, 0);
+        for (int32_t k = 0; k < OUT_NUM; k++) {
+            for (int32_t j = 0; j < rest; j++) out[k][i + j] = out_buffer[k][j];
+        }
+    }
+
+    /* sin/cos: reduce the angle to [-pi/4, pi/4] by the nearest multiple of pi/2 (split into 3 parts for precision)
+     * and select / negate the results of minimax polynomials by the quadrant (cephes sinf/cosf) */
+    template<typename V>
+    void SinCos(const float* angle, int32_t count, float* s, float* c)
+    {
+        using F = typename V::Float;
+        const float* const in[1] = { angle };
+        float* const out[2] = { s, c };
+        ForEachBlock<V>(in, out, count, [](const float* const* src, float* const* dst, int32_t i) {
+            const F x = V::Load(src[0] + i);
+            const typename V::Int q = V::RoundToInt(V::Mul(x, V::Set1(0.636619772367581f)));   /* 2 / pi */
+            const F y = V::IntToFloat(q);
+            F r = V::MulAdd(y, V::Set1(-1.5703125f), x);
+            r = V::MulAdd(y, V::Set1(-4.837512969970703125e-4f), r);
+            r = V::MulAdd(y, V::Set1(-7.54978995489188216e-8f), r);
+            const F z = V::Mul(r, r);
+
+            F sin_poly = V::MulAdd(V::Set1(-1.9515295891e-4f), z, V::Set1(8.3321608736e-3f));
+            sin_poly = V::MulAdd(sin_poly, z, V::Set1(-1.6666654611e-1f));
+            sin_poly = V::MulAdd(V::Mul(sin_poly, z), r, r);
+            F cos_poly = V::MulAdd(V::Set1(2.443315711809948e-5f), z, V::Set1(-1.388731625493765e-3f));
+            cos_poly = V::MulAdd(cos_poly, z, V::Set1(4.166664568298827e-2f));
+            cos_poly = V::MulAdd(V::Mul(cos_poly, z), z, V::Sub(V::Set1(1.0f), V::Mul(V::Set1(0.5f), z)));
+
+            const typename V::Mask swap = V::TestBit(q, 1);
+            F sin_value = V::Select(swap, cos_poly, sin_poly);
+            F cos_value = V::Select(swap, sin_poly, cos_poly);
+            sin_value = V::Select(V::TestBit(q, 2), V::Neg(sin_value), sin_value);
+            cos_value = V::Select(V::TestBit(V::IntAdd(q, V::IntSet1(1)), 2), V::Neg(cos_value), cos_value);
+            V::Store(dst[0] + i, sin_value);
+            V::Store(dst[1] + i, cos_value);
+        });
+    }
+
+    /* asin: use asin(a) = pi/2 - 2 * asin(sqrt((1 - a) / 2)) for a > 0.5, so that one polynomial covers all (cephes asinf) */
+    template<typename V>
+    void Asin(const float* value, int32_t count, float* angle)
+    {
+        using F = typename V::Float;
+        const float* const in[1] = { value };
+        float* const out[1] = { angle };
+        ForEachBlock<V>(in, out, count, [](const float* const* src, float* const* dst, int32_t i) {
+            const F x = V::Load(src[0] + i);
+            const F a = V::Abs(x);
+            const typename V::Mask is_large = V::CmpGt(a, V::Set1(0.5f));
+            const F z_large = V::Mul(V::Set1(0.5f), V::Sub(V::Set1(1.0f), a));
+            const F z = V::Select(is_large, z_large, V::Mul(a, a));
+            const F t = V::Select(is_large, V::Sqrt(z_large), a);
+            F p = V::MulAdd(V::Set1(4.2163199048e-2f), z, V::Set1(2.4181311049e-2f));
+            p = V::MulAdd(p, z, V::Set1(4.5470025998e-2f));
+            p = V::MulAdd(p, z, V::Set1(7.4953002686e-2f));
+            p = V::MulAdd(p, z, V::Set1(1.6666752422e-1f));
+            p = V::MulAdd(V::Mul(p, z), t, t);
+            p = V::Select(is_large, V::Sub(V::Set1(PI_2), V::Add(p, p)), p);
+            V::Store(dst[0] + i, V::Xor(p, V::SignBit(x)));
+        });
+    }
+
+    /* atan2: atan of min / max of |y| and |x| in [0, 1], reduced further by tan(pi/8) (cephes atanf), then fix the octant */
+    template<typename V>
+    void Atan2(const float* y, const float* x, int32_t count, float* angle)
+    {
+        using F = typename V::Float;
+        const float* const in[2] = { y, x };
+        float* const out[1] = { angle };
+        ForEachBlock<V>(in, out, count, [](const float* const* src, float* const* dst, int32_t i) {
+            const F value_y = V::Load(src[0] + i);
+            const F value_x = V::Load(src[1] + i);
+            const F ay = V::Abs(value_y);
+            const F ax = V::Abs(value_x);
+            const F max_value = V::Max(ax, ay);
+            const F min_value = V::Min(ax, ay);
+            F t = V::Div(min_value, V::Select(V::CmpGt(max_value, V::Set1(0.0f)), max_value, V::Set1(1.0f)));
+            const typename V::Mask is_large = V::CmpGt(t, V::Set1(0.414213562373095f));   /* tan(pi/8) */
+            t = V::Select(is_large, V::Div(V::Sub(t, V::Set1(1.0f)), V::Add(t, V::Set1(1.0f))), t);
+            const F z = V::Mul(t, t);
+            F p = V::MulAdd(V::Set1(8.05374449538e-2f), z, V::Set1(-1.38776856032e-1f));
+            p = V::MulAdd(p, z, V::Set1(1.99777106478e-1f));
+            p = V::MulAdd(p, z, V::Set1(-3.33329491539e-1f));
+            p = V::MulAdd(V::Mul(p, z), t, t);
+            p = V::Select(is_large, V::Add(p, V::Set1(PI_4)), p);
+            p = V::Select(V::CmpGt(ay, ax), V::Sub(V::Set1(PI_2), p), p);
+            p = V::Select(V::SignMask(value_x), V::Sub(V::Set1(PI), p), p);
+            V::Store(dst[0] + i, V::Xor(p, V::SignBit(value_y)));
+        });
+    }
+
+    /* Same as RotationMatrix::ConvertQuaternion2RotationMatrix */
+    template<typename V>
+    void QuaternionToMatrix(const float* x, const float* y, const float* z, const float* w, int32_t count, float* mat3_rot, int32_t num)
+    {
+        using F = typename V::Float;
+        const float* const in[4] = { x, y, z, w };
+        float* const out[9] = {
+            mat3_rot, mat3_rot + static_cast<size_t>(num), mat3_rot + static_cast<size_t>(num) * 2,
+            mat3_rot + static_cast<size_t>(num) * 3, mat3_rot + static_cast<size_t>(num) * 4, mat3_rot + static_cast<size_t>(num) * 5,
+            mat3_rot + static_cast<size_t>(num) * 6, mat3_rot + static_cast<size_t>(num) * 7, mat3_rot + static_cast<size_t>(num) * 8,
+        };
+        ForEachBlock<V>(in, out, count, [](const float* const* src, float* const* dst, int32_t i) {
+            const F qx = V::Load(src[0] + i);
+            const F qy = V::Load(src[1] + i);
+            const F qz = V::Load(src[2] + i);
+            const F qw = V::Load(src[3] + i);
+            /* 2 / |q|^2 is applied instead of normalizing each element */
+            const F norm = V::MulAdd(qx, qx, V::MulAdd(qy, qy, V::MulAdd(qz, qz, V::Mul(qw, qw))));
+            const F d = V::Div(V::Set1(2.0f), norm);
+            const F dx = V::Mul(qx, d);
+            const F dy = V::Mul(qy, d);
+            const F dz = V::Mul(qz, d);
+            const F xx = V::Mul(qx, dx);
+            const F yy = V::Mul(qy, dy);
+            const F zz = V::Mul(qz, dz);
+            const F xy = V::Mul(qx, dy);
+            const F xz = V::Mul(qx, dz);
+            const F yz = V::Mul(qy, dz);
+            const F xw = V::Mul(qw, dx);
+            const F yw = V::Mul(qw, dy);
+            const F zw = V::Mul(qw, dz);
+            const F one = V::Set1(1.0f);
+            V::Store(dst[0] + i, V::Sub(V::Sub(one, yy), zz));
+            V::Store(dst[1] + i, V::Sub(xy, zw));
+            V::Store(dst[2] + i, V::Add(xz, yw));
+            V::Store(dst[3] + i, V::Add(xy, zw));
+            V::Store(dst[4] + i, V::Sub(V::Sub(one, xx), zz));
+            V::Store(dst[5] + i, V::Sub(yz, xw));
+            V::Store(dst[6] + i, V::Sub(xz, yw));
+            V::Store(dst[7] + i, V::Add(yz, xw));
+            V::Store(dst[8] + i, V::Sub(V::Sub(one, xx), yy));
+        });
+    }
+
+    /* Same as RotationMatrix::ConvertRotationMatrix2Quaternion, but the 4 cases (by the trace, or the largest diagonal element)
+     * are selected without branches: S = 2 * sqrt(1 +- m00 +- m11 +- m22), and each component is 0.25 * S or (a pair of elements) / S */
+    template<typename V>
+    void MatrixToQuaternion(const float* mat3_rot, int32_t num, int32_t count, float* x, float* y, float* z, float* w)
+    {
+        using F = typename V::Float;
+        const float* const in[9] = {
+            mat3_rot, mat3_rot + static_cast<size_t>(num), mat3_rot + static_cast<size_t>(num) * 2,
+            mat3_rot + static_cast<size_t>(num) * 3, mat3_rot + static_cast<size_t>(num) * 4, mat3_rot + static_cast<size_t>(num) * 5,
+            mat3_rot + static_cast<size_t>(num) * 6, mat3_rot + static_cast<size_t>(num) * 7, mat3_rot + static_cast<size_t>(num) * 8,
+        };
+        float* const out[4] = { x, y, z, w };
+        ForEachBlock<V>(in, out, count, [](const float* const* src, float* const* dst, int32_t i) {
+            const F m00 = V::Load(src[0] + i);
+            const F m01 = V::Load(src[1] + i);
+            const F m02 = V::Load(src[2] + i);
+            const F m10 = V::Load(src[3] + i);
+            const F m11 = V::Load(src[4] + i);
+            const F m12 = V::Load(src[5] + i);
+            const F m20 = V::Load(src[6] + i);
+            const F m21 = V::Load(src[7] + i);
+            const F m22 = V::Load(src[8] + i);
+
+            /* Cases in priority order: w (trace > 0), x (m00 is the largest), y (m11 > m22), z */
+            const F zero = V::Set1(0.0f);
+            const typename V::Mask is_w = V::CmpGt(V::Add(V::Add(m00, m11), m22), zero);
+            const typename V::Mask is_x = V::CmpGt(V::Min(V::Sub(m00, m11), V::Sub(m00, m22)), zero);
+            const typename V::Mask is_y = V::CmpGt(m11, m22);
+            const F plus = V::Set1(1.0f);
+            const F minus = V::Set1(-1.0f);
+            const F sign_x = V::Select(is_w, plus, V::Select(is_x, plus, minus));
+            const F sign_y = V::Select(is_w, plus, V::Select(is_x, minus, V::Select(is_y, plus, minus)));
+            const F sign_z = V::Select(is_w, plus, V::Select(is_x, minus, V::Select(is_y, minus, plus)));
+            const F s = V::Add(V::Set1(1.0f), V::MulAdd(sign_x, m00, V::MulAdd(sign_y, m11, V::Mul(sign_z, m22))));
+            const F root = V::Sqrt(s);
+            const F quarter = V::Mul(V::Set1(0.5f), root);     /* 0.25 * S */
+            const F inv = V::Div(V::Set1(0.5f), root);         /* 1 / S */
+
+            const F d_x = V::Mul(V::Sub(m21, m12), inv);
+            const F d_y = V::Mul(V::Sub(m02, m20), inv);
+            const F d_z = V::Mul(V::Sub(m10, m01), inv);
+            const F s_xy = V::Mul(V::Add(m01, m10), inv);
+            const F s_xz = V::Mul(V::Add(m02, m20), inv);
+            const F s_yz = V::Mul(V::Add(m12, m21), inv);
+            const F qw = V::Select(is_w, quarter, V::Select(is_x, d_x, V::Select(is_y, d_y, d_z)));
+            const F qx = V::Select(is_w, d_x, V::Select(is_x, quarter, V::Select(is_y, s_xy, s_xz)));
+            const F qy = V::Select(is_w, d_y, V::Select(is_x, s_xy, V::Select(is_y, quarter, s_yz)));
+            const F qz = V::Select(is_w, d_z, V::Select(is_x, s_xz, V::Select(is_y, s_yz, quarter)));
+            V::Store(dst[0] + i, qx);
+            V::Store(dst[1] + i, qy);
+            V::Store(dst[2] + i, qz);
+            V::Store(dst[3] + i, qw);
+        });
+    }
+
+    template<typename V>
+    RotationKernel::Kernel MakeKernel(const char* name)
+    {
+        return RotationKernel::Kernel{ name, SinCos<V>, Asin<V>, Atan2<V>, QuaternionToMatrix<V>, MatrixToQuaternion<V> };
+    }
+}
+
+#endif
@@ -0,0 +1,80 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "rotation_kernel.h"
+#include "rotation_kernel_simd.h"
+
+/*** Macro ***/
+/* SSE2 is always available on x86-64 */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROTATION_KERNEL_USE_SSE2
+#endif
+
+/*** Function ***/
+#ifdef ROTATION_KERNEL_USE_SSE2
+#include <emmintrin.h>
+
+namespace {
+struct SimdSse2
+{
+    using Float = __m128;
+    using Mask = __m128;
+    using Int = __m128i;
+    static constexpr int32_t WIDTH = 4;
+
+    static Float Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, Float a) { _mm_storeu_ps(p, a); }
+    static Float Set1(float a) { return _mm_set1_ps(a); }
+    static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+    static Float MulAdd(Float a, Float b, Float c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+    static Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Float Neg(Float a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static Float Xor(Float a, Float b) { return _mm_xor_ps(a, b); }
+    static Float SignBit(Float a) { return _mm_and_ps(a, _mm_set1_ps(-0.0f)); }
+    static Mask CmpGt(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+    static Mask SignMask(Float a) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(a), 31)); }
+    static Float Select(Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static Int RoundToInt(Float a) { return _mm_cvtps_epi32(a); }
+    static Float IntToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+    static Int IntAdd(Int a, Int b) { return _mm_add_epi32(a, b); }
+    static Int IntSet1(int32_t a) { return _mm_set1_epi32(a); }
+    static Mask TestBit(Int a, int32_t bit)
+    {
+        const __m128i b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, b), b));
+    }
+};
+}
+
+const RotationKernel::Kernel* RotationKernel::GetSse2()
+{
+    static const Kernel kernel = RotationKernelSimd::MakeKernel<SimdSse2>("sse2");
+    return &kernel;
+}
+#else
+const RotationKernel::Kernel* RotationKernel::GetSse2()
+{
+    return nullptr;
+}
+#endif
@@ -17,18 +17,71 @@ limitations under the License.
 #include <cstdio>
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <atomic>
 #include <vector>
+#include <algorithm>
 #include <stdexcept>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 #include "rotation_matrix.h"
+#include "rotation_kernel.h"
+#include "fast_trig.h"
 
 /*** Macro ***/
 static constexpr float ALMOST_ONE = 0.9999999f;
 
 /*** Global variable ***/
+/* Atomic because it may be changed while other threads convert. Relaxed: no other data is published with it */
+static std::atomic<RotationMatrix::TRIG_MODE> s_trig_mode(RotationMatrix::TRIG_MODE::EXACT);
 
 /*** Function ***/
+void RotationMatrix::SetTrigMode(TRIG_MODE mode)
+{
+    s_trig_mode.store(mode, std::memory_order_relaxed);
+}
+
+RotationMatrix::TRIG_MODE RotationMatrix::GetTrigMode()
+{
+    return s_trig_mode.load(std::memory_order_relaxed);
+}
+
+static inline bool IsFastTrig()
+{
+    return s_trig_mode.load(std::memory_order_relaxed) == RotationMatrix::TRIG_MODE::FAST;
+}
+
+/* Trigonometric functions selected by the trig mode */
+static inline void SinCos(float rad, float& s, float& c)
+{
+    if (IsFastTrig()) {
+        FastTrig::SinCos(rad, s, c);
+    } else {
+        s = std::sin(rad);
+        c = std::cos(rad);
+    }
+}
+
+static inline float Asin(float value)
+{
+    return IsFastTrig() ? FastTrig::Asin(value) : std::asin(value);
+}
+
+static inline float Acos(float value)
+{
+    return IsFastTrig() ? FastTrig::Acos(value) : std::acos(value);
+}
+
+static inline float Atan(float value)
+{
+    return IsFastTrig() ? FastTrig::Atan(value) : std::atan(value);
+}
+
+static inline float Atan2(float y, float x)
+{
+    return IsFastTrig() ? FastTrig::Atan2(y, x) : std::atan2(y, x);
+}
+
 static float clamp_one(float value)
 {
     if (value <= -1.0) return -ALMOST_ONE;
@@ -36,49 +89,188 @@ static float clamp_one(float value)
     else return value;
 }
 
-Matrix RotationMatrix::RotateX(float rad)
+/* SO(3) exp map (rotation vector v -> rotation matrix) and log map (rotation matrix -> rotation vector)
+ * exp: R = I + a [v]x + b [v]x^2, where rad = |v|, a = sin(rad) / rad, b = (1 - cos(rad)) / rad^2
+ * log: v = w * rad / sin(rad), where w = sin(rad) * axis is the skew part of R and cos(rad) = (trace - 1) / 2.
+ *      Near pi, w is too short to give the axis. Then the quaternion q of R is used instead (its case by the largest diagonal keeps the axis accurate):
+ *      rad = 2 atan2(|q.xyz|, |q.w|), v = q.xyz * rad / |q.xyz| (the sign of q.w selects the side). The batch functions always use the quaternion
+ * a, b and rad / sin(rad) are Taylor series around 0, so that nothing is divided by a tiny value.
+ * The helpers calculate both sides and blend them by arithmetic instead of branches (the unused side stays finite), so that the batch functions are vectorized */
+static constexpr float EXP_SERIES_RAD2 = 1e-2f;     /* rad^2 below which the series is used. The truncation error is rad^6 / 5040 */
+static constexpr float LOG_SERIES_N2 = 1e-4f;       /* |q.xyz|^2 = sin(rad / 2)^2 (or sin(rad)^2) below which the series is used */
+static constexpr float LOG_NEAR_PI_COS = -0.99f;    /* cos(rad) below which the scalar log takes the axis from the quaternion */
+
+/* s_half and c_half are sin(rad / 2) and cos(rad / 2). They are not used (and can be anything finite) if rad2 < EXP_SERIES_RAD2 */
+static inline void ExpSO3Coefficients(float rad2, float s_half, float c_half, float& a, float& b)
 {
-    Matrix mat3_rot = Matrix::Identity(3);
-    mat3_rot[4] = std::cos(rad);
-    mat3_rot[5] = -std::sin(rad);
-    mat3_rot[7] = std::sin(rad);
-    mat3_rot[8] = std::cos(rad);
-    return mat3_rot;
+    const float is_series = static_cast<float>(rad2 < EXP_SERIES_RAD2);
+    const float a_series = 1.0f - rad2 * (1.0f / 6.0f) + rad2 * rad2 * (1.0f / 120.0f);
+    const float b_series = 0.5f - rad2 * (1.0f / 24.0f) + rad2 * rad2 * (1.0f / 720.0f);
+    /* sin(rad) = 2 s c, 1 - cos(rad) = 2 s^2 (no cancellation for small rad). Adding is_series keeps the unused side finite */
+    const float inv_rad = 1.0f / std::sqrt(rad2 + is_series);
+    const float a_direct = 2.0f * s_half * c_half * inv_rad;
+    const float b_direct = 2.0f * s_half * s_half * inv_rad * inv_rad;
+    a = a_direct + is_series * (a_series - a_direct);
+    b = b_direct + is_series * (b_series - b_direct);
 }
 
-Matrix RotationMatrix::RotateY(float rad)
+static inline void ExpSO3Elements(float x, float y, float z, float a, float b, float m[9])
 {
-    Matrix mat3_rot = Matrix::Identity(3);
-    mat3_rot[0] = std::cos(rad);
-    mat3_rot[2] = std::sin(rad);
-    mat3_rot[6] = -std::sin(rad);
-    mat3_rot[8] = std::cos(rad);
-    return mat3_rot;
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    m[0] = 1.0f - b * (yy + zz);
+    m[1] = b * xy - a * z;
+    m[2] = b * xz + a * y;
+    m[3] = b * xy + a * z;
+    m[4] = 1.0f - b * (xx + zz);
+    m[5] = b * yz - a * x;
+    m[6] = b * xz - a * y;
+    m[7] = b * yz + a * x;
+    m[8] = 1.0f - b * (xx + yy);
 }
 
-Matrix RotationMatrix::RotateZ(float rad)
+/* n = |(x, y, z)| and half = atan2(n, |w|) of the quaternion (it doesn't need to be normalized) */
+static inline void LogSO3Elements(float x, float y, float z, float w, float n, float half, float v[3])
+{
+    const float is_series = static_cast<float>(n * n < LOG_SERIES_N2 * (w * w + n * n));
+    const float abs_w = std::abs(w);
+    /* rad / n = 2 atan(t) / n = (2 / |w|) (1 - t^2 / 3 + t^4 / 5), t = n / |w| */
+    const float inv_w = 1.0f / (abs_w + (1.0f - is_series));
+    const float t2 = n * n * inv_w * inv_w;
+    const float k_series = 2.0f * inv_w * (1.0f - t2 * (1.0f / 3.0f) + t2 * t2 * (1.0f / 5.0f));
+    const float k_direct = 2.0f * half / (n + is_series);
+    const float k = k_direct + is_series * (k_series - k_direct);
+    const float signed_k = (w < 0.0f) ? -k : k;
+    v[0] = x * signed_k;
+    v[1] = y * signed_k;
+    v[2] = z * signed_k;
+}
+
+/* Re-orthonormalization of a matrix m (row major) in place. They don't branch, so that the batch function is vectorized */
+static constexpr int32_t POLAR_MAX_ITERATION = 16;
+static constexpr float POLAR_CONVERGED_CHANGE2 = 1e-8f;     /* sum of the squared change by an iteration. The error left is about its square (quadratic convergence) */
+
+/* The first column keeps its direction, the second column is made perpendicular to it, and the third is their cross product */
+static inline void GramSchmidtElements(float m[9])
+{
+    const float inv0 = 1.0f / std::sqrt(m[0] * m[0] + m[3] * m[3] + m[6] * m[6]);
+    const float x0 = m[0] * inv0, y0 = m[3] * inv0, z0 = m[6] * inv0;
+    const float d = x0 * m[1] + y0 * m[4] + z0 * m[7];
+    float x1 = m[1] - d * x0, y1 = m[4] - d * y0, z1 = m[7] - d * z0;
+    const float inv1 = 1.0f / std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+    x1 *= inv1;
+    y1 *= inv1;
+    z1 *= inv1;
+    m[0] = x0; m[1] = x1; m[2] = y0 * z1 - z0 * y1;
+    m[3] = y0; m[4] = y1; m[5] = z0 * x1 - x0 * z1;
+    m[6] = z0; m[7] = z1; m[8] = x0 * y1 - y0 * x1;
+}
+
+/* One step of the scaled Newton iteration X = (g X + X^-T / g) / 2 for the orthogonal factor of the polar decomposition
+ * (the closest rotation in the Frobenius norm, same as U V^T of SVD), where X^-T = cofactor(X) / det(X) and g = sqrt(|X^-1| / |X|) (Frobenius).
+ * It converges quadratically. Returns the sum of the squared change of the elements */
+static inline float PolarStepElements(float m[9])
 {
-    Matrix mat3_rot = Matrix::Identity(3);
-    mat3_rot[0] = std::cos(rad);
-    mat3_rot[1] = -std::sin(rad);
-    mat3_rot[3] = std::sin(rad);
-    mat3_rot[4] = std::cos(rad);
-    return mat3_rot;
+    float cof[9];
+    cof[0] = m[4] * m[8] - m[5] * m[7];
+    cof[1] = m[5] * m[6] - m[3] * m[8];
+    cof[2] = m[3] * m[7] - m[4] * m[6];
+    cof[3] = m[2] * m[7] - m[1] * m[8];
+    cof[4] = m[0] * m[8] - m[2] * m[6];
+    cof[5] = m[1] * m[6] - m[0] * m[7];
+    cof[6] = m[1] * m[5] - m[2] * m[4];
+    cof[7] = m[2] * m[3] - m[0] * m[5];
+    cof[8] = m[0] * m[4] - m[1] * m[3];
+    const float det = m[0] * cof[0] + m[1] * cof[1] + m[2] * cof[2];
+    float norm2 = 0.0f;
+    float cof_norm2 = 0.0f;
+    for (int32_t k = 0; k < 9; k++) {
+        norm2 += m[k] * m[k];
+        cof_norm2 += cof[k] * cof[k];
+    }
+    /* g^2 = |cof| / (|det| |X|) */
+    const float g = std::sqrt(std::sqrt(cof_norm2 / norm2) / std::abs(det));
+    const float a = 0.5f * g;
+    const float b = 0.5f / (g * det);
+    float change2 = 0.0f;
+    for (int32_t k = 0; k < 9; k++) {
+        const float next = a * m[k] + b * cof[k];
+        change2 += (next - m[k]) * (next - m[k]);
+        m[k] = next;
+    }
+    return change2;
 }
 
-Matrix RotationMatrix::NormalizeRotationMatrix(const Matrix mat3_rot)
+template<typename MAT3>
+static Mat3 NormalizeRotationMatrixImpl(const MAT3& mat3_rot, RotationMatrix::NORMALIZE_METHOD method)
 {
-    Matrix vec = RotationMatrix::ConvertRotationMatrix2Quaternion(mat3_rot);
-    Matrix mat3_rot_normalized = RotationMatrix::ConvertQuaternion2RotationMatrix(vec[0], vec[1], vec[2], vec[3]);
+    Mat3 mat3_rot_normalized;
+    if (method == RotationMatrix::NORMALIZE_METHOD::QUATERNION) {
+        const Vec4 vec = ConvertRotationMatrix2QuaternionImpl(mat3_rot);
+        RotationMatrix::ConvertQuaternion2RotationMatrix(vec[0], vec[1], vec[2], vec[3], mat3_rot_normalized);
+        return mat3_rot_normalized;
+    }
+
+    float m[9];
+    for (int32_t n = 0; n < 9; n++) m[n] = mat3_rot(n / 3, n % 3);
+    if (method == RotationMatrix::NORMALIZE_METHOD::GRAM_SCHMIDT) {
+        GramSchmidtElements(m);
+    } else {
+        for (int32_t iteration = 0; iteration < POLAR_MAX_ITERATION; iteration++) {
+            if (PolarStepElements(m) < POLAR_CONVERGED_CHANGE2) break;
+        }
+    }
+    for (int32_t n = 0; n < 9; n++) mat3_rot_normalized[n] = m[n];
     return mat3_rot_normalized;
 }
 
-Matrix RotationMatrix::ConvertAxisAngle2RotationMatrix(float x, float y, float z, float rad)
+void RotationMatrix::RotateX(float rad, Mat3& mat3_rot)
+{
+    float s, c;
+    SinCos(rad, s, c);
+    mat3_rot = Mat3::Identity();
+    mat3_rot[4] = c;
+    mat3_rot[5] = -s;
+    mat3_rot[7] = s;
+    mat3_rot[8] = c;
+}
+
+void RotationMatrix::RotateY(float rad, Mat3& mat3_rot)
+{
+    float s, c;
+    SinCos(rad, s, c);
+    mat3_rot = Mat3::Identity();
+    mat3_rot[0] = c;
+    mat3_rot[2] = s;
+    mat3_rot[6] = -s;
+    mat3_rot[8] = c;
+}
+
+void RotationMatrix::RotateZ(float rad, Mat3& mat3_rot)
+{
+    float s, c;
+    SinCos(rad, s, c);
+    mat3_rot = Mat3::Identity();
+    mat3_rot[0] = c;
+    mat3_rot[1] = -s;
+    mat3_rot[3] = s;
+    mat3_rot[4] = c;
+}
+
+Mat3 RotationMatrix::NormalizeRotationMatrix(const Mat3& mat3_rot, NORMALIZE_METHOD method)
+{
+    return NormalizeRotationMatrixImpl(mat3_rot, method);
+}
+
+void RotationMatrix::ConvertAxisAngle2RotationMatrix(float x, float y, float z, float rad, Mat3& mat3_rot)
 {
     /* Normalize */
     float d = x * x + y * y + z * z;
     d = std::sqrt(d);
-    if (d <= 0.0f) return Matrix::Identity(3);
+    if (d <= 0.0f) {
+        mat3_rot = Mat3::Identity();
+        return;
+    }
 
     x /= d;
     y /= d;
@@ -86,10 +278,8 @@ Matrix RotationMatrix::ConvertAxisAngle2RotationMatrix(float x, float y, float z
 
     /* Rodrigues' rotation formula */
     /* http://www.euclideanspace.com/maths/geometry/rotations/conversions/angleToMatrix/index.htm */
-    Matrix mat3_rot = Matrix::Identity(3);
-    
-    const float c = std::cos(rad);
-    const float s = std::sin(rad);
+    float s, c;
+    SinCos(rad, s, c);
     const float t = 1.0f - c;
     mat3_rot[0] = t * x * x + c;
     mat3_rot[1] = t * x * y - z * s;
@@ -100,26 +290,25 @@ Matrix RotationMatrix::ConvertAxisAngle2RotationMatrix(float x, float y, float z
     mat3_rot[6] = t * x * z - y * s;
     mat3_rot[7] = t * y * z + x * s;
     mat3_rot[8] = t * z * z + c;
-
-    return mat3_rot;
-
 }
 
-Matrix RotationMatrix::ConvertRotationVector2RotationMatrix(float x_rad, float y_rad, float z_rad)
+void RotationMatrix::ConvertRotationVector2RotationMatrix(float x_rad, float y_rad, float z_rad, Mat3& mat3_rot)
 {
-    float rad = x_rad * x_rad + y_rad * y_rad + z_rad * z_rad;
-    rad = std::sqrt(rad);
-    if (rad <= 0.0f) return Matrix::Identity(3);
-
-    float x = x_rad / rad;
-    float y = y_rad / rad;
-    float z = z_rad / rad;
-
-    Matrix mat3_rot = ConvertAxisAngle2RotationMatrix(x, y, z, rad);
-    return mat3_rot;
+    const float rad2 = x_rad * x_rad + y_rad * y_rad + z_rad * z_rad;
+    float s_half = 0.0f;
+    float c_half = 1.0f;
+    if (rad2 >= EXP_SERIES_RAD2) {
+        const float half = 0.5f * std::sqrt(rad2);
+        SinCos(half, s_half, c_half);
+    }
+    float a, b;
+    ExpSO3Coefficients(rad2, s_half, c_half, a, b);
+    float m[9];
+    ExpSO3Elements(x_rad, y_rad, z_rad, a, b, m);
+    for (int32_t n = 0; n < 9; n++) mat3_rot[n] = m[n];
 }
 
-Matrix RotationMatrix::ConvertQuaternion2RotationMatrix(float x, float y, float z, float w)
+void RotationMatrix::ConvertQuaternion2RotationMatrix(float x, float y, float z, float w, Mat3& mat3_rot)
 {
     /* Normalize */
     float d = x * x + y * y + z * z + w * w;
@@ -130,7 +319,6 @@ Matrix RotationMatrix::ConvertQuaternion2RotationMatrix(float x, float y, float
     w /= d;
 
     /* http://www.euclideanspace.com/maths/geometry/rotations/conversions/quaternionToMatrix/index.htm */
-    Matrix mat3_rot = Matrix::Identity(3);
     mat3_rot(0, 0) = 1 - 2 * y * y - 2 * z * z;
     mat3_rot(0, 1) = 2 * x * y - 2 * z * w;
     mat3_rot(0, 2) = 2 * x * z + 2 * y * w;
@@ -140,97 +328,136 @@ Matrix RotationMatrix::ConvertQuaternion2RotationMatrix(float x, float y, float
     mat3_rot(2, 0) = 2 * x * z - 2 * y * w;
     mat3_rot(2, 1) = 2 * y * z + 2 * x * w;
     mat3_rot(2, 2) = 1 - 2 * x * x - 2 * y * y;
-    return mat3_rot;
 }
 
-Matrix RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+/* Axes of mobile euler angles from left to right in the product (e.g. XYZ = RotX * RotY * RotZ),
+ * and the parity of the permutation (+1 for XYZ, YZX, ZXY, -1 for the others) */
+struct EulerAxes {
+    int32_t axis[3];
+    float parity;
+};
+
+static const EulerAxes& GetMobileAxes(RotationMatrix::EULER_ORDER order)
 {
-    Matrix mat3_rot;
-    switch (order) {
-    case EULER_ORDER::XYZ:
-        mat3_rot = RotateX(x) * RotateY(y) * RotateZ(z);
-        break;
-    case EULER_ORDER::XZY:
-        mat3_rot = RotateX(x) * RotateZ(z) * RotateY(y);
-        break;
-    case EULER_ORDER::YXZ:
-        mat3_rot = RotateY(y) * RotateX(x) * RotateZ(z);
-        break;
-    case EULER_ORDER::YZX:
-        mat3_rot = RotateY(y) * RotateZ(z) * RotateX(x);
-        break;
-    case EULER_ORDER::ZXY:
-        mat3_rot = RotateZ(z) * RotateX(x) * RotateY(y);
-        break;
-    case EULER_ORDER::ZYX:
-        mat3_rot = RotateZ(z) * RotateY(y) * RotateX(x);
-        break;
-    }
-    return mat3_rot;
+    static constexpr EulerAxes AXES[6] = {
+        /* XYZ */ { { 0, 1, 2 }, 1.0f },
+        /* XZY */ { { 0, 2, 1 }, -1.0f },
+        /* YXZ */ { { 1, 0, 2 }, -1.0f },
+        /* YZX */ { { 1, 2, 0 }, 1.0f },
+        /* ZXY */ { { 2, 0, 1 }, 1.0f },
+        /* ZYX */ { { 2, 1, 0 }, -1.0f },
+    };
+    return AXES[static_cast<int32_t>(order)];
 }
 
-Matrix RotationMatrix::ConvertEulerFixed2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+/* Fixed angles in an order is the same as mobile angles in the reversed order */
+static RotationMatrix::EULER_ORDER ReverseOrder(RotationMatrix::EULER_ORDER order)
 {
-    Matrix mat3_rot;
     switch (order) {
-    case EULER_ORDER::XYZ:
-        mat3_rot = RotateZ(z) * RotateY(y) * RotateX(x);
-        break;
-    case EULER_ORDER::XZY:
-        mat3_rot = RotateY(y) * RotateZ(z) * RotateX(x);
-        break;
-    case EULER_ORDER::YXZ:
-        mat3_rot = RotateZ(z) * RotateX(x) * RotateY(y);
-        break;
-    case EULER_ORDER::YZX:
-        mat3_rot = RotateX(x) * RotateZ(z) * RotateY(y);
-        break;
-    case EULER_ORDER::ZXY:
-        mat3_rot = RotateY(y) * RotateX(x) * RotateZ(z);
-        break;
-    case EULER_ORDER::ZYX:
-        mat3_rot = RotateX(x) * RotateY(y) * RotateZ(z);
-        break;
+    case RotationMatrix::EULER_ORDER::XYZ: return RotationMatrix::EULER_ORDER::ZYX;
+    case RotationMatrix::EULER_ORDER::XZY: return RotationMatrix::EULER_ORDER::YZX;
+    case RotationMatrix::EULER_ORDER::YXZ: return RotationMatrix::EULER_ORDER::ZXY;
+    case RotationMatrix::EULER_ORDER::YZX: return RotationMatrix::EULER_ORDER::XZY;
+    case RotationMatrix::EULER_ORDER::ZXY: return RotationMatrix::EULER_ORDER::YXZ;
+    case RotationMatrix::EULER_ORDER::ZYX: return RotationMatrix::EULER_ORDER::XYZ;
     }
+    return order;
+}
 
-    return mat3_rot;
+/* Element index (row * 3 + col) of the n-th value of EulerMobileClosedForm */
+static void GetMobileElements(const EulerAxes& axes, int32_t elements[9])
+{
+    for (int32_t n = 0; n < 9; n++) elements[n] = axes.axis[n / 3] * 3 + axes.axis[n % 3];
 }
 
+/* Closed form of RotI(a) * RotJ(b) * RotK(c), where (I, J, K) = axes.axis and (a, b, c) are the angles around them.
+ * This is the expansion for XYZ. The other orders are the same in the permuted rows / cols,
+ * and the rotation around a permuted axis is in the opposite direction if the permutation is odd.
+ * The result is in the order of (I, I), (I, J), (I, K), (J, I), ... Use GetMobileElements to place them */
+static inline void EulerMobileClosedForm(float parity, float ca, float sa, float cb, float sb, float cc, float sc, float m[9])
+{
+    sa *= parity;
+    sb *= parity;
+    sc *= parity;
+    m[0] = cb * cc;
+    m[1] = -cb * sc;
+    m[2] = sb;
+    m[3] = ca * sc + sa * sb * cc;
+    m[4] = ca * cc - sa * sb * sc;
+    m[5] = -sa * cb;
+    m[6] = sa * sc - ca * sb * cc;
+    m[7] = sa * cc + ca * sb * sc;
+    m[8] = ca * cb;
+}
 
-Matrix RotationMatrix::ConvertRotationMatrix2RotationVector(const Matrix& mat3_rot)
+void RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z, Mat3& mat3_rot)
 {
-    Matrix vec3 = Matrix(3, 1);
+    const EulerAxes& axes = GetMobileAxes(order);
+    const float angle[3] = { x, y, z };
+    float c[3], s[3];
+    for (int32_t axis = 0; axis < 3; axis++) {
+        SinCos(angle[axis], s[axis], c[axis]);
+    }
+    const int32_t i = axes.axis[0], j = axes.axis[1], k = axes.axis[2];
+    float m[9];
+    EulerMobileClosedForm(axes.parity, c[i], s[i], c[j], s[j], c[k], s[k], m);
+    int32_t elements[9];
+    GetMobileElements(axes, elements);
+    for (int32_t n = 0; n < 9; n++) mat3_rot[elements[n]] = m[n];
+}
 
-    Matrix vec4_axisangle = ConvertRotationMatrix2AxisAngle(mat3_rot);
-    vec3[0] = vec4_axisangle[0] * vec4_axisangle[3];
-    vec3[1] = vec4_axisangle[1] * vec4_axisangle[3];
-    vec3[2] = vec4_axisangle[2] * vec4_axisangle[3];
-    return vec3;
+void RotationMatrix::ConvertEulerFixed2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z, Mat3& mat3_rot)
+{
+    ConvertEulerMobile2RotationMatrix(ReverseOrder(order), x, y, z, mat3_rot);
 }
 
-Matrix RotationMatrix::ConvertRotationMatrix2AxisAngle(const Matrix& mat3_rot)
+
+/* atan is used instead of atan2, which is much slower in libm */
+template<typename MAT3>
+static Vec3 ConvertRotationMatrix2RotationVectorImpl(const MAT3& mat3_rot)
 {
-    Matrix vec4 = Matrix(4, 1);
-    /* http://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToAngle/ */
-    float d = static_cast<float>(std::sqrt(
-        std::pow(mat3_rot(2, 1) - mat3_rot(1, 2), 2)
-        + std::pow(mat3_rot(0, 2) - mat3_rot(2, 0), 2)
-        + std::pow(mat3_rot(1, 0) - mat3_rot(0, 1), 2)
-    ));
-    if (d > 0) {
-        vec4[0] = (mat3_rot(2, 1) - mat3_rot(1, 2)) / d;
-        vec4[1] = (mat3_rot(0, 2) - mat3_rot(2, 0)) / d;
-        vec4[2] = (mat3_rot(1, 0) - mat3_rot(0, 1)) / d;
-        vec4[3] = std::acos((mat3_rot(0, 0) + mat3_rot(1, 1) + mat3_rot(2, 2) - 1) / 2);
+    const float wx = 0.5f * (mat3_rot(2, 1) - mat3_rot(1, 2));
+    const float wy = 0.5f * (mat3_rot(0, 2) - mat3_rot(2, 0));
+    const float wz = 0.5f * (mat3_rot(1, 0) - mat3_rot(0, 1));
+    const float c = 0.5f * (mat3_rot(0, 0) + mat3_rot(1, 1) + mat3_rot(2, 2) - 1.0f);
+    if (c > LOG_NEAR_PI_COS) {
+        const float s2 = wx * wx + wy * wy + wz * wz;
+        float k;
+        if (s2 < LOG_SERIES_N2) {
+            /* rad / sin(rad) = 1 + rad^2 / 6 + 7 rad^4 / 360, rad^2 ~ sin(rad)^2 (c > 0 here) */
+            k = 1.0f + s2 * (1.0f / 6.0f) + s2 * s2 * (7.0f / 360.0f);
+        } else {
+            /* rad = 2 atan(sin(rad) / (1 + cos(rad))) */
+            const float s = std::sqrt(s2);
+            k = 2.0f * Atan(s / (1.0f + c)) / s;
+        }
+        return Vec3({ wx * k, wy * k, wz * k });
     }
-    
-    return vec4;
+
+    /* |q.xyz| is almost 1 here */
+    const Vec4 q = ConvertRotationMatrix2QuaternionImpl(mat3_rot);
+    const float n = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    const float half = static_cast<float>(M_PI / 2) - Atan(std::abs(q[3]) / n);
+    float v[3];
+    LogSO3Elements(q[0], q[1], q[2], q[3], n, half, v);
+    return Vec3({ v[0], v[1], v[2] });
 }
 
-Matrix RotationMatrix::ConvertRotationMatrix2Quaternion(const Matrix& mat3_rot)
+/* The axis is zero for the identity */
+template<typename MAT3>
+static Vec4 ConvertRotationMatrix2AxisAngleImpl(const MAT3& mat3_rot)
+{
+    const Vec3 vec3 = ConvertRotationMatrix2RotationVectorImpl(mat3_rot);
+    const float rad = std::sqrt(vec3[0] * vec3[0] + vec3[1] * vec3[1] + vec3[2] * vec3[2]);
+    if (rad <= 0.0f) return Vec4();
+    return Vec4({ vec3[0] / rad, vec3[1] / rad, vec3[2] / rad, rad });
+}
+
+template<typename MAT3>
+static Vec4 ConvertRotationMatrix2QuaternionImpl(const MAT3& mat3_rot)
 {
     /* http://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToQuaternion/index.htm */
-    Matrix vec4 = Matrix(4, 1);
+    Vec4 vec4;
     
     float tr = mat3_rot(0, 0) + mat3_rot(1, 1) + mat3_rot(2, 2);
     if (tr > 0) {
@@ -262,137 +489,140 @@ Matrix RotationMatrix::ConvertRotationMatrix2Quaternion(const Matrix& mat3_rot)
     return vec4;
 }
 
-Matrix RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const Matrix& mat3_rot)
+template<typename MAT3>
+static Vec3 ConvertRotationMatrix2EulerMobileImpl(RotationMatrix::EULER_ORDER order, const MAT3& mat3_rot)
 {
     /* https://github.com/mrdoob/three.js/blob/cab469bc0dad1f79b83a7b8c3c51dcf9d7291622/src/math/Euler.js#L104 */
-    Matrix vec3 = Matrix(3, 1);
+    Vec3 vec3;
     switch (order) {
-    case EULER_ORDER::XYZ:
-        vec3[1] = std::asin(clamp_one(mat3_rot(0, 2)));
+    case RotationMatrix::EULER_ORDER::XYZ:
+        vec3[1] = Asin(clamp_one(mat3_rot(0, 2)));
         if (std::abs(mat3_rot(0, 2)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(0, 0));
+            vec3[0] = Atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(0, 0));
         } else {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(1, 1));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(1, 1));
             vec3[2] = 0;
         }
         break;
-    case EULER_ORDER::XZY:
-        vec3[2] = std::asin(clamp_one(-mat3_rot(0, 1)));
+    case RotationMatrix::EULER_ORDER::XZY:
+        vec3[2] = Asin(clamp_one(-mat3_rot(0, 1)));
         if (std::abs(mat3_rot(0, 1)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(1, 1));
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(0, 0));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(1, 1));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[1] = std::atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
+            vec3[1] = Atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
         }
         break;
         break;
-    case EULER_ORDER::YXZ:
-        vec3[0] = std::asin(clamp_one(-mat3_rot(1, 2)));
+    case RotationMatrix::EULER_ORDER::YXZ:
+        vec3[0] = Asin(clamp_one(-mat3_rot(1, 2)));
         if (std::abs(mat3_rot(1, 2)) < ALMOST_ONE) {
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(2, 2));
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(1, 1));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(2, 2));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(1, 1));
         } else {
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
             vec3[2] = 0;
         }
         break;
-    case EULER_ORDER::YZX:
-        vec3[2] = std::asin(clamp_one(mat3_rot(1, 0)));
+    case RotationMatrix::EULER_ORDER::YZX:
+        vec3[2] = Asin(clamp_one(mat3_rot(1, 0)));
         if (std::abs(mat3_rot(1, 0)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(-mat3_rot(1, 2), mat3_rot(1, 1));
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
+            vec3[0] = Atan2(-mat3_rot(1, 2), mat3_rot(1, 1));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(2, 2));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(2, 2));
         }
         break;
-    case EULER_ORDER::ZXY:
-        vec3[0] = std::asin(clamp_one(mat3_rot(2, 1)));
+    case RotationMatrix::EULER_ORDER::ZXY:
+        vec3[0] = Asin(clamp_one(mat3_rot(2, 1)));
         if (std::abs(mat3_rot(2, 1)) < ALMOST_ONE) {
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(2, 2));
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(2, 2));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
         } else {
             vec3[1] = 0;
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(0, 0));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(0, 0));
         }
         break;
-    case EULER_ORDER::ZYX:
-        vec3[1] = std::asin(clamp_one(-mat3_rot(2, 0)));
+    case RotationMatrix::EULER_ORDER::ZYX:
+        vec3[1] = Asin(clamp_one(-mat3_rot(2, 0)));
         if (std::abs(mat3_rot(2, 0)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(2, 2));
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(0, 0));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(2, 2));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
         }
         break;
     }
     return vec3;
 }
-Matrix RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const Matrix& mat3_rot)
+
+template<typename MAT3>
+static Vec3 ConvertRotationMatrix2EulerFixedImpl(RotationMatrix::EULER_ORDER order, const MAT3& mat3_rot)
 {
     /* https://github.com/mrdoob/three.js/blob/cab469bc0dad1f79b83a7b8c3c51dcf9d7291622/src/math/Euler.js#L104 */
-    Matrix vec3 = Matrix(3, 1);
+    Vec3 vec3;
     switch (order) {
-    case EULER_ORDER::XYZ:
-        vec3[1] = std::asin(clamp_one(-mat3_rot(2, 0)));
+    case RotationMatrix::EULER_ORDER::XYZ:
+        vec3[1] = Asin(clamp_one(-mat3_rot(2, 0)));
         if (std::abs(mat3_rot(2, 0)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(2, 2));
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(0, 0));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(2, 2));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
         }
         break;
-    case EULER_ORDER::XZY:
-        vec3[2] = std::asin(clamp_one(mat3_rot(1, 0)));
+    case RotationMatrix::EULER_ORDER::XZY:
+        vec3[2] = Asin(clamp_one(mat3_rot(1, 0)));
         if (std::abs(mat3_rot(1, 0)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(-mat3_rot(1, 2), mat3_rot(1, 1));
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
+            vec3[0] = Atan2(-mat3_rot(1, 2), mat3_rot(1, 1));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(2, 2));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(2, 2));
         }
         break;
-    case EULER_ORDER::YXZ:
-        vec3[0] = std::asin(clamp_one(mat3_rot(2, 1)));
+    case RotationMatrix::EULER_ORDER::YXZ:
+        vec3[0] = Asin(clamp_one(mat3_rot(2, 1)));
         if (std::abs(mat3_rot(2, 1)) < ALMOST_ONE) {
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(2, 2));
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(2, 2));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(1, 1));
         } else {
             vec3[1] = 0;
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(0, 0));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(0, 0));
         }
         break;
-    case EULER_ORDER::YZX:
-        vec3[2] = std::asin(clamp_one(-mat3_rot(0, 1)));
+    case RotationMatrix::EULER_ORDER::YZX:
+        vec3[2] = Asin(clamp_one(-mat3_rot(0, 1)));
         if (std::abs(mat3_rot(0, 1)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(1, 1));
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(0, 0));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(1, 1));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(0, 0));
         } else {
             vec3[0] = 0;
-            vec3[1] = std::atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
+            vec3[1] = Atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
         }
         break;
-    case EULER_ORDER::ZXY:
-        vec3[0] = std::asin(clamp_one(-mat3_rot(1, 2)));
+    case RotationMatrix::EULER_ORDER::ZXY:
+        vec3[0] = Asin(clamp_one(-mat3_rot(1, 2)));
         if (std::abs(mat3_rot(1, 2)) < ALMOST_ONE) {
-            vec3[1] = std::atan2(mat3_rot(0, 2), mat3_rot(2, 2));
-            vec3[2] = std::atan2(mat3_rot(1, 0), mat3_rot(1, 1));
+            vec3[1] = Atan2(mat3_rot(0, 2), mat3_rot(2, 2));
+            vec3[2] = Atan2(mat3_rot(1, 0), mat3_rot(1, 1));
         } else {
-            vec3[1] = std::atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
+            vec3[1] = Atan2(-mat3_rot(2, 0), mat3_rot(0, 0));
             vec3[2] = 0;
         }
         break;
-    case EULER_ORDER::ZYX:
-        vec3[1] = std::asin(clamp_one(mat3_rot(0, 2)));
+    case RotationMatrix::EULER_ORDER::ZYX:
+        vec3[1] = Asin(clamp_one(mat3_rot(0, 2)));
         if (std::abs(mat3_rot(0, 2)) < ALMOST_ONE) {
-            vec3[0] = std::atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
-            vec3[2] = std::atan2(-mat3_rot(0, 1), mat3_rot(0, 0));
+            vec3[0] = Atan2(-mat3_rot(1, 2), mat3_rot(2, 2));
+            vec3[2] = Atan2(-mat3_rot(0, 1), mat3_rot(0, 0));
         } else {
-            vec3[0] = std::atan2(mat3_rot(2, 1), mat3_rot(1, 1));
+            vec3[0] = Atan2(mat3_rot(2, 1), mat3_rot(1, 1));
             vec3[2] = 0;
         }
         break;
@@ -400,6 +630,628 @@ Matrix RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_OR
     return vec3;
 }
 
+/* How to decompose a rotation matrix into mobile euler angles. This is the same as ConvertRotationMatrix2EulerMobileImpl written as a table.
+ * Elements are indexed by row * 3 + col, and angles by 0 = x, 1 = y, 2 = z.
+ * The middle angle is asin of an element. The others are atan2 of two elements.
+ * In gimbal lock (|element of asin| >= ALMOST_ONE), one of them is atan2 of other two elements, and the other is 0 */
+struct EulerAtan2 {
+    int32_t angle;
+    int32_t y;
+    float y_sign;
+    int32_t x;
+};
+
+struct EulerDecomposition {
+    int32_t mid_angle;
+    int32_t mid;
+    float mid_sign;
+    EulerAtan2 regular[2];
+    EulerAtan2 gimbal;
+};
+
+static const EulerDecomposition& GetMobileDecomposition(RotationMatrix::EULER_ORDER order)
+{
+    static constexpr EulerDecomposition DECOMPOSITION[6] = {
+        /* XYZ */ { 1, 2, 1.0f, { { 0, 5, -1.0f, 8 }, { 2, 1, -1.0f, 0 } }, { 0, 7, 1.0f, 4 } },
+        /* XZY */ { 2, 1, -1.0f, { { 0, 7, 1.0f, 4 }, { 1, 2, 1.0f, 0 } }, { 1, 5, -1.0f, 8 } },
+        /* YXZ */ { 0, 5, -1.0f, { { 1, 2, 1.0f, 8 }, { 2, 3, 1.0f, 4 } }, { 1, 6, -1.0f, 0 } },
+        /* YZX */ { 2, 3, 1.0f, { { 0, 5, -1.0f, 4 }, { 1, 6, -1.0f, 0 } }, { 1, 2, 1.0f, 8 } },
+        /* ZXY */ { 0, 7, 1.0f, { { 1, 6, -1.0f, 8 }, { 2, 1, -1.0f, 4 } }, { 2, 3, 1.0f, 0 } },
+        /* ZYX */ { 1, 6, -1.0f, { { 0, 7, 1.0f, 8 }, { 2, 3, 1.0f, 0 } }, { 2, 1, -1.0f, 4 } },
+    };
+    return DECOMPOSITION[static_cast<int32_t>(order)];
+}
+
+/* Distinct asin / atan2 terms used by the decomposition of all the orders.
+ * asin and atan2 (about y) are odd functions, so that the sign in the table is applied to the result instead of the input,
+ * and e.g. atan2(-m12, m22) of XYZ and atan2(m12, m22) of other orders share the same term */
+static constexpr int32_t EULER_ASIN_TERM_MAX = 6;
+static constexpr int32_t EULER_ATAN2_TERM_MAX = 6 * 3;
+struct EulerTerms {
+    int32_t asin_num;
+    int32_t asin_element[EULER_ASIN_TERM_MAX];
+    int32_t atan2_num;
+    int32_t atan2_y[EULER_ATAN2_TERM_MAX];
+    int32_t atan2_x[EULER_ATAN2_TERM_MAX];
+    /* Index of the terms used by each order */
+    int32_t mid[6];
+    int32_t regular[6][2];
+    int32_t gimbal[6];
+};
+
+static int32_t FindOrAddTerm(int32_t& num, int32_t* y, int32_t* x, int32_t y_value, int32_t x_value)
+{
+    for (int32_t i = 0; i < num; i++) {
+        if (y[i] == y_value && (x == nullptr || x[i] == x_value)) return i;
+    }
+    y[num] = y_value;
+    if (x) x[num] = x_value;
+    return num++;
+}
+
+static EulerTerms MakeEulerTerms()
+{
+    EulerTerms terms = {};
+    for (int32_t order = 0; order < 6; order++) {
+        const EulerDecomposition& decomposition = GetMobileDecomposition(static_cast<RotationMatrix::EULER_ORDER>(order));
+        terms.mid[order] = FindOrAddTerm(terms.asin_num, terms.asin_element, nullptr, decomposition.mid, 0);
+        for (int32_t r = 0; r < 2; r++) {
+            terms.regular[order][r] = FindOrAddTerm(terms.atan2_num, terms.atan2_y, terms.atan2_x, decomposition.regular[r].y, decomposition.regular[r].x);
+        }
+        terms.gimbal[order] = FindOrAddTerm(terms.atan2_num, terms.atan2_y, terms.atan2_x, decomposition.gimbal.y, decomposition.gimbal.x);
+    }
+    return terms;
+}
+
+static const EulerTerms& GetEulerTerms()
+{
+    static const EulerTerms terms = MakeEulerTerms();
+    return terms;
+}
+
+/* Make euler angles of an order from the terms. In gimbal lock, the angle which is not calculated by the gimbal term is 0 */
+static void ComposeEuler(int32_t order, const float* asin_term, const float* atan2_term, bool is_gimbal_lock, float* angle)
+{
+    const EulerTerms& terms = GetEulerTerms();
+    const EulerDecomposition& decomposition = GetMobileDecomposition(static_cast<RotationMatrix::EULER_ORDER>(order));
+    angle[decomposition.mid_angle] = decomposition.mid_sign * asin_term[terms.mid[order]];
+    for (int32_t r = 0; r < 2; r++) {
+        const EulerAtan2& regular = decomposition.regular[r];
+        if (!is_gimbal_lock) {
+            angle[regular.angle] = regular.y_sign * atan2_term[terms.regular[order][r]];
+        } else if (regular.angle == decomposition.gimbal.angle) {
+            angle[regular.angle] = decomposition.gimbal.y_sign * atan2_term[terms.gimbal[order]];
+        } else {
+            angle[regular.angle] = 0;
+        }
+    }
+}
+
+template<typename MAT3>
+static void DecomposeAllEulerImpl(const MAT3& mat3_rot, Vec3 (&mobile)[6], Vec3 (&fixed)[6])
+{
+    const EulerTerms& terms = GetEulerTerms();
+    float asin_term[EULER_ASIN_TERM_MAX];
+    float atan2_term[EULER_ATAN2_TERM_MAX];
+    for (int32_t i = 0; i < terms.asin_num; i++) {
+        const int32_t e = terms.asin_element[i];
+        asin_term[i] = Asin(clamp_one(mat3_rot(e / 3, e % 3)));
+    }
+    for (int32_t i = 0; i < terms.atan2_num; i++) {
+        const int32_t y = terms.atan2_y[i];
+        const int32_t x = terms.atan2_x[i];
+        atan2_term[i] = Atan2(mat3_rot(y / 3, y % 3), mat3_rot(x / 3, x % 3));
+    }
+    for (int32_t order = 0; order < 6; order++) {
+        const int32_t mid = GetMobileDecomposition(static_cast<RotationMatrix::EULER_ORDER>(order)).mid;
+        const bool is_gimbal_lock = std::abs(mat3_rot(mid / 3, mid % 3)) >= ALMOST_ONE;
+        ComposeEuler(order, asin_term, atan2_term, is_gimbal_lock, mobile[order].Data());
+    }
+    for (int32_t order = 0; order < 6; order++) {
+        fixed[order] = mobile[static_cast<int32_t>(ReverseOrder(static_cast<RotationMatrix::EULER_ORDER>(order)))];
+    }
+}
+
+/* Functions taking a 3x3 matrix work with Mat3, Matrix and views in the same way */
+static void CheckShape3x3(int32_t rows, int32_t cols)
+{
+    if (rows != 3 || cols != 3) throw std::out_of_range("Invalid shape");
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2RotationVector(const Mat3& mat3_rot)
+{
+    return ConvertRotationMatrix2RotationVectorImpl(mat3_rot);
+}
+
+Vec4 RotationMatrix::ConvertRotationMatrix2AxisAngle(const Mat3& mat3_rot)
+{
+    return ConvertRotationMatrix2AxisAngleImpl(mat3_rot);
+}
+
+Vec4 RotationMatrix::ConvertRotationMatrix2Quaternion(const Mat3& mat3_rot)
+{
+    return ConvertRotationMatrix2QuaternionImpl(mat3_rot);
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const Mat3& mat3_rot)
+{
+    return ConvertRotationMatrix2EulerMobileImpl(order, mat3_rot);
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const Mat3& mat3_rot)
+{
+    return ConvertRotationMatrix2EulerFixedImpl(order, mat3_rot);
+}
+
+void RotationMatrix::DecomposeAllEuler(const Mat3& mat3_rot, Vec3 (&mobile)[6], Vec3 (&fixed)[6])
+{
+    DecomposeAllEulerImpl(mat3_rot, mobile, fixed);
+}
+
+/* Functions for views. The elements are read directly from the original matrix */
+Mat3 RotationMatrix::NormalizeRotationMatrix(const ConstMatrixView& mat3_rot, NORMALIZE_METHOD method)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return NormalizeRotationMatrixImpl(mat3_rot, method);
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2RotationVector(const ConstMatrixView& mat3_rot)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return ConvertRotationMatrix2RotationVectorImpl(mat3_rot);
+}
+
+Vec4 RotationMatrix::ConvertRotationMatrix2AxisAngle(const ConstMatrixView& mat3_rot)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return ConvertRotationMatrix2AxisAngleImpl(mat3_rot);
+}
+
+Vec4 RotationMatrix::ConvertRotationMatrix2Quaternion(const ConstMatrixView& mat3_rot)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return ConvertRotationMatrix2QuaternionImpl(mat3_rot);
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const ConstMatrixView& mat3_rot)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return ConvertRotationMatrix2EulerMobileImpl(order, mat3_rot);
+}
+
+Vec3 RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const ConstMatrixView& mat3_rot)
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    return ConvertRotationMatrix2EulerFixedImpl(order, mat3_rot);
+}
+
+void RotationMatrix::DecomposeAllEuler(const ConstMatrixView& mat3_rot, Vec3 (&mobile)[6], Vec3 (&fixed)[6])
+{
+    CheckShape3x3(mat3_rot.Rows(), mat3_rot.Cols());
+    DecomposeAllEulerImpl(mat3_rot, mobile, fixed);
+}
+
+/*** Batch functions ***/
+/* Rotations are processed in blocks. sin/cos, asin and atan2 of a block are calculated by the SIMD kernel (RotationKernel),
+ * then the rest is a simple arithmetic loop over the block without branches, so that the compiler can vectorize it.
+ * The result of a block is calculated into a local buffer, which is known not to alias the input, and then copied to the output */
+static constexpr int32_t BATCH_BLOCK_SIZE = 256;
+using Mat3Block = float[9][BATCH_BLOCK_SIZE];
+
+static void StoreBlock(const Mat3Block& block, int32_t count, float* mat3_rot, int32_t num)
+{
+    for (int32_t k = 0; k < 9; k++) {
+        std::copy(block[k], block[k] + count, mat3_rot + static_cast<size_t>(k) * num);
+    }
+}
+
+/* Same as ConvertAxisAngle2RotationMatrix. The axis doesn't need to be normalized */
+static void AxisAngleBlock(const float* x, const float* y, const float* z, const float* c, const float* s, int32_t count, Mat3Block& m)
+{
+    for (int32_t i = 0; i < count; i++) {
+        const float d = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        /* identity if the axis is zero. Blend by arithmetic instead of branches (the axis stays zero, so adding 1 to d is fine) */
+        const float is_zero = (d > 0.0f) ? 0.0f : 1.0f;
+        const float inv_d = 1.0f / (d + is_zero);
+        const float xn = x[i] * inv_d;
+        const float yn = y[i] * inv_d;
+        const float zn = z[i] * inv_d;
+        const float ci = c[i] * (1.0f - is_zero) + is_zero;
+        const float si = s[i] * (1.0f - is_zero);
+        const float t = 1.0f - ci;
+        m[0][i] = t * xn * xn + ci;
+        m[1][i] = t * xn * yn - zn * si;
+        m[2][i] = t * xn * zn + yn * si;
+        m[3][i] = t * xn * yn + zn * si;
+        m[4][i] = t * yn * yn + ci;
+        m[5][i] = t * yn * zn - xn * si;
+        m[6][i] = t * xn * zn - yn * si;
+        m[7][i] = t * yn * zn + xn * si;
+        m[8][i] = t * zn * zn + ci;
+    }
+}
+
+void RotationMatrix::ConvertRotationVectors2RotationMatrices(const float* x_rad, const float* y_rad, const float* z_rad, int32_t num, float* mat3_rot)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    float rad2[BATCH_BLOCK_SIZE];
+    float half[BATCH_BLOCK_SIZE];
+    float c_half[BATCH_BLOCK_SIZE];
+    float s_half[BATCH_BLOCK_SIZE];
+    Mat3Block block;
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        const float* x = x_rad + offset;
+        const float* y = y_rad + offset;
+        const float* z = z_rad + offset;
+        for (int32_t i = 0; i < count; i++) {
+            rad2[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            half[i] = 0.5f * std::sqrt(rad2[i]);
+        }
+        kernel.sincos(half, count, s_half, c_half);
+        for (int32_t i = 0; i < count; i++) {
+            float a, b;
+            ExpSO3Coefficients(rad2[i], s_half[i], c_half[i], a, b);
+            float m[9];
+            ExpSO3Elements(x[i], y[i], z[i], a, b, m);
+            for (int32_t k = 0; k < 9; k++) block[k][i] = m[k];
+        }
+        StoreBlock(block, count, mat3_rot + offset, num);
+    }
+}
+
+void RotationMatrix::ConvertAxisAngles2RotationMatrices(const float* x, const float* y, const float* z, const float* rad, int32_t num, float* mat3_rot)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    float c[BATCH_BLOCK_SIZE];
+    float s[BATCH_BLOCK_SIZE];
+    Mat3Block block;
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        kernel.sincos(rad + offset, count, s, c);
+        AxisAngleBlock(x + offset, y + offset, z + offset, c, s, count, block);
+        StoreBlock(block, count, mat3_rot + offset, num);
+    }
+}
+
+void RotationMatrix::ConvertQuaternions2RotationMatrices(const float* x, const float* y, const float* z, const float* w, int32_t num, float* mat3_rot)
+{
+    RotationKernel::Get().quaternion_to_matrix(x, y, z, w, num, mat3_rot, num);
+}
+
+void RotationMatrix::ConvertEulerMobiles2RotationMatrices(RotationMatrix::EULER_ORDER order, const float* x, const float* y, const float* z, int32_t num, float* mat3_rot)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    const EulerAxes& axes = GetMobileAxes(order);
+    int32_t elements[9];
+    GetMobileElements(axes, elements);
+    const float* angle[3] = { x, y, z };
+    float c[3][BATCH_BLOCK_SIZE];
+    float s[3][BATCH_BLOCK_SIZE];
+    Mat3Block block;
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        for (int32_t axis = 0; axis < 3; axis++) {
+            kernel.sincos(angle[axis] + offset, count, s[axis], c[axis]);
+        }
+
+        /* block holds the values in the order of EulerMobileClosedForm, and they are placed when stored */
+        const float* ca = c[axes.axis[0]];
+        const float* sa = s[axes.axis[0]];
+        const float* cb = c[axes.axis[1]];
+        const float* sb = s[axes.axis[1]];
+        const float* cc = c[axes.axis[2]];
+        const float* sc = s[axes.axis[2]];
+        for (int32_t i = 0; i < count; i++) {
+            float m[9];
+            EulerMobileClosedForm(axes.parity, ca[i], sa[i], cb[i], sb[i], cc[i], sc[i], m);
+            for (int32_t n = 0; n < 9; n++) block[n][i] = m[n];
+        }
+        for (int32_t n = 0; n < 9; n++) {
+            std::copy(block[n], block[n] + count, mat3_rot + static_cast<size_t>(elements[n]) * num + offset);
+        }
+    }
+}
+
+void RotationMatrix::ConvertEulerFixeds2RotationMatrices(RotationMatrix::EULER_ORDER order, const float* x, const float* y, const float* z, int32_t num, float* mat3_rot)
+{
+    ConvertEulerMobiles2RotationMatrices(ReverseOrder(order), x, y, z, num, mat3_rot);
+}
+
+/* Rotation vectors of count matrices from offset */
+static void LogSO3Block(const RotationKernel::Kernel& kernel, const float* mat3_rot, int32_t num, int32_t offset, int32_t count, float* x, float* y, float* z)
+{
+    float qx[BATCH_BLOCK_SIZE];
+    float qy[BATCH_BLOCK_SIZE];
+    float qz[BATCH_BLOCK_SIZE];
+    float qw[BATCH_BLOCK_SIZE];
+    float n[BATCH_BLOCK_SIZE];
+    float abs_w[BATCH_BLOCK_SIZE];
+    float half[BATCH_BLOCK_SIZE];
+    kernel.matrix_to_quaternion(mat3_rot + offset, num, count, qx, qy, qz, qw);
+    for (int32_t i = 0; i < count; i++) {
+        n[i] = std::sqrt(qx[i] * qx[i] + qy[i] * qy[i] + qz[i] * qz[i]);
+        abs_w[i] = std::abs(qw[i]);
+    }
+    kernel.atan2(n, abs_w, count, half);
+    for (int32_t i = 0; i < count; i++) {
+        float v[3];
+        LogSO3Elements(qx[i], qy[i], qz[i], qw[i], n[i], half[i], v);
+        x[i] = v[0];
+        y[i] = v[1];
+        z[i] = v[2];
+    }
+}
+
+void RotationMatrix::ConvertRotationMatrices2RotationVectors(const float* mat3_rot, int32_t num, float* x_rad, float* y_rad, float* z_rad)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        LogSO3Block(kernel, mat3_rot, num, offset, count, x_rad + offset, y_rad + offset, z_rad + offset);
+    }
+}
+
+void RotationMatrix::ConvertRotationMatrices2AxisAngles(const float* mat3_rot, int32_t num, float* x, float* y, float* z, float* rad)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        float* xo = x + offset;
+        float* yo = y + offset;
+        float* zo = z + offset;
+        float* rado = rad + offset;
+        LogSO3Block(kernel, mat3_rot, num, offset, count, xo, yo, zo);
+        for (int32_t i = 0; i < count; i++) {
+            rado[i] = std::sqrt(xo[i] * xo[i] + yo[i] * yo[i] + zo[i] * zo[i]);
+            /* the axis is zero for the identity */
+            const float is_zero = (rado[i] > 0.0f) ? 0.0f : 1.0f;
+            const float inv_rad = (1.0f - is_zero) / (rado[i] + is_zero);
+            xo[i] *= inv_rad;
+            yo[i] *= inv_rad;
+            zo[i] *= inv_rad;
+        }
+    }
+}
+
+/* The 4 cases by the trace are selected without branches in the kernel */
+void RotationMatrix::ConvertRotationMatrices2Quaternions(const float* mat3_rot, int32_t num, float* x, float* y, float* z, float* w)
+{
+    RotationKernel::Get().matrix_to_quaternion(mat3_rot, num, num, x, y, z, w);
+}
+
+static void Atan2Block(const RotationKernel::Kernel& kernel, const EulerAtan2& atan2, const float* const (&m)[9], int32_t count, float* angle)
+{
+    float y[BATCH_BLOCK_SIZE];
+    for (int32_t i = 0; i < count; i++) y[i] = atan2.y_sign * m[atan2.y][i];
+    kernel.atan2(y, m[atan2.x], count, angle);
+}
+
+void RotationMatrix::ConvertRotationMatrices2EulerMobiles(RotationMatrix::EULER_ORDER order, const float* mat3_rot, int32_t num, float* x, float* y, float* z)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    const EulerDecomposition& decomposition = GetMobileDecomposition(order);
+    float* angle[3] = { x, y, z };
+    float value[BATCH_BLOCK_SIZE];
+    float regular[2][BATCH_BLOCK_SIZE];
+    float gimbal[BATCH_BLOCK_SIZE];
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        const float* m[9];
+        for (int32_t k = 0; k < 9; k++) m[k] = mat3_rot + static_cast<size_t>(k) * num + offset;
+
+        for (int32_t i = 0; i < count; i++) {
+            const float v = decomposition.mid_sign * m[decomposition.mid][i];
+            value[i] = clamp_one(v);
+        }
+        kernel.asin(value, count, angle[decomposition.mid_angle] + offset);
+        Atan2Block(kernel, decomposition.regular[0], m, count, regular[0]);
+        Atan2Block(kernel, decomposition.regular[1], m, count, regular[1]);
+        Atan2Block(kernel, decomposition.gimbal, m, count, gimbal);
+
+        for (int32_t r = 0; r < 2; r++) {
+            const float* gimbal_angle = (decomposition.regular[r].angle == decomposition.gimbal.angle) ? gimbal : nullptr;
+            float* out = angle[decomposition.regular[r].angle] + offset;
+            for (int32_t i = 0; i < count; i++) {
+                const bool is_gimbal_lock = std::abs(m[decomposition.mid][i]) >= ALMOST_ONE;
+                const float angle_in_gimbal_lock = gimbal_angle ? gimbal_angle[i] : 0.0f;
+                out[i] = is_gimbal_lock ? angle_in_gimbal_lock : regular[r][i];
+            }
+        }
+    }
+}
+
+void RotationMatrix::ConvertRotationMatrices2EulerFixeds(RotationMatrix::EULER_ORDER order, const float* mat3_rot, int32_t num, float* x, float* y, float* z)
+{
+    ConvertRotationMatrices2EulerMobiles(ReverseOrder(order), mat3_rot, num, x, y, z);
+}
+
+void RotationMatrix::DecomposeAllEulers(const float* mat3_rot, int32_t num, float* mobile, float* fixed)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    const EulerTerms& terms = GetEulerTerms();
+    float value[BATCH_BLOCK_SIZE];
+    float asin_term[EULER_ASIN_TERM_MAX][BATCH_BLOCK_SIZE];
+    float atan2_term[EULER_ATAN2_TERM_MAX][BATCH_BLOCK_SIZE];
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        const float* m[9];
+        for (int32_t k = 0; k < 9; k++) m[k] = mat3_rot + static_cast<size_t>(k) * num + offset;
+
+        for (int32_t t = 0; t < terms.asin_num; t++) {
+            const float* element = m[terms.asin_element[t]];
+            for (int32_t i = 0; i < count; i++) {
+                value[i] = clamp_one(element[i]);
+            }
+            kernel.asin(value, count, asin_term[t]);
+        }
+        for (int32_t t = 0; t < terms.atan2_num; t++) {
+            kernel.atan2(m[terms.atan2_y[t]], m[terms.atan2_x[t]], count, atan2_term[t]);
+        }
+
+        for (int32_t order = 0; order < 6; order++) {
+            const EulerDecomposition& decomposition = GetMobileDecomposition(static_cast<RotationMatrix::EULER_ORDER>(order));
+            float* angle[3];
+            for (int32_t a = 0; a < 3; a++) angle[a] = mobile + static_cast<size_t>(order * 3 + a) * num + offset;
+
+            const float* mid = asin_term[terms.mid[order]];
+            for (int32_t i = 0; i < count; i++) {
+                angle[decomposition.mid_angle][i] = decomposition.mid_sign * mid[i];
+            }
+            for (int32_t r = 0; r < 2; r++) {
+                const EulerAtan2& regular = decomposition.regular[r];
+                const float* regular_term = atan2_term[terms.regular[order][r]];
+                const bool has_gimbal = regular.angle == decomposition.gimbal.angle;
+                const float* gimbal_term = atan2_term[terms.gimbal[order]];
+                const float gimbal_sign = has_gimbal ? decomposition.gimbal.y_sign : 0.0f;
+                float* out = angle[regular.angle];
+                for (int32_t i = 0; i < count; i++) {
+                    const bool is_gimbal_lock = std::abs(m[decomposition.mid][i]) >= ALMOST_ONE;
+                    out[i] = is_gimbal_lock ? gimbal_sign * gimbal_term[i] : regular.y_sign * regular_term[i];
+                }
+            }
+        }
+    }
+
+    /* Fixed angles are the same as mobile angles in the reversed order */
+    for (int32_t order = 0; order < 6; order++) {
+        const int32_t reversed = static_cast<int32_t>(ReverseOrder(static_cast<RotationMatrix::EULER_ORDER>(order)));
+        std::copy(mobile + static_cast<size_t>(reversed * 3) * num, mobile + static_cast<size_t>(reversed * 3 + 3) * num, fixed + static_cast<size_t>(order * 3) * num);
+    }
+}
+
+static void LoadBlock(const float* mat3_rot, int32_t num, int32_t count, Mat3Block& block)
+{
+    for (int32_t k = 0; k < 9; k++) {
+        const float* plane = mat3_rot + static_cast<size_t>(k) * num;
+        std::copy(plane, plane + count, block[k]);
+    }
+}
+
+/* The quaternion method runs on the kernel. The others are the same as a single matrix on the block.
+ * The polar iteration stops when all the matrices in the block have converged */
+void RotationMatrix::NormalizeRotationMatrices(float* mat3_rot, int32_t num, NORMALIZE_METHOD method)
+{
+    const RotationKernel::Kernel& kernel = RotationKernel::Get();
+    float q[4][BATCH_BLOCK_SIZE];
+    float change2[BATCH_BLOCK_SIZE];
+    Mat3Block block;
+    for (int32_t offset = 0; offset < num; offset += BATCH_BLOCK_SIZE) {
+        const int32_t count = std::min(BATCH_BLOCK_SIZE, num - offset);
+        if (method == NORMALIZE_METHOD::GRAM_SCHMIDT) {
+            LoadBlock(mat3_rot + offset, num, count, block);
+            for (int32_t i = 0; i < count; i++) {
+                float m[9];
+                for (int32_t k = 0; k < 9; k++) m[k] = block[k][i];
+                GramSchmidtElements(m);
+                for (int32_t k = 0; k < 9; k++) block[k][i] = m[k];
+            }
+            StoreBlock(block, count, mat3_rot + offset, num);
+        } else if (method == NORMALIZE_METHOD::POLAR) {
+            LoadBlock(mat3_rot + offset, num, count, block);
+            for (int32_t iteration = 0; iteration < POLAR_MAX_ITERATION; iteration++) {
+                for (int32_t i = 0; i < count; i++) {
+                    float m[9];
+                    for (int32_t k = 0; k < 9; k++) m[k] = block[k][i];
+                    change2[i] = PolarStepElements(m);
+                    for (int32_t k = 0; k < 9; k++) block[k][i] = m[k];
+                }
+                if (*std::max_element(change2, change2 + count) < POLAR_CONVERGED_CHANGE2) break;
+            }
+            StoreBlock(block, count, mat3_rot + offset, num);
+        } else {
+            kernel.matrix_to_quaternion(mat3_rot + offset, num, count, q[0], q[1], q[2], q[3]);
+            kernel.quaternion_to_matrix(q[0], q[1], q[2], q[3], count, mat3_rot + offset, num);
+        }
+    }
+}
+
+/* Functions for dynamic-size Matrix. These are just wrappers of the fixed-size version */
+Matrix RotationMatrix::RotateX(float rad)
+{
+    Mat3 mat3_rot;
+    RotateX(rad, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::RotateY(float rad)
+{
+    Mat3 mat3_rot;
+    RotateY(rad, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::RotateZ(float rad)
+{
+    Mat3 mat3_rot;
+    RotateZ(rad, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::NormalizeRotationMatrix(const Matrix mat3_rot, NORMALIZE_METHOD method)
+{
+    return static_cast<Matrix>(NormalizeRotationMatrix(mat3_rot.View(), method));
+}
+
+Matrix RotationMatrix::ConvertAxisAngle2RotationMatrix(float x, float y, float z, float rad)
+{
+    Mat3 mat3_rot;
+    ConvertAxisAngle2RotationMatrix(x, y, z, rad, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::ConvertRotationVector2RotationMatrix(float x_rad, float y_rad, float z_rad)
+{
+    Mat3 mat3_rot;
+    ConvertRotationVector2RotationMatrix(x_rad, y_rad, z_rad, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::ConvertQuaternion2RotationMatrix(float x, float y, float z, float w)
+{
+    Mat3 mat3_rot;
+    ConvertQuaternion2RotationMatrix(x, y, z, w, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+{
+    Mat3 mat3_rot;
+    ConvertEulerMobile2RotationMatrix(order, x, y, z, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::ConvertEulerFixed2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z)
+{
+    Mat3 mat3_rot;
+    ConvertEulerFixed2RotationMatrix(order, x, y, z, mat3_rot);
+    return static_cast<Matrix>(mat3_rot);
+}
+
+Matrix RotationMatrix::ConvertRotationMatrix2RotationVector(const Matrix& mat3_rot)
+{
+    return static_cast<Matrix>(ConvertRotationMatrix2RotationVector(mat3_rot.View()));
+}
+
+Matrix RotationMatrix::ConvertRotationMatrix2AxisAngle(const Matrix& mat3_rot)
+{
+    return static_cast<Matrix>(ConvertRotationMatrix2AxisAngle(mat3_rot.View()));
+}
+
+Matrix RotationMatrix::ConvertRotationMatrix2Quaternion(const Matrix& mat3_rot)
+{
+    return static_cast<Matrix>(ConvertRotationMatrix2Quaternion(mat3_rot.View()));
+}
+
+Matrix RotationMatrix::ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const Matrix& mat3_rot)
+{
+    return static_cast<Matrix>(ConvertRotationMatrix2EulerMobile(order, mat3_rot.View()));
+}
+
+Matrix RotationMatrix::ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const Matrix& mat3_rot)
+{
+    return static_cast<Matrix>(ConvertRotationMatrix2EulerFixed(order, mat3_rot.View()));
+}
 
 /* Note: xyz is not on OpenGL coordinate */
 Matrix RotationMatrix::ConvertXYZ2PolarCoordinate(float x, float y, float z)
@@ -408,9 +1260,9 @@ Matrix RotationMatrix::ConvertXYZ2PolarCoordinate(float x, float y, float z)
     float r = std::sqrt(x * x + y * y + z * z);
     if (r == 0) return vec3;
     float theta_rad = 0;
-    theta_rad = std::acos(z / r);
+    theta_rad = Acos(z / r);
     float phi_rad = 0;
-    phi_rad = std::acos(x / std::sqrt(x * x + y * y));
+    phi_rad = Acos(x / std::sqrt(x * x + y * y));
     if (y < 0) phi_rad *= -1;
     vec3[0] = r;
     vec3[1] = theta_rad;
@@ -422,9 +1274,12 @@ Matrix RotationMatrix::ConvertXYZ2PolarCoordinate(float x, float y, float z)
 Matrix RotationMatrix::ConvertPolarCoordinate2XYZ(float r, float theta_rad, float phi_rad)
 {
     Matrix vec3 = Matrix(3, 1);
-    float x = r * std::sin(theta_rad) * std::cos(phi_rad);
-    float y = r * std::sin(theta_rad) * std::sin(phi_rad);
-    float z = r * std::cos(theta_rad);
+    float s_theta, c_theta, s_phi, c_phi;
+    SinCos(theta_rad, s_theta, c_theta);
+    SinCos(phi_rad, s_phi, c_phi);
+    float x = r * s_theta * c_phi;
+    float y = r * s_theta * s_phi;
+    float z = r * c_theta;
     vec3[0] = x;
     vec3[1] = y;
     vec3[2] = z;
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 
 namespace RotationMatrix
 {
@@ -33,11 +34,30 @@ namespace RotationMatrix
         ZYX,
     };
 
+    /* How NormalizeRotationMatrix re-orthonormalizes a (drifted) rotation matrix */
+    enum class NORMALIZE_METHOD {
+        QUATERNION = 0,     /* Convert to a quaternion and back */
+        GRAM_SCHMIDT,       /* Keep the direction of the first column */
+        POLAR,              /* The closest rotation in the Frobenius norm (polar decomposition, same as U V^T of SVD). The determinant must be positive */
+    };
+
+    /* sin, cos, asin, acos and atan2 used by the functions which take one rotation
+     * EXACT: libm. FAST: polynomial approximations of FastTrig (several times faster, the angular error is up to about 1e-5 rad)
+     * It is a global setting shared by all threads. It can be changed at any time, but a conversion running in another thread at the time
+     * may use either mode.
+     * The batch functions are not affected: they always use the SIMD kernels, which are accurate and fast */
+    enum class TRIG_MODE {
+        EXACT = 0,
+        FAST,
+    };
+    void SetTrigMode(TRIG_MODE mode);
+    TRIG_MODE GetTrigMode();
+
     /* The following functions return 3x3 rotation matrix */
     Matrix RotateX(float rad);
     Matrix RotateY(float rad);
     Matrix RotateZ(float rad);
-    Matrix NormalizeRotationMatrix(const Matrix mat3_rot);
+    Matrix NormalizeRotationMatrix(const Matrix mat3_rot, NORMALIZE_METHOD method = NORMALIZE_METHOD::QUATERNION);
     Matrix ConvertRotationVector2RotationMatrix(float x_rad, float y_rad, float z_rad);
     Matrix ConvertAxisAngle2RotationMatrix(float x, float y, float z, float rad);
     Matrix ConvertQuaternion2RotationMatrix(float x, float y, float z, float w);
@@ -54,6 +74,54 @@ namespace RotationMatrix
     /* Otehr functions */
     Matrix ConvertXYZ2PolarCoordinate(float x, float y, float z);   /* return 3 x 1 vector */
     Matrix ConvertPolarCoordinate2XYZ(float r, float theta_rad, float phi_rad);  /* return 3 x 1 vector */
+
+    /* Overloads using fixed-size matrix (no heap allocation) */
+    /* The result is written into the last argument if the input is not a matrix */
+    void RotateX(float rad, Mat3& mat3_rot);
+    void RotateY(float rad, Mat3& mat3_rot);
+    void RotateZ(float rad, Mat3& mat3_rot);
+    Mat3 NormalizeRotationMatrix(const Mat3& mat3_rot, NORMALIZE_METHOD method = NORMALIZE_METHOD::QUATERNION);
+    /* SO(3) exp map. Taylor series around 0, so that tiny rotation vectors keep their precision */
+    void ConvertRotationVector2RotationMatrix(float x_rad, float y_rad, float z_rad, Mat3& mat3_rot);
+    void ConvertAxisAngle2RotationMatrix(float x, float y, float z, float rad, Mat3& mat3_rot);
+    void ConvertQuaternion2RotationMatrix(float x, float y, float z, float w, Mat3& mat3_rot);
+    void ConvertEulerMobile2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z, Mat3& mat3_rot);
+    void ConvertEulerFixed2RotationMatrix(RotationMatrix::EULER_ORDER order, float x, float y, float z, Mat3& mat3_rot);
+    /* SO(3) log map. The angle is in [0, pi]. Accurate near 0 (Taylor series) and near pi (the axis from the quaternion) */
+    Vec3 ConvertRotationMatrix2RotationVector(const Mat3& mat3_rot);
+    Vec4 ConvertRotationMatrix2AxisAngle(const Mat3& mat3_rot);
+    Vec4 ConvertRotationMatrix2Quaternion(const Mat3& mat3_rot);
+    Vec3 ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const Mat3& mat3_rot);
+    Vec3 ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const Mat3& mat3_rot);
+    /* Mobile and fixed euler angles in all the orders (indexed by EULER_ORDER) at once. asin / atan2 shared by orders are calculated only once */
+    void DecomposeAllEuler(const Mat3& mat3_rot, Vec3 (&mobile)[6], Vec3 (&fixed)[6]);
+
+    /* Overloads using a view (e.g. the upper-left 3x3 block of a 4x4 matrix), so that the input doesn't need to be copied */
+    Mat3 NormalizeRotationMatrix(const ConstMatrixView& mat3_rot, NORMALIZE_METHOD method = NORMALIZE_METHOD::QUATERNION);
+    Vec3 ConvertRotationMatrix2RotationVector(const ConstMatrixView& mat3_rot);
+    Vec4 ConvertRotationMatrix2AxisAngle(const ConstMatrixView& mat3_rot);
+    Vec4 ConvertRotationMatrix2Quaternion(const ConstMatrixView& mat3_rot);
+    Vec3 ConvertRotationMatrix2EulerMobile(RotationMatrix::EULER_ORDER order, const ConstMatrixView& mat3_rot);
+    Vec3 ConvertRotationMatrix2EulerFixed(RotationMatrix::EULER_ORDER order, const ConstMatrixView& mat3_rot);
+    void DecomposeAllEuler(const ConstMatrixView& mat3_rot, Vec3 (&mobile)[6], Vec3 (&fixed)[6]);
+
+    /* Batch functions for num rotations in structure-of-arrays layout (no heap allocation)
+     * Each component is a separate array of num elements.
+     * 3x3 rotation matrices are stored as 9 planes: element (row, col) of the i-th matrix is mat3_rot[(row * 3 + col) * num + i] */
+    void ConvertRotationVectors2RotationMatrices(const float* x_rad, const float* y_rad, const float* z_rad, int32_t num, float* mat3_rot);
+    void ConvertAxisAngles2RotationMatrices(const float* x, const float* y, const float* z, const float* rad, int32_t num, float* mat3_rot);
+    void ConvertQuaternions2RotationMatrices(const float* x, const float* y, const float* z, const float* w, int32_t num, float* mat3_rot);
+    void ConvertEulerMobiles2RotationMatrices(RotationMatrix::EULER_ORDER order, const float* x, const float* y, const float* z, int32_t num, float* mat3_rot);
+    void ConvertEulerFixeds2RotationMatrices(RotationMatrix::EULER_ORDER order, const float* x, const float* y, const float* z, int32_t num, float* mat3_rot);
+    void ConvertRotationMatrices2RotationVectors(const float* mat3_rot, int32_t num, float* x_rad, float* y_rad, float* z_rad);
+    void ConvertRotationMatrices2AxisAngles(const float* mat3_rot, int32_t num, float* x, float* y, float* z, float* rad);
+    void ConvertRotationMatrices2Quaternions(const float* mat3_rot, int32_t num, float* x, float* y, float* z, float* w);
+    void ConvertRotationMatrices2EulerMobiles(RotationMatrix::EULER_ORDER order, const float* mat3_rot, int32_t num, float* x, float* y, float* z);
+    void ConvertRotationMatrices2EulerFixeds(RotationMatrix::EULER_ORDER order, const float* mat3_rot, int32_t num, float* x, float* y, float* z);
+    /* mobile and fixed have 18 planes each: angle (0 = x, 1 = y, 2 = z) of the i-th rotation in an order is euler[(order * 3 + angle) * num + i] */
+    void DecomposeAllEulers(const float* mat3_rot, int32_t num, float* mobile, float* fixed);
+    /* Re-orthonormalize num matrices in place */
+    void NormalizeRotationMatrices(float* mat3_rot, int32_t num, NORMALIZE_METHOD method = NORMALIZE_METHOD::QUATERNION);
 };
 
 #endif
@@ -0,0 +1,226 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <stdexcept>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "quaternion.h"
+#include "rotation_mean.h"
+
+/*** Macro ***/
+static constexpr int32_t JACOBI_MAX_SWEEP = 32;
+
+/*** Function ***/
+RotationMean::RotationMean()
+{
+    Reset();
+}
+
+void RotationMean::Reset()
+{
+    for (auto& v : m_sum) v = 0.0;
+    m_weight_sum = 0.0;
+    m_count = 0;
+}
+
+/* Add w * q * q^T */
+static void AddQuaternion(double (&sum)[10], double x, double y, double z, double w, double weight)
+{
+    sum[0] += weight * x * x;
+    sum[1] += weight * x * y;
+    sum[2] += weight * x * z;
+    sum[3] += weight * x * w;
+    sum[4] += weight * y * y;
+    sum[5] += weight * y * z;
+    sum[6] += weight * y * w;
+    sum[7] += weight * z * z;
+    sum[8] += weight * z * w;
+    sum[9] += weight * w * w;
+}
+
+/* Add w * q * q^T using q * q^T of the rotation matrix: e.g. 4 * x * x = 1 + r00 - r11 - r22, 4 * x * y = r01 + r10, 4 * x * w = r21 - r12 */
+template<typename MAT3>
+static void AddRotationMatrix(double (&sum)[10], const MAT3& m, double weight)
+{
+    const double k = weight / 4;
+    const double r00 = m(0, 0), r01 = m(0, 1), r02 = m(0, 2);
+    const double r10 = m(1, 0), r11 = m(1, 1), r12 = m(1, 2);
+    const double r20 = m(2, 0), r21 = m(2, 1), r22 = m(2, 2);
+    sum[0] += k * (1 + r00 - r11 - r22);
+    sum[1] += k * (r01 + r10);
+    sum[2] += k * (r02 + r20);
+    sum[3] += k * (r21 - r12);
+    sum[4] += k * (1 - r00 + r11 - r22);
+    sum[5] += k * (r12 + r21);
+    sum[6] += k * (r02 - r20);
+    sum[7] += k * (1 - r00 - r11 + r22);
+    sum[8] += k * (r10 - r01);
+    sum[9] += k * (1 + r00 + r11 + r22);
+}
+
+void RotationMean::Add(const Quaternion& q, float weight)
+{
+    /* Normalize so that each rotation has the same weight regardless of the norm */
+    const double d = static_cast<double>(q.x) * q.x + static_cast<double>(q.y) * q.y + static_cast<double>(q.z) * q.z + static_cast<double>(q.w) * q.w;
+    if (d <= 0.0) throw std::out_of_range("Invalid value");
+    AddQuaternion(m_sum, q.x, q.y, q.z, q.w, weight / d);
+    m_weight_sum += weight;
+    m_count++;
+}
+
+void RotationMean::Add(const Mat3& mat3_rot, float weight)
+{
+    AddRotationMatrix(m_sum, mat3_rot, weight);
+    m_weight_sum += weight;
+    m_count++;
+}
+
+void RotationMean::Add(const ConstMatrixView& mat3_rot, float weight)
+{
+    if (mat3_rot.Rows() != 3 || mat3_rot.Cols() != 3) throw std::out_of_range("Invalid shape");
+    AddRotationMatrix(m_sum, mat3_rot, weight);
+    m_weight_sum += weight;
+    m_count++;
+}
+
+namespace {
+/* Element (row, col) of the i-th matrix in planes. Same as the one for RotationMatrix batch functions */
+class PlaneMat3
+{
+public:
+    PlaneMat3(const float* planes, int32_t num, int32_t index)
+        : m_planes(planes + index), m_num(num)
+    {
+        // do nothing
+    }
+    float operator() (int32_t row, int32_t col) const
+    {
+        return m_planes[static_cast<size_t>(row * 3 + col) * m_num];
+    }
+
+private:
+    const float* m_planes;
+    int32_t m_num;
+};
+}
+
+void RotationMean::AddQuaternions(const float* quat, int32_t num, const float* weight)
+{
+    const float* x = quat;
+    const float* y = quat + static_cast<size_t>(num);
+    const float* z = quat + static_cast<size_t>(num) * 2;
+    const float* w = quat + static_cast<size_t>(num) * 3;
+    for (int32_t i = 0; i < num; i++) {
+        const double d = static_cast<double>(x[i]) * x[i] + static_cast<double>(y[i]) * y[i] + static_cast<double>(z[i]) * z[i] + static_cast<double>(w[i]) * w[i];
+        if (d <= 0.0) throw std::out_of_range("Invalid value");
+        const double k = weight ? weight[i] : 1.0;
+        AddQuaternion(m_sum, x[i], y[i], z[i], w[i], k / d);
+        m_weight_sum += k;
+    }
+    m_count += num;
+}
+
+void RotationMean::AddRotationMatrices(const float* mat3_rot, int32_t num, const float* weight)
+{
+    for (int32_t i = 0; i < num; i++) {
+        const double k = weight ? weight[i] : 1.0;
+        AddRotationMatrix(m_sum, PlaneMat3(mat3_rot, num, i), k);
+        m_weight_sum += k;
+    }
+    m_count += num;
+}
+
+void RotationMean::Merge(const RotationMean& other)
+{
+    for (int32_t i = 0; i < 10; i++) m_sum[i] += other.m_sum[i];
+    m_weight_sum += other.m_weight_sum;
+    m_count += other.m_count;
+}
+
+/* Eigenvector of the largest eigenvalue of a symmetric 4x4 matrix by the cyclic Jacobi method */
+static void GetLargestEigenvector(double (&a)[4][4], double (&vec)[4])
+{
+    double v[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+    for (int32_t sweep = 0; sweep < JACOBI_MAX_SWEEP; sweep++) {
+        double off = 0.0;
+        double diagonal = 0.0;
+        for (int32_t p = 0; p < 4; p++) {
+            diagonal += a[p][p] * a[p][p];
+            for (int32_t q = p + 1; q < 4; q++) off += a[p][q] * a[p][q];
+        }
+        if (off <= 1e-30 * diagonal) break;
+
+        for (int32_t p = 0; p < 3; p++) {
+            for (int32_t q = p + 1; q < 4; q++) {
+                if (a[p][q] == 0.0) continue;
+                /* Rotate rows / cols p and q so that a[p][q] becomes 0 */
+                const double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                const double t = ((theta >= 0) ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const double c = 1 / std::sqrt(t * t + 1);
+                const double s = t * c;
+                for (int32_t k = 0; k < 4; k++) {
+                    const double akp = a[k][p];
+                    const double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int32_t k = 0; k < 4; k++) {
+                    const double apk = a[p][k];
+                    const double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int32_t k = 0; k < 4; k++) {
+                    const double vkp = v[k][p];
+                    const double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    int32_t largest = 0;
+    for (int32_t i = 1; i < 4; i++) {
+        if (a[i][i] > a[largest][largest]) largest = i;
+    }
+    for (int32_t i = 0; i < 4; i++) vec[i] = v[i][largest];
+}
+
+Quaternion RotationMean::GetMean() const
+{
+    if (m_count == 0) return Quaternion::Identity();
+    double a[4][4] = {
+        { m_sum[0], m_sum[1], m_sum[2], m_sum[3] },
+        { m_sum[1], m_sum[4], m_sum[5], m_sum[6] },
+        { m_sum[2], m_sum[5], m_sum[7], m_sum[8] },
+        { m_sum[3], m_sum[6], m_sum[8], m_sum[9] },
+    };
+    double vec[4];
+    GetLargestEigenvector(a, vec);
+    const double sign = (vec[3] < 0) ? -1.0 : 1.0;
+    const double norm = std::sqrt(vec[0] * vec[0] + vec[1] * vec[1] + vec[2] * vec[2] + vec[3] * vec[3]);
+    const double k = sign / norm;
+    return Quaternion(static_cast<float>(vec[0] * k), static_cast<float>(vec[1] * k), static_cast<float>(vec[2] * k), static_cast<float>(vec[3] * k));
+}
+
+void RotationMean::GetMean(Mat3& mat3_rot) const
+{
+    GetMean().ToRotationMatrix(mat3_rot);
+}
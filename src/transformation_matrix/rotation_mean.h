@@ -0,0 +1,63 @@
+/* Copyright 2022 iwatake2222
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ROTATION_MEAN_H
+#define ROTATION_MEAN_H
+
+/*** Include ***/
+#include <cstdint>
+#include <cstdio>
+
+#include "matrix.h"
+#include "matrix_fixed.h"
+#include "quaternion.h"
+
+/*
+ * Streaming weighted mean of rotations (Markley et al., "Averaging Quaternions", 2007).
+ * The mean is the eigenvector of the largest eigenvalue of M = sum(w * q * q^T), which doesn't depend on the sign of each q.
+ * It is also the chordal L2 mean of rotation matrices (the rotation closest to sum(w * R) in Frobenius norm),
+ * because 4 * q * q^T is a linear function of R. So a rotation matrix is accumulated without converting it to a quaternion.
+ * Only M (10 values in double) is kept, so any number of rotations can be added, and accumulators from threads can be merged.
+ */
+class RotationMean
+{
+public:
+    RotationMean();
+    void Reset();
+
+    void Add(const Quaternion& q, float weight = 1.0f);
+    void Add(const Mat3& mat3_rot, float weight = 1.0f);
+    void Add(const ConstMatrixView& mat3_rot, float weight = 1.0f);
+
+    /* Batch functions in the same layout as RotationMatrix / RotationInterpolation batch functions. weight can be nullptr (all 1) */
+    void AddQuaternions(const float* quat, int32_t num, const float* weight = nullptr);
+    void AddRotationMatrices(const float* mat3_rot, int32_t num, const float* weight = nullptr);
+
+    void Merge(const RotationMean& other);
+
+    int64_t GetCount() const { return m_count; }
+    double GetWeightSum() const { return m_weight_sum; }
+
+    /* The mean with w >= 0. Identity if nothing is added */
+    Quaternion GetMean() const;
+    void GetMean(Mat3& mat3_rot) const;
+
+private:
+    /* Upper triangle of M: xx, xy, xz, xw, yy, yz, yw, zz, zw, ww */
+    double m_sum[10];
+    double m_weight_sum;
+    int64_t m_count;
+};
+
+#endif
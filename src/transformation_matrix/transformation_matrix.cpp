@@ -19,8 +19,10 @@ limitations under the License.
 #include <cmath>
 #include <array>
 #include <vector>
+#include <stdexcept>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 #include "rotation_matrix.h"
 #include "transformation_matrix.h"
 
@@ -29,76 +31,70 @@ limitations under the License.
 /*** Global variable ***/
 
 /*** Function ***/
-Matrix TransformationMatrix::Expand3to4(const Matrix& mat3)
+Mat4 TransformationMatrix::Expand3to4(const Mat3& mat3)
 {
-    Matrix mat4 = Matrix::Identity(4);
-    for (int32_t row = 0; row < 3; row++) {
-        for (int32_t col = 0; col < 3; col++) {
-            mat4(row, col) = mat3(row, col);
-        }
-    }
+    Mat4 mat4 = Mat4::Identity();
+    mat4.Block(0, 0, 3, 3) = mat3;
     return mat4;
 }
 
-Matrix TransformationMatrix::Shrink4to3(const Matrix& mat4)
+Mat3 TransformationMatrix::Shrink4to3(const Mat4& mat4)
 {
-    Matrix mat3 = Matrix::Identity(3);
-    for (int32_t row = 0; row < 3; row++) {
-        for (int32_t col = 0; col < 3; col++) {
-            mat3(row, col) = mat4(row, col);
-        }
-    }
-    return mat3;
+    return Mat3(mat4.Block(0, 0, 3, 3));
 }
 
-Matrix TransformationMatrix::Translate(float x, float y, float z)
+void TransformationMatrix::Translate(float x, float y, float z, Mat4& mat4)
 {
-    Matrix mat = Matrix::Identity(4);
-    mat[3] = x;
-    mat[7] = y;
-    mat[11] = z;
-    return mat;
+    mat4 = Mat4::Identity();
+    mat4[3] = x;
+    mat4[7] = y;
+    mat4[11] = z;
 }
 
-Matrix TransformationMatrix::Scale(float x, float y, float z)
+void TransformationMatrix::Scale(float x, float y, float z, Mat4& mat4)
 {
-    Matrix mat = Matrix::Identity(4);
-    mat[0] = x;
-    mat[5] = y;
-    mat[10] = z;
-    return mat;
+    mat4 = Mat4::Identity();
+    mat4[0] = x;
+    mat4[5] = y;
+    mat4[10] = z;
 }
 
-Matrix TransformationMatrix::RotateX(float rad)
+void TransformationMatrix::RotateX(float rad, Mat4& mat4)
 {
-    Matrix mat = RotationMatrix::RotateX(rad);
-    return Expand3to4(mat);
+    Mat3 mat3;
+    RotationMatrix::RotateX(rad, mat3);
+    mat4 = Expand3to4(mat3);
 }
 
-Matrix TransformationMatrix::RotateY(float rad)
+void TransformationMatrix::RotateY(float rad, Mat4& mat4)
 {
-    Matrix mat = RotationMatrix::RotateY(rad);
-    return Expand3to4(mat);
+    Mat3 mat3;
+    RotationMatrix::RotateY(rad, mat3);
+    mat4 = Expand3to4(mat3);
 }
 
-Matrix TransformationMatrix::RotateZ(float rad)
+void TransformationMatrix::RotateZ(float rad, Mat4& mat4)
 {
-    Matrix mat = RotationMatrix::RotateZ(rad);
-    return Expand3to4(mat);
+    Mat3 mat3;
+    RotationMatrix::RotateZ(rad, mat3);
+    mat4 = Expand3to4(mat3);
 }
 
-Matrix TransformationMatrix::RotateAxisAngle(float x, float y, float z, float rad)
+void TransformationMatrix::RotateAxisAngle(float x, float y, float z, float rad, Mat4& mat4)
 {
-    Matrix mat = RotationMatrix::ConvertAxisAngle2RotationMatrix(x, y, z, rad);
-    return Expand3to4(mat);
+    Mat3 mat3;
+    RotationMatrix::ConvertAxisAngle2RotationMatrix(x, y, z, rad, mat3);
+    mat4 = Expand3to4(mat3);
 }
 
-Matrix TransformationMatrix::LookAt(
+void TransformationMatrix::LookAt(
     float eye_x, float eye_y, float eye_z,
     float gaze_x, float gaze_y, float gaze_z,
-    float up_x, float up_y, float up_z)
+    float up_x, float up_y, float up_z,
+    Mat4& mat4)
 {
-    const Matrix tv(Translate(-eye_x, -eye_y, -eye_z));
+    Mat4 tv;
+    Translate(-eye_x, -eye_y, -eye_z, tv);
 
     const float tx = eye_x - gaze_x;
     const float ty = eye_y - gaze_y;
@@ -111,8 +107,11 @@ Matrix TransformationMatrix::LookAt(
     const float sz = tx * ry - ty * rx;
 
     const float s = std::sqrt(sx * sx + sy * sy + sz * sz);
-    if (s == 0.0f) return tv;
-    Matrix rv = Matrix::Identity(4);
+    if (s == 0.0f) {
+        mat4 = tv;
+        return;
+    }
+    Mat4 rv = Mat4::Identity();
     const float r = std::sqrt(rx * rx + ry * ry + rz * rz);
     const float t = std::sqrt(tx * tx + ty * ty + tz * tz);
     rv[0] = rx / r;
@@ -125,7 +124,79 @@ Matrix TransformationMatrix::LookAt(
     rv[9] = ty / t;
     rv[10] = tz / t;
 
-    return rv * tv;
+    mat4 = rv * tv;
+}
+
+void TransformationMatrix::LookAt(const std::array<float, 3>& eye, const std::array<float, 3>& gaze, const std::array<float, 3>& up, Mat4& mat4)
+{
+    TransformationMatrix::LookAt(eye[0], eye[1], eye[2], gaze[0], gaze[1], gaze[2], up[0], up[1], up[2], mat4);
+}
+
+/* Functions for dynamic-size Matrix. These are just wrappers of the fixed-size version */
+Matrix TransformationMatrix::Expand3to4(const Matrix& mat3)
+{
+    if (mat3.Rows() != 3 || mat3.Cols() != 3) throw std::out_of_range("Invalid shape");
+    Matrix mat4 = Matrix::Identity(4);
+    mat4.Block(0, 0, 3, 3) = mat3;
+    return mat4;
+}
+
+Matrix TransformationMatrix::Shrink4to3(const Matrix& mat4)
+{
+    if (mat4.Rows() != 4 || mat4.Cols() != 4) throw std::out_of_range("Invalid shape");
+    return Matrix(mat4.Block(0, 0, 3, 3));
+}
+
+Matrix TransformationMatrix::Translate(float x, float y, float z)
+{
+    Mat4 mat4;
+    Translate(x, y, z, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::Scale(float x, float y, float z)
+{
+    Mat4 mat4;
+    Scale(x, y, z, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::RotateX(float rad)
+{
+    Mat4 mat4;
+    RotateX(rad, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::RotateY(float rad)
+{
+    Mat4 mat4;
+    RotateY(rad, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::RotateZ(float rad)
+{
+    Mat4 mat4;
+    RotateZ(rad, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::RotateAxisAngle(float x, float y, float z, float rad)
+{
+    Mat4 mat4;
+    RotateAxisAngle(x, y, z, rad, mat4);
+    return static_cast<Matrix>(mat4);
+}
+
+Matrix TransformationMatrix::LookAt(
+    float eye_x, float eye_y, float eye_z,
+    float gaze_x, float gaze_y, float gaze_z,
+    float up_x, float up_y, float up_z)
+{
+    Mat4 mat4;
+    LookAt(eye_x, eye_y, eye_z, gaze_x, gaze_y, gaze_z, up_x, up_y, up_z, mat4);
+    return static_cast<Matrix>(mat4);
 }
 
 Matrix TransformationMatrix::LookAt(const std::array<float, 3>& eye, const std::array<float, 3>& gaze, const std::array<float, 3>& up)
@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 
 #include "matrix.h"
+#include "matrix_fixed.h"
 
 namespace TransformationMatrix
 {
@@ -40,6 +41,23 @@ namespace TransformationMatrix
         float gaze_x, float gaze_y, float gaze_z,
         float up_x, float up_y, float up_z);
     Matrix LookAt(const std::array<float, 3>& eye, const std::array<float, 3>& gaze, const std::array<float, 3>& up);
+
+    /* Overloads using fixed-size matrix (no heap allocation) */
+    /* The result is written into the last argument if the input is not a matrix */
+    Mat3 Shrink4to3(const Mat4& mat4);
+    Mat4 Expand3to4(const Mat3& mat3);
+    void Translate(float x, float y, float z, Mat4& mat4);
+    void Scale(float x, float y, float z, Mat4& mat4);
+    void RotateX(float rad, Mat4& mat4);
+    void RotateY(float rad, Mat4& mat4);
+    void RotateZ(float rad, Mat4& mat4);
+    void RotateAxisAngle(float x, float y, float z, float rad, Mat4& mat4);
+    void LookAt(
+        float eye_x, float eye_y, float eye_z,
+        float gaze_x, float gaze_y, float gaze_z,
+        float up_x, float up_y, float up_z,
+        Mat4& mat4);
+    void LookAt(const std::array<float, 3>& eye, const std::array<float, 3>& gaze, const std::array<float, 3>& up, Mat4& mat4);
 }
 
 
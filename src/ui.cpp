@@ -102,7 +102,10 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
                 }
             }
             ImGui::EndTable();
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::ROTATION_MATRIX);
+            if (is_value_changed) {
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::ROTATION_MATRIX);
+                input_container.MarkChanged(REPRESENTATION_TYPE::ROTATION_MATRIX);
+            }
         }
         ImGui::Separator();
 
@@ -115,10 +118,14 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             ImGui::TableSetColumnIndex(1); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##y", &val[1], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("y: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::TableSetColumnIndex(2); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##z", &val[2], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("z: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::EndTable();
-            for (int32_t i = 0; i < 3; i++) {
-                input_container.rotation_vector[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+            if (is_value_changed) {
+                /* Store only when changed, so that the round trip of the unit doesn't change the value */
+                for (int32_t i = 0; i < 3; i++) {
+                    input_container.rotation_vector[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+                }
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::ROTATION_VECTOR);
+                input_container.MarkChanged(REPRESENTATION_TYPE::ROTATION_VECTOR);
             }
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::ROTATION_VECTOR);
 
         }
         ImGui::Separator();
@@ -132,9 +139,13 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             ImGui::TableSetColumnIndex(2); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##z", &input_container.axis_angle[2], 0.005f, -1.0, 1.0f, "z: %.3f");
             float val = angle_unit.Display(input_container.axis_angle[3]);
             ImGui::TableSetColumnIndex(3); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##angle", &val, angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("angle: ") + angle_unit.GetAngleFormat()).c_str());
-            input_container.axis_angle[3] = angle_unit.StoreAngle(val);  /* (rad or deg) to rad */
             ImGui::EndTable();
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::AXIS_ANGLE);
+            if (is_value_changed) {
+                /* Store only when changed, so that the round trip of the unit doesn't change the value */
+                input_container.axis_angle[3] = angle_unit.StoreAngle(val);  /* (rad or deg) to rad */
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::AXIS_ANGLE);
+                input_container.MarkChanged(REPRESENTATION_TYPE::AXIS_ANGLE);
+            }
         }
         ImGui::Separator();
 
@@ -147,7 +158,10 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             ImGui::TableSetColumnIndex(2); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##z", &input_container.quaternion[2], 0.005f, -1.0, 1.0f, "z: %.3f");
             ImGui::TableSetColumnIndex(3); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##w", &input_container.quaternion[3], 0.005f, -1.0, 1.0f, "w: %.3f");
             ImGui::EndTable();
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::QUATERNION);
+            if (is_value_changed) {
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::QUATERNION);
+                input_container.MarkChanged(REPRESENTATION_TYPE::QUATERNION);
+            }
         }
         ImGui::Separator();
 
@@ -161,10 +175,14 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             ImGui::TableSetColumnIndex(2); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##y", &val[1], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("y: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::TableSetColumnIndex(3); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##z", &val[2], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("z: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::EndTable();
-            for (int32_t i = 0; i < 3; i++) {
-                input_container.mobile_euler_angle[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+            if (is_value_changed) {
+                /* Store only when changed, so that the round trip of the unit doesn't change the value */
+                for (int32_t i = 0; i < 3; i++) {
+                    input_container.mobile_euler_angle[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+                }
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::EULER_MOBILE);
+                input_container.MarkChanged(REPRESENTATION_TYPE::EULER_MOBILE);
             }
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::EULER_MOBILE);
         }
         ImGui::Separator();
 
@@ -178,10 +196,14 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             ImGui::TableSetColumnIndex(2); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##y", &val[1], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("y: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::TableSetColumnIndex(3); ImGui::PushItemWidth(-FLT_MIN); is_value_changed |= ImGui::DragFloat("##z", &val[2], angle_unit.GetAngleDragSpeed(), -angle_unit.GetAngleRange(), angle_unit.GetAngleRange(), (std::string("z: ") + angle_unit.GetAngleFormat()).c_str());
             ImGui::EndTable();
-            for (int32_t i = 0; i < 3; i++) {
-                input_container.fixed_euler_angle[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+            if (is_value_changed) {
+                /* Store only when changed, so that the round trip of the unit doesn't change the value */
+                for (int32_t i = 0; i < 3; i++) {
+                    input_container.fixed_euler_angle[i] = angle_unit.StoreAngle(val[i]);  /* (rad or deg) to rad */
+                }
+                input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::EULER_FIXED);
+                input_container.MarkChanged(REPRESENTATION_TYPE::EULER_FIXED);
             }
-            if (is_value_changed) input_container.selected_representation_type = static_cast<int32_t>(REPRESENTATION_TYPE::EULER_FIXED);
         }
 
         /*** Converted angles ***/
@@ -195,7 +217,7 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
                 for (int32_t col = 0; col < 3; col++) {
                     ImGui::TableSetColumnIndex(col);
                     std::string label = std::string("R") + std::to_string(row) + std::to_string(col);
-                    ImGui::Text((label + ": %.3f").c_str(), output_container.rotation_matrix(row, col));
+                    ImGui::Text((label + ": %.3f").c_str(), output_container.GetRotationMatrix()(row, col));
                 }
             }
             ImGui::EndTable();
@@ -205,9 +227,9 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
         ImGui::Text("Rotation Vector");
         if (ImGui::BeginTable("Rotation Vector", 3)) {
             ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0); ImGui::Text((std::string("  x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.rotation_vector[0]));
-            ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.rotation_vector[1]));
-            ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.rotation_vector[2]));
+            ImGui::TableSetColumnIndex(0); ImGui::Text((std::string("  x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetRotationVector()[0]));
+            ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetRotationVector()[1]));
+            ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetRotationVector()[2]));
             ImGui::EndTable();
         }
         ImGui::Separator();
@@ -215,10 +237,10 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
         ImGui::Text("Axis-angle");
         if (ImGui::BeginTable("Axis-angle", 4)) {
             ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0); ImGui::Text("  x: %.3f", output_container.axis_angle[0]);
-            ImGui::TableSetColumnIndex(1); ImGui::Text("y: %.3f", output_container.axis_angle[1]);
-            ImGui::TableSetColumnIndex(2); ImGui::Text("z: %.3f", output_container.axis_angle[2]);
-            ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("angle: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.axis_angle[3]));
+            ImGui::TableSetColumnIndex(0); ImGui::Text("  x: %.3f", output_container.GetAxisAngle()[0]);
+            ImGui::TableSetColumnIndex(1); ImGui::Text("y: %.3f", output_container.GetAxisAngle()[1]);
+            ImGui::TableSetColumnIndex(2); ImGui::Text("z: %.3f", output_container.GetAxisAngle()[2]);
+            ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("angle: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetAxisAngle()[3]));
             ImGui::EndTable();
         }
         ImGui::Separator();
@@ -226,10 +248,10 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
         ImGui::Text("Quaternion");
         if (ImGui::BeginTable("Quaternion", 4)) {
             ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0); ImGui::Text("  x: %.3f", output_container.quaternion[0]);
-            ImGui::TableSetColumnIndex(1); ImGui::Text("y: %.3f", output_container.quaternion[1]);
-            ImGui::TableSetColumnIndex(2); ImGui::Text("z: %.3f", output_container.quaternion[2]);
-            ImGui::TableSetColumnIndex(3); ImGui::Text("w: %.3f", output_container.quaternion[3]);
+            ImGui::TableSetColumnIndex(0); ImGui::Text("  x: %.3f", output_container.GetQuaternion()[0]);
+            ImGui::TableSetColumnIndex(1); ImGui::Text("y: %.3f", output_container.GetQuaternion()[1]);
+            ImGui::TableSetColumnIndex(2); ImGui::Text("z: %.3f", output_container.GetQuaternion()[2]);
+            ImGui::TableSetColumnIndex(3); ImGui::Text("w: %.3f", output_container.GetQuaternion()[3]);
             ImGui::EndTable();
         }
         ImGui::Separator();
@@ -239,9 +261,9 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             for (int32_t i = 0; i < static_cast<int32_t>(sizeof(EULER_ORDER_STR) / sizeof(char*)); i++) {
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0); ImGui::Text("%s", EULER_ORDER_STR[i]);
-                ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.mobile_euler_angle[i][0]));
-                ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.mobile_euler_angle[i][1]));
-                ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.mobile_euler_angle[i][2]));
+                ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetMobileEulerAngle(i)[0]));
+                ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetMobileEulerAngle(i)[1]));
+                ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetMobileEulerAngle(i)[2]));
 
             }
             ImGui::EndTable();
@@ -253,9 +275,9 @@ void Ui::Update(Window& window, AngleUnit& angle_unit, InputContainer& input_con
             for (int32_t i = 0; i < static_cast<int32_t>(sizeof(EULER_ORDER_STR) / sizeof(char*)); i++) {
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0); ImGui::Text("%s", EULER_ORDER_STR[i]);
-                ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.fixed_euler_angle[i][0]));
-                ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.fixed_euler_angle[i][1]));
-                ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.fixed_euler_angle[i][2]));
+                ImGui::TableSetColumnIndex(1); ImGui::Text((std::string("x: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetFixedEulerAngle(i)[0]));
+                ImGui::TableSetColumnIndex(2); ImGui::Text((std::string("y: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetFixedEulerAngle(i)[1]));
+                ImGui::TableSetColumnIndex(3); ImGui::Text((std::string("z: ") + angle_unit.GetAngleFormat()).c_str(), angle_unit.Display(output_container.GetFixedEulerAngle(i)[2]));
 
             }
             ImGui::EndTable();